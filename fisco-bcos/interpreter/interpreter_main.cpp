@@ -0,0 +1,368 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: benchmark of the interpreter calling an ERC20-like contract
+ *
+ * @file: interpreter_main.cpp
+ * @date 2019-03-27
+ */
+#include <libdevcore/Common.h>
+#include <libdevcore/CommonData.h>
+#include <libdevcrypto/Hash.h>
+#include <libethcore/Instruction.h>
+#include <libinterpreter/CodeCache.h>
+#include <libinterpreter/VM.h>
+#include <libinterpreter/interpreter.h>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace po = boost::program_options;
+
+namespace
+{
+/// assembles code with named JUMPDEST labels, which are pushed as PUSH2
+class Assembler
+{
+public:
+    Assembler& op(Instruction _op)
+    {
+        m_code.push_back((byte)_op);
+        return *this;
+    }
+
+    Assembler& push(u256 const& _value, unsigned _size)
+    {
+        m_code.push_back((byte)Instruction::PUSH1 + _size - 1);
+        bytes value = toBigEndian(_value);
+        m_code.insert(m_code.end(), value.end() - _size, value.end());
+        return *this;
+    }
+
+    Assembler& pushLabel(string const& _label)
+    {
+        m_code.push_back((byte)Instruction::PUSH2);
+        m_labelRefs.push_back(make_pair(m_code.size(), _label));
+        m_code.resize(m_code.size() + 2);
+        return *this;
+    }
+
+    Assembler& label(string const& _label)
+    {
+        m_labels[_label] = m_code.size();
+        return op(Instruction::JUMPDEST);
+    }
+
+    size_t size() const { return m_code.size(); }
+
+    bytes assemble()
+    {
+        for (auto& ref : m_labelRefs)
+        {
+            size_t pos = m_labels.at(ref.second);
+            m_code[ref.first] = pos >> 8;
+            m_code[ref.first + 1] = pos & 0xff;
+        }
+        return m_code;
+    }
+
+private:
+    bytes m_code;
+    map<string, size_t> m_labels;
+    vector<pair<size_t, string>> m_labelRefs;
+};
+
+/// runtime code of a token with balanceOf(address) and transfer(address,uint256), laid out the
+/// way solidity does, padded by unreachable blocks up to the size of a usual ERC20 contract
+bytes erc20Code(size_t _size)
+{
+    u256 addressMask = (u256(1) << 160) - 1;
+    u256 transferTopic = u256(sha3(string("Transfer(address,address,uint256)")));
+
+    Assembler a;
+    a.push(0x80, 1).push(0x40, 1).op(Instruction::MSTORE);
+    a.push(4, 1).op(Instruction::CALLDATASIZE).op(Instruction::LT).pushLabel("fail").op(
+        Instruction::JUMPI);
+    a.push(u256(1) << 224, 29).push(0, 1).op(Instruction::CALLDATALOAD).op(Instruction::DIV);
+    a.push(0xffffffff, 4).op(Instruction::AND);
+    a.op(Instruction::DUP1).push(0x70a08231, 4).op(Instruction::EQ).pushLabel("balanceOf").op(
+        Instruction::JUMPI);
+    a.op(Instruction::DUP1).push(0xa9059cbb, 4).op(Instruction::EQ).pushLabel("transfer").op(
+        Instruction::JUMPI);
+    a.label("fail").push(0, 1).op(Instruction::DUP1).op(Instruction::REVERT);
+
+    /// balanceOf(address)
+    a.label("balanceOf").pushLabel("balanceOfSlot");
+    a.push(4, 1).op(Instruction::CALLDATALOAD).push(addressMask, 20).op(Instruction::AND);
+    a.pushLabel("slotOf").op(Instruction::JUMP);
+    a.label("balanceOfSlot").op(Instruction::SLOAD).push(0, 1).op(Instruction::MSTORE);
+    a.push(0x20, 1).push(0, 1).op(Instruction::RETURN);
+
+    /// transfer(address,uint256)
+    a.label("transfer").pushLabel("fromSlot").op(Instruction::CALLER);
+    a.pushLabel("slotOf").op(Instruction::JUMP);
+    a.label("fromSlot").op(Instruction::DUP1).op(Instruction::SLOAD);
+    a.push(0x24, 1).op(Instruction::CALLDATALOAD);
+    a.op(Instruction::DUP1).op(Instruction::DUP3).op(Instruction::LT).pushLabel("fail").op(
+        Instruction::JUMPI);
+    a.op(Instruction::DUP1).op(Instruction::SWAP2).op(Instruction::SUB);
+    a.op(Instruction::DUP3).op(Instruction::SSTORE);
+    a.pushLabel("toSlot").push(4, 1).op(Instruction::CALLDATALOAD);
+    a.push(addressMask, 20).op(Instruction::AND).pushLabel("slotOf").op(Instruction::JUMP);
+    a.label("toSlot").op(Instruction::DUP1).op(Instruction::SLOAD).op(Instruction::DUP3).op(
+        Instruction::ADD);
+    a.op(Instruction::SWAP1).op(Instruction::SSTORE);
+    a.push(0, 1).op(Instruction::MSTORE);
+    a.push(4, 1).op(Instruction::CALLDATALOAD).push(addressMask, 20).op(Instruction::AND);
+    a.op(Instruction::CALLER).push(transferTopic, 32).push(0x20, 1).push(0, 1).op(
+        Instruction::LOG3);
+    a.op(Instruction::POP).push(1, 1).push(0, 1).op(Instruction::MSTORE);
+    a.push(0x20, 1).push(0, 1).op(Instruction::RETURN);
+
+    /// slot of the balance of an address in mapping 0, returns to the address under it
+    a.label("slotOf").push(0, 1).op(Instruction::MSTORE).push(0, 1).push(0x20, 1).op(
+        Instruction::MSTORE);
+    a.push(0x40, 1).push(0, 1).op(Instruction::SHA3).op(Instruction::SWAP1).op(
+        Instruction::JUMP);
+
+    for (unsigned i = 0; a.size() < _size; ++i)
+    {
+        a.label("dead" + to_string(i)).push(0x20, 1).push(i, 2).op(Instruction::CALLDATALOAD);
+        a.push(addressMask, 20).op(Instruction::AND).op(Instruction::DUP1).op(Instruction::SLOAD);
+        a.push(transferTopic, 32).op(Instruction::ADD).op(Instruction::SWAP1).op(
+            Instruction::SSTORE);
+        a.pushLabel("fail").op(Instruction::JUMPI);
+    }
+    return a.assemble();
+}
+
+/// host of a single contract
+struct Host : evmc_context
+{
+    map<h256, h256> storage;
+    size_t logs = 0;
+    evmc_address caller;
+};
+
+int accountExists(evmc_context*, evmc_address const*) noexcept
+{
+    return 1;
+}
+
+void getStorage(evmc_uint256be* o_result, evmc_context* _context, evmc_address const*,
+    evmc_uint256be const* _key) noexcept
+{
+    auto& storage = static_cast<Host*>(_context)->storage;
+    auto it = storage.find(h256(_key->bytes, h256::ConstructFromPointer));
+    *o_result = toEvmC(it == storage.end() ? h256() : it->second);
+}
+
+evmc_storage_status setStorage(evmc_context* _context, evmc_address const*,
+    evmc_uint256be const* _key, evmc_uint256be const* _value) noexcept
+{
+    auto& storage = static_cast<Host*>(_context)->storage;
+    storage[h256(_key->bytes, h256::ConstructFromPointer)] =
+        h256(_value->bytes, h256::ConstructFromPointer);
+    return EVMC_STORAGE_MODIFIED;
+}
+
+void getBalance(evmc_uint256be* o_result, evmc_context*, evmc_address const*) noexcept
+{
+    *o_result = toEvmC(h256());
+}
+
+size_t getCodeSize(evmc_context*, evmc_address const*) noexcept
+{
+    return 0;
+}
+
+void getCodeHash(evmc_uint256be* o_result, evmc_context*, evmc_address const*) noexcept
+{
+    *o_result = toEvmC(h256());
+}
+
+size_t copyCode(evmc_context*, evmc_address const*, size_t, byte*, size_t) noexcept
+{
+    return 0;
+}
+
+void selfdestruct(evmc_context*, evmc_address const*, evmc_address const*) noexcept {}
+
+void call(evmc_result* o_result, evmc_context*, evmc_message const*) noexcept
+{
+    *o_result = evmc_result();
+    o_result->status_code = EVMC_REJECTED;
+}
+
+void getTxContext(evmc_tx_context* o_result, evmc_context*) noexcept
+{
+    *o_result = evmc_tx_context();
+    o_result->block_number = 1;
+    o_result->block_gas_limit = 300000000;
+}
+
+void getBlockHash(evmc_uint256be* o_result, evmc_context*, int64_t) noexcept
+{
+    *o_result = toEvmC(h256());
+}
+
+void log(evmc_context* _context, evmc_address const*, uint8_t const*, size_t,
+    evmc_uint256be const[], size_t) noexcept
+{
+    static_cast<Host*>(_context)->logs++;
+}
+
+evmc_context_fn_table const hostFnTable = {
+    accountExists,
+    getStorage,
+    setStorage,
+    getBalance,
+    getCodeSize,
+    getCodeHash,
+    copyCode,
+    selfdestruct,
+    call,
+    getTxContext,
+    getBlockHash,
+    log,
+};
+
+struct Result
+{
+    double seconds = 0;
+    /// gas used and the hash of the outputs of all the calls, which must not depend on the mode
+    int64_t gasUsed = 0;
+    h256 outputHash;
+};
+
+Result run(bytes const& _code, h256 const& _codeHash, size_t _calls)
+{
+    Host host;
+    host.fn_table = &hostFnTable;
+    Address sender(0x1000);
+    evmc_instance* instance = evmc_create_interpreter();
+
+    auto callToken = [&](bytes const& _data, Result& _result) {
+        evmc_message msg = {toEvmC(Address(0x2000)), toEvmC(sender), toEvmC(h256()),
+            _data.data(), _data.size(), toEvmC(_codeHash), toEvmC(h256()), 100000, 0, EVMC_CALL,
+            0};
+        evmc_result result = instance->execute(
+            instance, &host, EVMC_CONSTANTINOPLE, &msg, _code.data(), _code.size());
+        _result.gasUsed += msg.gas - result.gas_left;
+        _result.outputHash = sha3(_result.outputHash.asBytes() +
+                                  bytes(result.output_data, result.output_data + result.output_size) +
+                                  toBigEndian(u256(result.status_code)));
+        if (result.release)
+        {
+            result.release(&result);
+        }
+    };
+
+    /// the sender holds all the tokens
+    bytes slotData = bytes(12, 0) + sender.asBytes() + bytes(32, 0);
+    host.storage[sha3(slotData)] = h256(u256(1) << 128);
+
+    bytes transferData = fromHex("a9059cbb") + bytes(32, 0) + toBigEndian(u256(1));
+    bytes balanceOfData = fromHex("70a08231") + bytes(32, 0);
+
+    Result result;
+    Timer timer;
+    for (size_t i = 0; i < _calls; ++i)
+    {
+        Address to(0x3000 + i % 100);
+        if (i % 2 == 0)
+        {
+            std::copy(to.begin(), to.end(), transferData.begin() + 4 + 12);
+            callToken(transferData, result);
+        }
+        else
+        {
+            std::copy(to.begin(), to.end(), balanceOfData.begin() + 4 + 12);
+            callToken(balanceOfData, result);
+        }
+    }
+    result.seconds = timer.elapsed();
+    if (host.logs != (_calls + 1) / 2)
+    {
+        cerr << "unexpected logs: " << host.logs << endl;
+        exit(1);
+    }
+    return result;
+}
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    po::options_description main_options("Main for mini-interpreter");
+    main_options.add_options()("help,h", "help of mini-interpreter")("calls,c",
+        po::value<size_t>()->default_value(100000), "calls of each mode")(
+        "size,s", po::value<size_t>()->default_value(4096), "bytes of the contract code");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        cout << "invalid input" << endl;
+        return 1;
+    }
+    if (vm.count("help"))
+    {
+        cout << main_options << endl;
+        return 0;
+    }
+
+    size_t calls = vm["calls"].as<size_t>();
+    bytes code = erc20Code(vm["size"].as<size_t>());
+    h256 codeHash = sha3(code);
+    cout << "code size: " << code.size() << ", calls of each mode: " << calls << endl;
+
+    auto& cache = CodeCache::instance();
+    Result expected;
+    for (bool cached : {false, true})
+    {
+        for (bool optimize : {false, true})
+        {
+            cache.clear();
+            cache.setOptimize(optimize);
+            auto before = cache.metrics();
+            /// the interpreter bypasses the cache for code without hash
+            Result result = run(code, cached ? codeHash : h256(), calls);
+            auto after = cache.metrics();
+
+            cout << "cached: " << cached << ", optimize: " << optimize
+                 << ", calls/s: " << (uint64_t)(calls / result.seconds)
+                 << ", us/call: " << result.seconds * 1000000 / calls
+                 << ", hits: " << after.hits - before.hits
+                 << ", misses: " << after.misses - before.misses << endl;
+            if (!cached && !optimize)
+            {
+                expected = result;
+            }
+            else if (result.gasUsed != expected.gasUsed || result.outputHash != expected.outputHash)
+            {
+                cerr << "results differ from the uncached unoptimized run" << endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -49,7 +49,8 @@ po::variables_map initCommandLine(int argc, const char* argv[])
         po::value<vector<string>>()->multitoken(), "[TableName] [priKey] [Key] [NewValue]")(
         "insert,i", po::value<vector<string>>()->multitoken(),
         "[TableName] [priKey] [Key]:[Value],...,[Key]:[Value]")(
-        "remove,r", po::value<vector<string>>()->multitoken(), "[TableName] [priKey]");
+        "remove,r", po::value<vector<string>>()->multitoken(), "[TableName] [priKey]")(
+        "migrate,m", "rewrite legacy json rows under [LevelDB path] in binary format");
     po::variables_map vm;
     try
     {
@@ -127,7 +128,14 @@ int main(int argc, const char* argv[])
     memoryTableFactory->setBlockHash(h256(0));
     memoryTableFactory->setBlockNum(0);
 
-    if (params.count("createTable") || params.count("c"))
+    if (params.count("migrate") || params.count("m"))
+    {
+        cout << "migrate " << storagePath << endl;
+        auto total = storage->migrate();
+        cout << "migrate [" << total << "] rows success!" << endl;
+        return 0;
+    }
+    else if (params.count("createTable") || params.count("c"))
     {
         auto& p = params["createTable"].as<vector<string>>();
         cout << "createTable " << p << " || params num : " << p.size() << endl;
@@ -0,0 +1,200 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: multi-thread benchmark of submit/topTransactions/dropBlockTrans of the txpool
+ *
+ * @file: txpool_main.cpp
+ * @date 2019-03-20
+ */
+#include <fisco-bcos/Fake.h>
+#include <libdevcore/CommonData.h>
+#include <libdevcore/easylog.h>
+#include <libdevcrypto/Common.h>
+#include <libethcore/Protocol.h>
+#include <libp2p/Service.h>
+#include <libtxpool/TxPool.h>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+INITIALIZE_EASYLOGGINGPP
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::txpool;
+using namespace dev::blockchain;
+namespace po = boost::program_options;
+
+po::options_description main_options("Main for mini-txpool");
+
+po::variables_map initCommandLine(int argc, const char* argv[])
+{
+    main_options.add_options()("help,h", "help of mini-txpool")(
+        "txs,t", po::value<size_t>()->default_value(100000), "[total transactions]")(
+        "threads,n", po::value<size_t>()->default_value(8), "[submit threads]")(
+        "sealers,s", po::value<size_t>()->default_value(1), "[topTransactions threads]")(
+        "blockSize,b", po::value<size_t>()->default_value(1000), "[transactions per block]");
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, main_options), vm);
+        po::notify(vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    /// help information
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << main_options << std::endl;
+        exit(0);
+    }
+
+    return vm;
+}
+
+static Transactions createTxs(size_t _txNum, int64_t _blockLimit)
+{
+#ifdef FISCO_GM
+    bytes rlpBytes = fromHex(
+        "f901309f65f0d06e39dc3c08e32ac10a5070858962bc6c0f5760baca823f2d5582d14485174876e7ff8609"
+        "184e729fff8204a294d6f1a71052366dbae2f7ab2d5d5845e77965cf0d80b86448f85bce00000000000000"
+        "0000000000000000000000000000000000000000000000001bf5bd8a9e7ba8b936ea704292ff4aaa5797bf"
+        "671fdc8526dcd159f23c1f5a05f44e9fa862834dc7cb4541558f2b4961dc39eaaf0af7f7395028658d0e01"
+        "b86a37b840c7ca78e7ab80ee4be6d3936ba8e899d8fe12c12114502956ebe8c8629d36d88481dec9973574"
+        "2ea523c88cf3becba1cc4375bc9e225143fe1e8e43abc8a7c493a0ba3ce8383b7c91528bede9cf890b4b1e"
+        "9b99c1d8e56d6f8292c827470a606827a0ed511490a1666791b2bd7fc4f499eb5ff18fb97ba68ff9aee206"
+        "8fd63b88e817");
+#else
+    bytes rlpBytes = fromHex(
+        "f8ef9f65f0d06e39dc3c08e32ac10a5070858962bc6c0f5760baca823f2d5582d03f85174876e7ff"
+        "8609184e729fff82020394d6f1a71052366dbae2f7ab2d5d5845e77965cf0d80b86448f85bce000000"
+        "000000000000000000000000000000000000000000000000000000001bf5bd8a9e7ba8b936ea704292"
+        "ff4aaa5797bf671fdc8526dcd159f23c1f5a05f44e9fa862834dc7cb4541558f2b4961dc39eaaf0af7"
+        "f7395028658d0e01b86a371ca00b2b3fabd8598fefdda4efdb54f626367fc68e1735a8047f0f1c4f84"
+        "0255ca1ea0512500bc29f4cfe18ee1c88683006d73e56c934100b8abf4d2334560e1d2f75e");
+#endif
+    Transaction tx(ref(rlpBytes), CheckTransaction::Everything);
+    Secret sec = KeyPair::create().secret();
+    Transactions txs;
+    txs.reserve(_txNum);
+    for (size_t i = 0; i < _txNum; i++)
+    {
+        tx.setNonce(u256(utcTime()) * 1000000 + u256(i));
+        tx.setBlockLimit(u256(_blockLimit));
+        dev::Signature sig = sign(sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        /// recover the sender outside of the measured section
+        tx.sender();
+        txs.push_back(tx);
+    }
+    return txs;
+}
+
+static double speed(size_t _count, std::chrono::steady_clock::time_point const& _start)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start)
+                       .count();
+    return elapsed > 0 ? (double)_count * 1000000 / elapsed : 0;
+}
+
+int main(int argc, const char* argv[])
+{
+    auto params = initCommandLine(argc, argv);
+    size_t txNum = params["txs"].as<size_t>();
+    size_t threadNum = std::max(params["threads"].as<size_t>(), (size_t)1);
+    size_t sealerNum = params["sealers"].as<size_t>();
+    size_t blockSize = std::max(params["blockSize"].as<size_t>(), (size_t)1);
+
+    auto blockChain = std::make_shared<FakeBlockChain>();
+    auto service = std::make_shared<dev::p2p::Service>();
+    PROTOCOL_ID protocol = getGroupProtoclID(1, dev::eth::ProtocolID::TxPool);
+    auto txPool = std::make_shared<dev::txpool::TxPool>(service, blockChain, protocol, txNum);
+
+    std::cout << "creating " << txNum << " transactions..." << std::endl;
+    Transactions txs = createTxs(txNum, blockChain->number() + 500);
+
+    /// submit from threadNum threads, while sealerNum threads keep selecting transactions
+    std::atomic<size_t> submitted(0);
+    std::atomic<size_t> selected(0);
+    std::atomic<bool> submitting(true);
+    std::vector<std::thread> sealers;
+    for (size_t i = 0; i < sealerNum; i++)
+    {
+        sealers.push_back(std::thread([&]() {
+            while (submitting)
+            {
+                selected += txPool->topTransactions(blockSize).size();
+            }
+        }));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> submitters;
+    for (size_t i = 0; i < threadNum; i++)
+    {
+        submitters.push_back(std::thread([&, i]() {
+            for (size_t j = i; j < txs.size(); j += threadNum)
+            {
+                try
+                {
+                    txPool->submit(txs[j]);
+                    submitted++;
+                }
+                catch (std::exception& e)
+                {
+                    LOG(ERROR) << "[#TXPOOL_MAIN]: submit transaction failed: [EINFO]:  "
+                               << boost::diagnostic_information(e) << std::endl;
+                }
+            }
+        }));
+    }
+    for (auto& thread : submitters)
+        thread.join();
+    std::cout << "submit: " << submitted << " txs, " << speed(submitted, start) << " tx/s"
+              << std::endl;
+    submitting = false;
+    for (auto& thread : sealers)
+        thread.join();
+    std::cout << "concurrent topTransactions: " << selected << " txs selected" << std::endl;
+
+    /// select and drop the transactions block by block, as the sealer does
+    start = std::chrono::steady_clock::now();
+    size_t topped = 0;
+    size_t dropped = 0;
+    std::chrono::steady_clock::duration dropTime(0);
+    while (txPool->pendingSize() > 0)
+    {
+        Block block;
+        block.setTransactions(txPool->topTransactions(blockSize));
+        if (block.getTransactionSize() == 0)
+            break;
+        topped += block.getTransactionSize();
+        auto dropStart = std::chrono::steady_clock::now();
+        txPool->dropBlockTrans(block);
+        dropTime += std::chrono::steady_clock::now() - dropStart;
+        dropped += block.getTransactionSize();
+    }
+    std::cout << "topTransactions + dropBlockTrans: " << topped << " txs, "
+              << speed(topped, start) << " tx/s" << std::endl;
+    auto dropUs = std::chrono::duration_cast<std::chrono::microseconds>(dropTime).count();
+    std::cout << "dropBlockTrans: " << dropped << " txs, "
+              << (dropUs > 0 ? (double)dropped * 1000000 / dropUs : 0) << " tx/s" << std::endl;
+    return 0;
+}
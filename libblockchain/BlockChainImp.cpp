@@ -24,6 +24,7 @@
 #include "BlockChainImp.h"
 #include <libblockverifier/ExecutiveContext.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Metrics.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
 #include <libethcore/CommonJS.h>
@@ -47,6 +48,13 @@ using namespace dev::blockverifier;
 using namespace dev::executive;
 using boost::lexical_cast;
 
+static MetricHistogram::Ptr s_commitTime = MetricsRegistry::instance().histogram(
+    "fisco_block_commit_microseconds", "Time spent writing a block and its state to the storage");
+static MetricCounter::Ptr s_committedBlocks = MetricsRegistry::instance().counter(
+    "fisco_block_committed_blocks_total", "Blocks committed, of all the groups");
+static MetricCounter::Ptr s_committedTransactions = MetricsRegistry::instance().counter(
+    "fisco_block_committed_transactions_total", "Transactions committed, of all the groups");
+
 std::shared_ptr<Block> BlockCache::add(Block& _block)
 {
     BLOCKCHAIN_LOG(TRACE) << "[#add] Add block to block cache, [blockHash]: "
@@ -156,7 +164,8 @@ std::shared_ptr<Block> BlockChainImp::getBlock(dev::h256 const& _blockHash)
             {
                 auto entry = entries->get(0);
                 strBlock = entry->getField(SYS_VALUE);
-                auto block = Block(fromHex(strBlock.c_str()));
+                Block block;
+                decodeBlockValue(block, strBlock);
 
                 BLOCKCHAIN_LOG(TRACE) << "[#getBlock] Write to cache";
                 auto blockPtr = m_blockCache.add(block);
@@ -321,9 +330,7 @@ bool BlockChainImp::checkAndBuildGenesisBlock(GenesisBlockParam& initParam)
         if (tb)
         {
             Entry::Ptr entry = std::make_shared<Entry>();
-            bytes out;
-            block->encode(out);
-            entry->setField(SYS_VALUE, toHexPrefixed(out));
+            entry->setField(SYS_VALUE, encodeBlockValue(*block));
             tb->insert(block->blockHeader().hash().hex(), entry);
         }
 
@@ -539,10 +546,8 @@ std::shared_ptr<Block> BlockChainImp::getBlockByNumber(int64_t _i)
     }
 }
 
-Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
+bool BlockChainImp::getTxIndex(h256 const& _txHash, int64_t& _blockNumber, uint& _txIndex)
 {
-    string strblock = "";
-    string txIndex = "";
     Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false);
     if (tb)
     {
@@ -550,42 +555,99 @@ Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
         if (entries->size() > 0)
         {
             auto entry = entries->get(0);
-            strblock = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblock));
-            assert(pblock != nullptr);
-            std::vector<Transaction> txs = pblock->transactions();
-            if (txs.size() > lexical_cast<uint>(txIndex))
-            {
-                return txs[lexical_cast<uint>(txIndex)];
-            }
+            _blockNumber = lexical_cast<int64_t>(entry->getField(SYS_VALUE));
+            _txIndex = lexical_cast<uint>(entry->getField("index"));
+            return true;
         }
     }
+    return false;
+}
+
+bool BlockChainImp::getTxFromBlock(int64_t _blockNumber, uint _txIndex, h256& _blockHash,
+    Transaction* _tx, TransactionReceipt* _receipt)
+{
+    _blockHash = numberHash(_blockNumber);
+    auto cachedBlock = m_blockCache.get(_blockHash);
+    if (bool(cachedBlock.first))
+    {
+        auto const& txs = cachedBlock.first->transactions();
+        auto const& receipts = cachedBlock.first->transactionReceipts();
+        if ((_tx && txs.size() <= _txIndex) || (_receipt && receipts.size() <= _txIndex))
+        {
+            return false;
+        }
+        if (_tx)
+        {
+            *_tx = txs[_txIndex];
+        }
+        if (_receipt)
+        {
+            *_receipt = receipts[_txIndex];
+        }
+        return true;
+    }
+
+    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_HASH_2_BLOCK, false);
+    if (!tb)
+    {
+        return false;
+    }
+    auto entries = tb->select(_blockHash.hex(), tb->newCondition());
+    if (entries->size() == 0)
+    {
+        return false;
+    }
+    std::string strBlock = entries->get(0)->getField(SYS_VALUE);
+    bytes buffer;
+    /// only walk the RLP item headers up to the wanted transaction and receipt, the rest of
+    /// the block is never decoded
+    RLP blockRLP = BlockHeader::extractBlock(blockValueRef(strBlock, buffer));
+    if (_tx)
+    {
+        RLP txsRLP = blockRLP[1];
+        if (txsRLP.itemCount() <= _txIndex)
+        {
+            return false;
+        }
+        _tx->decode(txsRLP[_txIndex]);
+    }
+    if (_receipt)
+    {
+        RLP receiptsRLP = blockRLP[2];
+        if (receiptsRLP.itemCount() <= _txIndex)
+        {
+            return false;
+        }
+        _receipt->decode(receiptsRLP[_txIndex]);
+    }
+    return true;
+}
+
+Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
+{
+    int64_t blockNumber = 0;
+    uint txIndex = 0;
+    h256 blockHash;
+    Transaction tx;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxFromBlock(blockNumber, txIndex, blockHash, &tx, nullptr))
+    {
+        return tx;
+    }
     BLOCKCHAIN_LOG(TRACE) << "[#getTxByHash] Can't find tx, return empty tx";
     return Transaction();
 }
 
 LocalisedTransaction BlockChainImp::getLocalisedTxByHash(dev::h256 const& _txHash)
 {
-    string strblockhash = "";
-    string txIndex = "";
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false);
-    if (tb)
+    int64_t blockNumber = 0;
+    uint txIndex = 0;
+    h256 blockHash;
+    Transaction tx;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxFromBlock(blockNumber, txIndex, blockHash, &tx, nullptr))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            strblockhash = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblockhash));
-            std::vector<Transaction> txs = pblock->transactions();
-            if (txs.size() > lexical_cast<uint>(txIndex))
-            {
-                return LocalisedTransaction(txs[lexical_cast<uint>(txIndex)], pblock->headerHash(),
-                    lexical_cast<unsigned>(txIndex), pblock->blockHeader().number());
-            }
-        }
+        return LocalisedTransaction(tx, blockHash, txIndex, blockNumber);
     }
     BLOCKCHAIN_LOG(TRACE) << "[#getLocalisedTxByHash] Can't find tx, return empty localised tx";
     return LocalisedTransaction(Transaction(), h256(0), -1, -1);
@@ -593,24 +655,14 @@ LocalisedTransaction BlockChainImp::getLocalisedTxByHash(dev::h256 const& _txHas
 
 TransactionReceipt BlockChainImp::getTransactionReceiptByHash(dev::h256 const& _txHash)
 {
-    string strblock = "";
-    string txIndex = "";
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false);
-    if (tb)
+    int64_t blockNumber = 0;
+    uint txIndex = 0;
+    h256 blockHash;
+    TransactionReceipt receipt;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxFromBlock(blockNumber, txIndex, blockHash, nullptr, &receipt))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            strblock = entry->getField(SYS_VALUE);
-            txIndex = entry->getField("index");
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(strblock));
-            std::vector<TransactionReceipt> receipts = pblock->transactionReceipts();
-            if (receipts.size() > lexical_cast<uint>(txIndex))
-            {
-                return receipts[lexical_cast<uint>(txIndex)];
-            }
-        }
+        return receipt;
     }
     BLOCKCHAIN_LOG(TRACE)
         << "[#getTransactionReceiptByHash] Can't find tx, return empty localised tx receipt";
@@ -619,29 +671,16 @@ TransactionReceipt BlockChainImp::getTransactionReceiptByHash(dev::h256 const& _
 
 LocalisedTransactionReceipt BlockChainImp::getLocalisedTxReceiptByHash(dev::h256 const& _txHash)
 {
-    Table::Ptr tb = getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false);
-    if (tb)
+    int64_t blockNumber = 0;
+    uint txIndex = 0;
+    h256 blockHash;
+    Transaction tx;
+    TransactionReceipt receipt;
+    if (getTxIndex(_txHash, blockNumber, txIndex) &&
+        getTxFromBlock(blockNumber, txIndex, blockHash, &tx, &receipt))
     {
-        auto entries = tb->select(_txHash.hex(), tb->newCondition());
-        if (entries->size() > 0)
-        {
-            auto entry = entries->get(0);
-            auto blockNum = lexical_cast<int64_t>(entry->getField(SYS_VALUE));
-            auto txIndex = lexical_cast<uint>(entry->getField("index"));
-
-            std::shared_ptr<Block> pblock = getBlockByNumber(lexical_cast<int64_t>(blockNum));
-            const Transactions& txs = pblock->transactions();
-            const TransactionReceipts& receipts = pblock->transactionReceipts();
-            if (receipts.size() > txIndex && txs.size() > txIndex)
-            {
-                auto& tx = txs[txIndex];
-                auto& receipt = receipts[txIndex];
-
-                return LocalisedTransactionReceipt(receipt, _txHash, pblock->headerHash(),
-                    pblock->header().number(), tx.from(), tx.to(), txIndex, receipt.gasUsed(),
-                    receipt.contractAddress());
-            }
-        }
+        return LocalisedTransactionReceipt(receipt, _txHash, blockHash, blockNumber, tx.from(),
+            tx.to(), txIndex, receipt.gasUsed(), receipt.contractAddress());
     }
     BLOCKCHAIN_LOG(TRACE)
         << "[#getLocalisedTxReceiptByHash] Can't find tx, return empty localised tx receipt";
@@ -706,7 +745,8 @@ void BlockChainImp::writeTxToBlock(const Block& block, std::shared_ptr<Executive
     Table::Ptr tb = context->getMemoryTableFactory()->openTable(SYS_TX_HASH_2_BLOCK, false);
     if (tb)
     {
-        std::vector<Transaction> txs = block.transactions();
+        Transactions const& txs = block.transactions();
+        Transaction::calculateHashes(txs);
         for (uint i = 0; i < txs.size(); i++)
         {
             Entry::Ptr entry = std::make_shared<Entry>();
@@ -742,9 +782,7 @@ void BlockChainImp::writeHash2Block(Block& block, std::shared_ptr<ExecutiveConte
     if (tb)
     {
         Entry::Ptr entry = std::make_shared<Entry>();
-        bytes out;
-        block.encode(out);
-        entry->setField(SYS_VALUE, toHexPrefixed(out));
+        entry->setField(SYS_VALUE, encodeBlockValue(block));
         tb->insert(block.blockHeader().hash().hex(), entry);
     }
     else
@@ -781,12 +819,15 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
     {
         try
         {
+            ScopedMetricTimer timer(s_commitTime);
             writeNumber(block, context);
             writeTotalTransactionCount(block, context);
             writeTxToBlock(block, context);
             writeBlockInfo(block, context);
             context->dbCommit(block);
             commitMutex.unlock();
+            s_committedBlocks->add();
+            s_committedTransactions->add(block.transactions().size());
             m_onReady();
             return CommitResult::OK;
         }
@@ -807,3 +848,28 @@ CommitResult BlockChainImp::commitBlock(Block& block, std::shared_ptr<ExecutiveC
         return CommitResult::ERROR_COMMITTING;
     }
 }
+
+std::string BlockChainImp::encodeBlockValue(Block& _block)
+{
+    bytes out;
+    _block.encode(out);
+    return std::string(out.begin(), out.end());
+}
+
+void BlockChainImp::decodeBlockValue(Block& _block, std::string const& _value)
+{
+    bytes buffer;
+    _block.decode(blockValueRef(_value, buffer));
+}
+
+bytesConstRef BlockChainImp::blockValueRef(std::string const& _value, bytes& _buffer)
+{
+    /// an encoded block is always an RLP list, whose first byte is at least 0xc0, while the hex
+    /// rows written by older versions only contain ascii characters
+    if (!_value.empty() && (uint8_t)_value[0] >= 0xc0)
+    {
+        return bytesConstRef((const byte*)_value.data(), _value.size());
+    }
+    _buffer = fromHex(_value);
+    return ref(_buffer);
+}
@@ -100,9 +100,22 @@ public:
     dev::h512s observerList() override;
     std::string getSystemConfigByKey(std::string const& key, int64_t num = -1) override;
 
+    /// blocks are stored in SYS_HASH_2_BLOCK as raw RLP, rows written by older versions are
+    /// hex encoded and still accepted by decodeBlockValue
+    static std::string encodeBlockValue(dev::eth::Block& _block);
+    static void decodeBlockValue(dev::eth::Block& _block, std::string const& _value);
+
 private:
     std::shared_ptr<dev::eth::Block> getBlock(int64_t _i);
     std::shared_ptr<dev::eth::Block> getBlock(dev::h256 const& _blockHash);
+    /// find the block number and index of a transaction in SYS_TX_HASH_2_BLOCK
+    bool getTxIndex(dev::h256 const& _txHash, int64_t& _blockNumber, uint& _txIndex);
+    /// decode a single transaction and/or receipt of a committed block, without decoding the
+    /// whole block
+    bool getTxFromBlock(int64_t _blockNumber, uint _txIndex, dev::h256& _blockHash,
+        dev::eth::Transaction* _tx, dev::eth::TransactionReceipt* _receipt);
+    /// the RLP of an encoded block value, _buffer keeps the data of hex rows alive
+    static bytesConstRef blockValueRef(std::string const& _value, bytes& _buffer);
     void writeNumber(const dev::eth::Block& block,
         std::shared_ptr<dev::blockverifier::ExecutiveContext> context);
     void writeTotalTransactionCount(const dev::eth::Block& block,
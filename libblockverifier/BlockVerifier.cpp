@@ -20,11 +20,13 @@
  */
 #include "BlockVerifier.h"
 #include "ExecutiveContext.h"
+#include <libdevcore/Metrics.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/PrecompiledContract.h>
 #include <libethcore/TransactionReceipt.h>
 #include <libexecutive/ExecutionResult.h>
 #include <libexecutive/Executive.h>
+#include <libstorage/ChainedStorage.h>
 #include <exception>
 using namespace dev;
 using namespace std;
@@ -32,8 +34,20 @@ using namespace dev::eth;
 using namespace dev::blockverifier;
 using namespace dev::executive;
 
+static MetricHistogram::Ptr s_executeTime = MetricsRegistry::instance().histogram(
+    "fisco_block_execute_microseconds", "Time spent executing the transactions of a block");
+static MetricCounter::Ptr s_executedTransactions = MetricsRegistry::instance().counter(
+    "fisco_block_executed_transactions_total", "Transactions executed in blocks");
+
 ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const& parentBlockInfo)
 {
+    return executeBlock(block, parentBlockInfo, nullptr);
+}
+
+ExecutiveContext::Ptr BlockVerifier::executeBlock(
+    Block& block, BlockInfo const& parentBlockInfo, dev::storage::Storage::Ptr _parentState)
+{
+    ScopedMetricTimer timer(s_executeTime);
     BLOCKVERIFIER_LOG(INFO) << "[#executeBlock] [txNum/num/parentHash/parentNum/parentStateRoot]:"
                             << "[ " << block.transactions().size() << "/ "
                             << block.blockHeader().number() << "/ " << parentBlockInfo.hash << "/ "
@@ -42,8 +56,16 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
     ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
     try
     {
-        m_executiveContextFactory->initExecutiveContext(
-            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        if (_parentState)
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext, _parentState);
+        }
+        else
+        {
+            m_executiveContextFactory->initExecutiveContext(
+                parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+        }
     }
     catch (exception& e)
     {
@@ -54,12 +76,74 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
                               << errinfo_comment("Error during initExecutiveContext"));
     }
 
-    unsigned i = 0;
+    /// the parents may not have been committed yet, their hashes come with their states
+    auto chainedState = std::dynamic_pointer_cast<dev::storage::ChainedStorage>(_parentState);
+    NumberHashCallBackFunction numberHash = [this, parentBlockInfo, chainedState](
+                                                int64_t _number) -> h256 {
+        if (_number == parentBlockInfo.number)
+        {
+            return parentBlockInfo.hash;
+        }
+        h256 hash = chainedState ? chainedState->blockHash(_number) : h256();
+        return hash != h256() ? hash : m_pNumberHash(_number);
+    };
     BlockHeader tmpHeader = block.blockHeader();
     block.clearAllReceipts();
+    if (m_threadPool && block.transactions().size() > 1)
+    {
+        executeTransactionsParallel(
+            block, parentBlockInfo, _parentState, executiveContext, numberHash);
+    }
+    else
+    {
+        executeTransactions(block, executiveContext, numberHash);
+    }
+    s_executedTransactions->add(block.transactions().size());
+    block.calReceiptRoot();
+    block.header().setStateRoot(executiveContext->getState()->rootHash());
+    if (tmpHeader.receiptsRoot() != h256() && tmpHeader.stateRoot() != h256())
+    {
+        if (tmpHeader != block.blockHeader())
+        {
+            BOOST_THROW_EXCEPTION(InvalidBlockWithBadStateOrReceipt() << errinfo_comment(
+                                      "Invalid Block with bad stateRoot or ReciptRoot"));
+        }
+    }
+    return executiveContext;
+}
+
+void BlockVerifier::setParallelExecution(bool _enable, size_t _threadNum)
+{
+    m_threadPool.reset();
+    m_threadNum = 0;
+    if (_enable && _threadNum > 0)
+    {
+        m_threadNum = _threadNum;
+        m_threadPool = std::make_shared<dev::ThreadPool>("executor", _threadNum);
+    }
+}
+
+void BlockVerifier::setCallExecution(size_t _threadNum, size_t _maxQueued, bool _readOnly)
+{
+    m_callExecutor.reset();
+    if (_threadNum > 0)
+    {
+        m_callExecutor = make_shared<CallExecutor>(
+            m_executiveContextFactory, [this](int64_t _number) { return m_pNumberHash(_number); },
+            [this, _readOnly](EnvInfo const& _envInfo, Transaction const& _t,
+                ExecutiveContext::Ptr _executiveContext) {
+                return execute(_envInfo, _t, OnOpFunc(), _executiveContext, _readOnly);
+            },
+            _threadNum, _maxQueued);
+    }
+}
+
+void BlockVerifier::executeTransactions(Block& block, ExecutiveContext::Ptr executiveContext,
+    NumberHashCallBackFunction const& numberHash)
+{
     for (Transaction const& tr : block.transactions())
     {
-        EnvInfo envInfo(block.blockHeader(), m_pNumberHash,
+        EnvInfo envInfo(block.blockHeader(), numberHash,
             block.getTransactionReceipts().size() > 0 ?
                 block.getTransactionReceipts().back().gasUsed() :
                 0);
@@ -69,22 +153,107 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
         block.appendTransactionReceipt(resultReceipt.second);
         executiveContext->getState()->commit();
     }
-    block.calReceiptRoot();
-    block.header().setStateRoot(executiveContext->getState()->rootHash());
-    if (tmpHeader.receiptsRoot() != h256() && tmpHeader.stateRoot() != h256())
+}
+
+/**
+ * @brief : every transaction is executed on its own ExecutiveContext over the parent state,
+ *          the MemoryTableFactory of which records the keys selected and written. The results are
+ *          merged into executiveContext in block order, a transaction that accessed a key written
+ *          by the transactions before it (or that failed speculatively) is executed again on
+ *          executiveContext, so the receipts and state root are the same as the serial ones.
+ */
+void BlockVerifier::executeTransactionsParallel(Block& block, BlockInfo const& parentBlockInfo,
+    dev::storage::Storage::Ptr parentState, ExecutiveContext::Ptr executiveContext,
+    NumberHashCallBackFunction const& numberHash)
+{
+    auto const& transactions = block.transactions();
+    std::vector<ExecutiveContext::Ptr> contexts(transactions.size());
+    std::vector<TransactionReceipt> receipts(transactions.size());
+
+    m_threadPool->runAndWait(m_threadNum, [&](size_t thread) {
+        for (size_t i = thread; i < transactions.size(); i += m_threadNum)
+        {
+            try
+            {
+                ExecutiveContext::Ptr context = std::make_shared<ExecutiveContext>();
+                if (parentState)
+                {
+                    m_executiveContextFactory->initExecutiveContext(
+                        parentBlockInfo, parentBlockInfo.stateRoot, context, parentState);
+                }
+                else
+                {
+                    m_executiveContextFactory->initExecutiveContext(
+                        parentBlockInfo, parentBlockInfo.stateRoot, context);
+                }
+                context->getMemoryTableFactory()->setTrackAccess(true);
+                EnvInfo envInfo(block.blockHeader(), numberHash, 0);
+                envInfo.setPrecompiledEngine(context);
+                receipts[i] = execute(envInfo, transactions[i], OnOpFunc(), context).second;
+                /// the addresses of registered precompileds depend on the transactions before
+                if (!context->hasRegisteredPrecompiled())
+                {
+                    contexts[i] = context;
+                }
+            }
+            catch (std::exception& e)
+            {
+                BLOCKVERIFIER_LOG(TRACE)
+                    << "[#executeTransactionsParallel] speculative execution failed [EINFO]: "
+                    << boost::diagnostic_information(e);
+            }
+            catch (...)
+            {
+                BLOCKVERIFIER_LOG(TRACE)
+                    << "[#executeTransactionsParallel] speculative execution failed";
+            }
+        }
+    });
+
+    auto memoryTableFactory = executiveContext->getMemoryTableFactory();
+    memoryTableFactory->setTrackAccess(true);
+    size_t reexecuted = 0;
+    for (size_t i = 0; i < transactions.size(); ++i)
     {
-        if (tmpHeader != block.blockHeader())
+        u256 gasUsed = block.getTransactionReceipts().size() > 0 ?
+                           block.getTransactionReceipts().back().gasUsed() :
+                           0;
+        if (contexts[i] && !memoryTableFactory->conflictWith(contexts[i]->getMemoryTableFactory()))
         {
-            BOOST_THROW_EXCEPTION(InvalidBlockWithBadStateOrReceipt() << errinfo_comment(
-                                      "Invalid Block with bad stateRoot or ReciptRoot"));
+            memoryTableFactory->merge(contexts[i]->getMemoryTableFactory());
+            /// cached codes of the state may be stale after merging
+            executiveContext->getState()->clear();
+            auto const& receipt = receipts[i];
+            block.appendTransactionReceipt(TransactionReceipt(
+                executiveContext->getState()->rootHash(), gasUsed + receipt.gasUsed(),
+                receipt.log(), receipt.status(), receipt.outputBytes(),
+                receipt.contractAddress()));
         }
+        else
+        {
+            ++reexecuted;
+            EnvInfo envInfo(block.blockHeader(), numberHash, gasUsed);
+            envInfo.setPrecompiledEngine(executiveContext);
+            block.appendTransactionReceipt(
+                execute(envInfo, transactions[i], OnOpFunc(), executiveContext).second);
+        }
+        contexts[i].reset();
+        executiveContext->getState()->commit();
     }
-    return executiveContext;
+    memoryTableFactory->setTrackAccess(false);
+
+    BLOCKVERIFIER_LOG(DEBUG) << "[#executeTransactionsParallel] [txNum/reexecuted/threadNum]: "
+                             << transactions.size() << "/" << reexecuted << "/" << m_threadNum;
 }
 
 std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction(
     const BlockHeader& blockHeader, dev::eth::Transaction const& _t)
 {
+    if (m_callExecutor)
+    {
+        return m_callExecutor->call(blockHeader, _t);
+    }
+
     ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
     BlockInfo blockInfo{blockHeader.hash(), blockHeader.number(), blockHeader.stateRoot()};
     try
@@ -105,7 +274,8 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction
 }
 
 std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo const& _envInfo,
-    Transaction const& _t, OnOpFunc const& _onOp, ExecutiveContext::Ptr executiveContext)
+    Transaction const& _t, OnOpFunc const& _onOp, ExecutiveContext::Ptr executiveContext,
+    bool _staticCall)
 {
     auto onOp = _onOp;
 #if ETH_VMTRACE
@@ -118,6 +288,7 @@ std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::execute(EnvInfo co
     Executive e(executiveContext->getState(), _envInfo);
     ExecutionResult res;
     e.setResultRecipient(res);
+    e.setStaticCall(_staticCall);
     e.initialize(_t);
 
     // OK - transaction looks valid - execute.
@@ -21,10 +21,12 @@
 #pragma once
 
 #include "BlockVerifierInterface.h"
+#include "CallExecutor.h"
 #include "ExecutiveContext.h"
 #include "ExecutiveContextFactory.h"
 #include "Precompiled.h"
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
 #include <libdevcrypto/Common.h>
 #include <libethcore/Block.h>
@@ -63,6 +65,8 @@ public:
     virtual ~BlockVerifier(){};
 
     ExecutiveContext::Ptr executeBlock(dev::eth::Block& block, BlockInfo const& parentBlockInfo);
+    ExecutiveContext::Ptr executeBlock(dev::eth::Block& block, BlockInfo const& parentBlockInfo,
+        dev::storage::Storage::Ptr _parentState) override;
 
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t);
@@ -70,7 +74,7 @@ public:
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> execute(
         dev::eth::EnvInfo const& _envInfo, dev::eth::Transaction const& _t,
         dev::eth::OnOpFunc const& _onOp,
-        dev::blockverifier::ExecutiveContext::Ptr executiveContext);
+        dev::blockverifier::ExecutiveContext::Ptr executiveContext, bool _staticCall = false);
 
 
     void setExecutiveContextFactory(ExecutiveContextFactory::Ptr executiveContextFactory)
@@ -82,10 +86,26 @@ public:
     {
         m_pNumberHash = _pNumberHash;
     }
+    /// execute the transactions of a block speculatively on _threadNum threads (storage state only)
+    void setParallelExecution(bool _enable, size_t _threadNum);
+    /// execute the transactions of executeTransaction, which are calls, on _threadNum threads
+    /// reusing the contexts of the latest block, 0 executes each on a new context of its own,
+    /// _readOnly executes them as static calls, which fail at the first change of the EVM state
+    void setCallExecution(size_t _threadNum, size_t _maxQueued, bool _readOnly = false);
+    CallExecutor::Ptr callExecutor() { return m_callExecutor; }
 
 private:
+    void executeTransactions(dev::eth::Block& block, ExecutiveContext::Ptr executiveContext,
+        NumberHashCallBackFunction const& numberHash);
+    void executeTransactionsParallel(dev::eth::Block& block, BlockInfo const& parentBlockInfo,
+        dev::storage::Storage::Ptr parentState, ExecutiveContext::Ptr executiveContext,
+        NumberHashCallBackFunction const& numberHash);
+
     ExecutiveContextFactory::Ptr m_executiveContextFactory;
     NumberHashCallBackFunction m_pNumberHash;
+    size_t m_threadNum = 0;
+    std::shared_ptr<dev::ThreadPool> m_threadPool;
+    CallExecutor::Ptr m_callExecutor;
 };
 
 }  // namespace blockverifier
@@ -52,6 +52,12 @@ public:
 
     virtual ExecutiveContext::Ptr executeBlock(
         dev::eth::Block& block, BlockInfo const& parentBlockInfo) = 0;
+    /// execute the block on _parentState, the state of a parent which hasn't been committed yet
+    virtual ExecutiveContext::Ptr executeBlock(dev::eth::Block& block,
+        BlockInfo const& parentBlockInfo, dev::storage::Storage::Ptr _parentState)
+    {
+        return executeBlock(block, parentBlockInfo);
+    }
     virtual std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt>
     executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t) = 0;
@@ -0,0 +1,217 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CallExecutor.cpp
+ *  @date 20190329
+ */
+#include "CallExecutor.h"
+#include "Common.h"
+#include <libdevcore/Metrics.h>
+#include <chrono>
+#include <future>
+
+using namespace dev;
+using namespace std;
+using namespace dev::eth;
+using namespace dev::blockverifier;
+using namespace dev::executive;
+
+/// log the metrics once every that many calls
+static const uint64_t c_metricsLogInterval = 10000;
+
+static MetricCounter::Ptr s_calls =
+    MetricsRegistry::instance().counter("fisco_call_total", "Calls executed");
+static MetricCounter::Ptr s_failures =
+    MetricsRegistry::instance().counter("fisco_call_failures_total", "Calls which threw");
+static MetricCounter::Ptr s_rejected = MetricsRegistry::instance().counter(
+    "fisco_call_rejected_total", "Calls rejected because too many calls were waiting");
+static MetricGauge::Ptr s_queued =
+    MetricsRegistry::instance().gauge("fisco_call_queued", "Calls waiting for a thread");
+static MetricCounter::Ptr s_contextsCreated = MetricsRegistry::instance().counter(
+    "fisco_call_contexts_created_total", "Executive contexts created for calls");
+static MetricCounter::Ptr s_contextsReused = MetricsRegistry::instance().counter(
+    "fisco_call_contexts_reused_total", "Executive contexts reused by calls");
+static MetricHistogram::Ptr s_queueTime = MetricsRegistry::instance().histogram(
+    "fisco_call_queue_microseconds", "Time calls spent waiting for a thread");
+static MetricHistogram::Ptr s_executeTime = MetricsRegistry::instance().histogram(
+    "fisco_call_execute_microseconds", "Time spent executing calls");
+
+static uint64_t elapsedMicroseconds(chrono::steady_clock::time_point const& _start)
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - _start)
+        .count();
+}
+
+CallExecutor::CallExecutor(ExecutiveContextFactory::Ptr _executiveContextFactory,
+    NumberHashFunction const& _numberHash, ExecuteFunction const& _execute, size_t _threadNum,
+    size_t _maxQueued)
+  : m_executiveContextFactory(_executiveContextFactory),
+    m_numberHash(_numberHash),
+    m_execute(_execute),
+    m_threadNum(_threadNum),
+    m_maxQueued(_maxQueued)
+{
+    m_threadPool = make_shared<dev::ThreadPool>("call", _threadNum);
+}
+
+pair<ExecutionResult, TransactionReceipt> CallExecutor::call(
+    BlockHeader const& _blockHeader, Transaction const& _t)
+{
+    /// reserve the slot first so that concurrent calls can't pass the limit together
+    if (m_queued++ >= m_maxQueued)
+    {
+        --m_queued;
+        ++m_rejected;
+        s_rejected->add();
+        BOOST_THROW_EXCEPTION(
+            CallQueueFull() << errinfo_comment("too many calls are waiting to be executed"));
+    }
+    s_queued->add();
+
+    typedef pair<ExecutionResult, TransactionReceipt> Result;
+    auto promise = make_shared<std::promise<Result> >();
+    auto start = chrono::steady_clock::now();
+    BlockHeader blockHeader = _blockHeader;
+    Transaction tx = _t;
+    m_threadPool->enqueue([this, promise, start, blockHeader, tx]() {
+        --m_queued;
+        s_queued->sub();
+        uint64_t queueTime = elapsedMicroseconds(start);
+        m_queueTime += queueTime;
+        s_queueTime->observe(queueTime);
+        auto executeStart = chrono::steady_clock::now();
+        try
+        {
+            promise->set_value(execute(blockHeader, tx));
+        }
+        catch (...)
+        {
+            ++m_failures;
+            s_failures->add();
+            promise->set_exception(current_exception());
+        }
+        uint64_t executeTime = elapsedMicroseconds(executeStart);
+        m_executeTime += executeTime;
+        s_executeTime->observe(executeTime);
+        uint64_t maxExecuteTime = m_maxExecuteTime;
+        while (executeTime > maxExecuteTime &&
+               !m_maxExecuteTime.compare_exchange_weak(maxExecuteTime, executeTime))
+        {
+        }
+    });
+    uint64_t calls = ++m_calls;
+    s_calls->add();
+    auto result = promise->get_future().get();
+
+    if (calls % c_metricsLogInterval == 0)
+    {
+        auto callMetrics = metrics();
+        BLOCKVERIFIER_LOG(INFO) << "[#call] [calls/failures/rejected/queued/contextsCreated/"
+                                   "contextsReused/avgQueueTime/avgExecuteTime/maxExecuteTime]: "
+                                << callMetrics.calls << "/" << callMetrics.failures << "/"
+                                << callMetrics.rejected << "/" << callMetrics.queued << "/"
+                                << callMetrics.contextsCreated << "/"
+                                << callMetrics.contextsReused << "/"
+                                << callMetrics.queueTime / callMetrics.calls << "/"
+                                << callMetrics.executeTime / callMetrics.calls << "/"
+                                << callMetrics.maxExecuteTime;
+    }
+    return result;
+}
+
+CallExecutor::Metrics CallExecutor::metrics() const
+{
+    Metrics callMetrics;
+    callMetrics.calls = m_calls;
+    callMetrics.failures = m_failures;
+    callMetrics.rejected = m_rejected;
+    callMetrics.queued = m_queued;
+    callMetrics.contextsCreated = m_contextsCreated;
+    callMetrics.contextsReused = m_contextsReused;
+    callMetrics.queueTime = m_queueTime;
+    callMetrics.executeTime = m_executeTime;
+    callMetrics.maxExecuteTime = m_maxExecuteTime;
+    return callMetrics;
+}
+
+pair<ExecutionResult, TransactionReceipt> CallExecutor::execute(
+    BlockHeader const& _blockHeader, Transaction const& _t)
+{
+    PooledContext context = acquire(_blockHeader);
+    EnvInfo envInfo(_blockHeader, m_numberHash, 0);
+    envInfo.setPrecompiledEngine(context.context);
+    /// a context left in an unknown state by an exception isn't reused
+    auto result = m_execute(envInfo, _t, context.context);
+    release(_blockHeader, context);
+    return result;
+}
+
+CallExecutor::PooledContext CallExecutor::acquire(BlockHeader const& _blockHeader)
+{
+    {
+        Guard l(x_contexts);
+        if (m_contextsBlockHash == _blockHeader.hash() && !m_contexts.empty())
+        {
+            PooledContext context = m_contexts.back();
+            m_contexts.pop_back();
+            ++m_contextsReused;
+            s_contextsReused->add();
+            return context;
+        }
+    }
+
+    PooledContext context;
+    context.context = make_shared<ExecutiveContext>();
+    BlockInfo blockInfo{_blockHeader.hash(), _blockHeader.number(), _blockHeader.stateRoot()};
+    try
+    {
+        m_executiveContextFactory->initExecutiveContext(
+            blockInfo, _blockHeader.stateRoot(), context.context);
+    }
+    catch (exception& e)
+    {
+        BLOCKVERIFIER_LOG(ERROR)
+            << "[#call] Error during execute initExecutiveContext [errorMsg]: "
+            << boost::diagnostic_information(e);
+    }
+    context.stateSavepoint = context.context->getState()->savepoint();
+    context.tableSavepoint = context.context->getMemoryTableFactory()->savepoint();
+    context.lastRegisteredAddress = context.context->lastRegisteredAddress();
+    ++m_contextsCreated;
+    s_contextsCreated->add();
+    return context;
+}
+
+void CallExecutor::release(BlockHeader const& _blockHeader, PooledContext& _context)
+{
+    _context.context->getMemoryTableFactory()->closeCreatedTables(_context.tableSavepoint);
+    _context.context->getState()->rollback(_context.stateSavepoint);
+    _context.context->getMemoryTableFactory()->rollback(_context.tableSavepoint);
+    _context.context->unregisterPrecompiled(_context.lastRegisteredAddress);
+
+    Guard l(x_contexts);
+    if (_blockHeader.number() > m_contextsBlockNumber)
+    {
+        /// contexts of older blocks aren't used any more
+        m_contexts.clear();
+        m_contextsBlockHash = _blockHeader.hash();
+        m_contextsBlockNumber = _blockHeader.number();
+    }
+    if (m_contextsBlockHash == _blockHeader.hash() && m_contexts.size() < m_threadNum)
+    {
+        m_contexts.push_back(_context);
+    }
+}
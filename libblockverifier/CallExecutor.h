@@ -0,0 +1,126 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CallExecutor.h
+ *  @date 20190329
+ */
+#pragma once
+
+#include "ExecutiveContext.h"
+#include "ExecutiveContextFactory.h"
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
+#include <libethcore/BlockHeader.h>
+#include <libethcore/Transaction.h>
+#include <libethcore/TransactionReceipt.h>
+#include <libevm/ExtVMFace.h>
+#include <libexecutive/ExecutionResult.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace dev
+{
+namespace blockverifier
+{
+DEV_SIMPLE_EXCEPTION(CallQueueFull);
+
+/// executes read-only calls on a dedicated thread pool, reusing the contexts of the latest block
+/// so that the precompileds aren't registered again and the selected rows stay cached,
+/// changes made by a call are rolled back and never committed, with [txExecute] callReadOnly
+/// a call fails at its first change of the EVM state instead, writes of precompileds such as
+/// CRUD tables aren't detected and still rely on the rollback
+class CallExecutor
+{
+public:
+    typedef std::shared_ptr<CallExecutor> Ptr;
+    typedef dev::eth::EnvInfo::CallBackFunction NumberHashFunction;
+    typedef std::function<std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt>(
+        dev::eth::EnvInfo const&, dev::eth::Transaction const&, ExecutiveContext::Ptr)>
+        ExecuteFunction;
+
+    struct Metrics
+    {
+        uint64_t calls = 0;
+        uint64_t failures = 0;
+        /// rejected because maxQueued calls were waiting
+        uint64_t rejected = 0;
+        size_t queued = 0;
+        uint64_t contextsCreated = 0;
+        uint64_t contextsReused = 0;
+        /// microseconds spent waiting in the queue and executing, summed over all calls
+        uint64_t queueTime = 0;
+        uint64_t executeTime = 0;
+        uint64_t maxExecuteTime = 0;
+    };
+
+    /// _threadNum: threads executing calls, also the max contexts kept for reuse,
+    /// _maxQueued: calls waiting for a thread beyond which new calls are rejected
+    CallExecutor(ExecutiveContextFactory::Ptr _executiveContextFactory,
+        NumberHashFunction const& _numberHash, ExecuteFunction const& _execute,
+        size_t _threadNum, size_t _maxQueued);
+    ~CallExecutor() { m_threadPool->stop(); }
+
+    /// execute _t on the state of the block of _blockHeader, throws CallQueueFull if too many
+    /// calls are waiting
+    std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> call(
+        dev::eth::BlockHeader const& _blockHeader, dev::eth::Transaction const& _t);
+
+    Metrics metrics() const;
+
+private:
+    struct PooledContext
+    {
+        ExecutiveContext::Ptr context;
+        /// the state every call starts with
+        size_t stateSavepoint = 0;
+        size_t tableSavepoint = 0;
+        int lastRegisteredAddress = 0;
+    };
+
+    std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> execute(
+        dev::eth::BlockHeader const& _blockHeader, dev::eth::Transaction const& _t);
+    PooledContext acquire(dev::eth::BlockHeader const& _blockHeader);
+    void release(dev::eth::BlockHeader const& _blockHeader, PooledContext& _context);
+
+    ExecutiveContextFactory::Ptr m_executiveContextFactory;
+    NumberHashFunction m_numberHash;
+    ExecuteFunction m_execute;
+    size_t m_threadNum;
+    size_t m_maxQueued;
+    dev::ThreadPool::Ptr m_threadPool;
+
+    /// idle contexts of the newest block a call was executed on
+    std::vector<PooledContext> m_contexts;
+    h256 m_contextsBlockHash;
+    int64_t m_contextsBlockNumber = -1;
+    mutable Mutex x_contexts;
+
+    std::atomic<uint64_t> m_calls = {0};
+    std::atomic<uint64_t> m_failures = {0};
+    std::atomic<uint64_t> m_rejected = {0};
+    std::atomic<size_t> m_queued = {0};
+    std::atomic<uint64_t> m_contextsCreated = {0};
+    std::atomic<uint64_t> m_contextsReused = {0};
+    std::atomic<uint64_t> m_queueTime = {0};
+    std::atomic<uint64_t> m_executeTime = {0};
+    std::atomic<uint64_t> m_maxExecuteTime = {0};
+};
+
+}  // namespace blockverifier
+
+}  // namespace dev
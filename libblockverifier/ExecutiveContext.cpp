@@ -73,6 +73,13 @@ Address ExecutiveContext::registerPrecompiled(Precompiled::Ptr p)
     return address;
 }
 
+void ExecutiveContext::unregisterPrecompiled(int _lastAddress)
+{
+    while (m_addressCount > _lastAddress)
+    {
+        m_address2Precompiled.erase(Address(m_addressCount--));
+    }
+}
 
 bool ExecutiveContext::isPrecompiled(Address address) const
 {
@@ -61,6 +61,13 @@ public:
 
     virtual bool isPrecompiled(Address address) const;
 
+    bool hasRegisteredPrecompiled() const { return m_addressCount != c_registeredAddressStart; }
+    /// the address of the last registered precompiled
+    int lastRegisteredAddress() const { return m_addressCount; }
+    /// unregister the precompileds registered after _lastAddress, so that a reused context
+    /// doesn't keep the tables, entries and conditions of finished calls
+    void unregisterPrecompiled(int _lastAddress);
+
     Precompiled::Ptr getPrecompiled(Address address) const;
 
     void setAddress2Precompiled(Address address, Precompiled::Ptr precompiled)
@@ -102,7 +109,8 @@ public:
 
 private:
     std::unordered_map<Address, Precompiled::Ptr> m_address2Precompiled;
-    int m_addressCount = 0x10000;
+    static const int c_registeredAddressStart = 0x10000;
+    int m_addressCount = c_registeredAddressStart;
     BlockInfo m_blockInfo;
     std::shared_ptr<dev::executive::StateFace> m_stateFace;
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
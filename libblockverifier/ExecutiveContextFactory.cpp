@@ -34,13 +34,22 @@ using namespace dev::executive;
 
 void ExecutiveContextFactory::initExecutiveContext(
     BlockInfo blockInfo, h256 stateRoot, ExecutiveContext::Ptr context)
+{
+    initExecutiveContext(blockInfo, stateRoot, context, m_stateStorage);
+}
+
+void ExecutiveContextFactory::initExecutiveContext(BlockInfo blockInfo, h256 stateRoot,
+    ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage)
 {
     // DBFactoryPrecompiled
     dev::storage::MemoryTableFactory::Ptr memoryTableFactory =
         std::make_shared<dev::storage::MemoryTableFactory>();
-    memoryTableFactory->setStateStorage(m_stateStorage);
+    memoryTableFactory->setStateStorage(_stateStorage);
     memoryTableFactory->setBlockHash(blockInfo.hash);
     memoryTableFactory->setBlockNum(blockInfo.number);
+    memoryTableFactory->setHashVersion(m_stateHashVersion);
+    memoryTableFactory->setConditionVersion(m_conditionVersion);
+    memoryTableFactory->setHashThreadPool(m_hashThreadPool, m_hashThreadNum);
 
     auto tableFactoryPrecompiled = std::make_shared<dev::blockverifier::TableFactoryPrecompiled>();
     tableFactoryPrecompiled->setMemoryTableFactory(memoryTableFactory);
@@ -75,6 +84,18 @@ void ExecutiveContextFactory::setStateFactory(
     m_stateFactoryInterface = stateFactoryInterface;
 }
 
+void ExecutiveContextFactory::setStateHash(unsigned _hashVersion, size_t _threadNum)
+{
+    m_stateHashVersion = _hashVersion;
+    m_hashThreadPool.reset();
+    m_hashThreadNum = 0;
+    if (_threadNum > 1)
+    {
+        m_hashThreadNum = _threadNum;
+        m_hashThreadPool = std::make_shared<dev::ThreadPool>("StateHash", _threadNum);
+    }
+}
+
 void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr context)
 {
     // get value from db
@@ -84,8 +105,8 @@ void ExecutiveContextFactory::setTxGasLimitToContext(ExecutiveContext::Ptr conte
         BlockInfo blockInfo = context->blockInfo();
         std::string ret;
 
-        auto values =
-            m_stateStorage->select(blockInfo.hash, blockInfo.number, storage::SYS_CONFIG, key);
+        auto values = context->getMemoryTableFactory()->stateStorage()->select(
+            blockInfo.hash, blockInfo.number, storage::SYS_CONFIG, key);
         if (!values || values->size() != 1)
         {
             EXECUTIVECONTEXT_LOG(ERROR) << "[#setTxGasLimitToContext] select error.";
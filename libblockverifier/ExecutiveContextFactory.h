@@ -22,7 +22,9 @@
 
 #include "ExecutiveContext.h"
 #include <libdevcore/OverlayDB.h>
+#include <libdevcore/ThreadPool.h>
 #include <libexecutive/StateFactoryInterface.h>
+#include <libstorage/MemoryTableFactory.h>
 #include <libstorage/Storage.h>
 namespace dev
 {
@@ -51,16 +53,32 @@ public:
 
     virtual void initExecutiveContext(
         BlockInfo blockInfo, h256 stateRoot, ExecutiveContext::Ptr context);
+    /// init the context on _stateStorage in place of the storage of the committed state
+    virtual void initExecutiveContext(BlockInfo blockInfo, h256 stateRoot,
+        ExecutiveContext::Ptr context, dev::storage::Storage::Ptr _stateStorage);
 
     virtual void setStateStorage(dev::storage::Storage::Ptr stateStorage);
 
     virtual void setStateFactory(
         std::shared_ptr<dev::executive::StateFactoryInterface> stateFactoryInterface);
 
+    /// _hashVersion: StateHashVersion of the state root,
+    /// _threadNum: threads hashing the modified tables, 0 or 1 hashes them serially
+    virtual void setStateHash(unsigned _hashVersion, size_t _threadNum);
+    /// ConditionVersion of the tables
+    virtual void setConditionVersion(unsigned _conditionVersion)
+    {
+        m_conditionVersion = _conditionVersion;
+    }
+
 private:
     dev::storage::Storage::Ptr m_stateStorage;
     std::shared_ptr<dev::executive::StateFactoryInterface> m_stateFactoryInterface;
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
+    unsigned m_stateHashVersion = dev::storage::CONCAT_STATE_HASH;
+    unsigned m_conditionVersion = dev::storage::INT_CONDITION;
+    dev::ThreadPool::Ptr m_hashThreadPool;
+    size_t m_hashThreadNum = 0;
 
     void setTxGasLimitToContext(ExecutiveContext::Ptr context);
 };
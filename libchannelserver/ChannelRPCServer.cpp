@@ -43,6 +43,7 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 
 using namespace std;
@@ -251,6 +252,9 @@ void dev::ChannelRPCServer::onClientRequest(dev::channel::ChannelSession::Ptr se
         case 0x12:
             onClientEthereumRequest(session, message);
             break;
+        case 0x14:
+            onClientTransactionsRequest(session, message);
+            break;
         case 0x13:
         {
             std::string data((char*)message->data(), message->dataSize());
@@ -304,6 +308,105 @@ void dev::ChannelRPCServer::onClientEthereumRequest(
     // TODO:txpool regist callback
 }
 
+int dev::ChannelRPCServer::decodeTransactionsRequest(
+    bytesConstRef _data, int& _groupID, std::vector<bytesConstRef>& _rlps)
+{
+    const byte* data = _data.data();
+    size_t size = _data.size();
+    auto readUint32 = [&](size_t offset) {
+        uint32_t value;
+        memcpy(&value, data + offset, sizeof(value));
+        return ntohl(value);
+    };
+
+    _rlps.clear();
+    if (size < 6)
+    {
+        return INVALID_TRANSACTIONS_FRAME;
+    }
+    uint16_t groupIDN;
+    memcpy(&groupIDN, data, sizeof(groupIDN));
+    _groupID = ntohs(groupIDN);
+    uint32_t count = readUint32(2);
+    size_t offset = 6;
+    /// every transaction takes at least its length
+    if (count > (size - offset) / 4)
+    {
+        return INVALID_TRANSACTIONS_FRAME;
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (size - offset < 4 || size - offset - 4 < readUint32(offset))
+        {
+            _rlps.clear();
+            return INVALID_TRANSACTIONS_FRAME;
+        }
+        size_t length = readUint32(offset);
+        _rlps.emplace_back(data + offset + 4, length);
+        offset += 4 + length;
+    }
+    if (offset != size)
+    {
+        _rlps.clear();
+        return INVALID_TRANSACTIONS_FRAME;
+    }
+    return 0;
+}
+
+bytes dev::ChannelRPCServer::encodeTransactionsResponse(
+    std::vector<std::pair<int32_t, h256>> const& _statuses)
+{
+    bytes response;
+    uint32_t countN = htonl(_statuses.size());
+    response.reserve(4 + _statuses.size() * (4 + h256::size));
+    response.insert(response.end(), (byte*)&countN, (byte*)&countN + sizeof(countN));
+    for (auto& status : _statuses)
+    {
+        int32_t statusN = htonl(status.first);
+        response.insert(response.end(), (byte*)&statusN, (byte*)&statusN + sizeof(statusN));
+        response.insert(response.end(), status.second.begin(), status.second.end());
+    }
+    return response;
+}
+
+void dev::ChannelRPCServer::onClientTransactionsRequest(
+    dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message)
+{
+    bytes response;
+    std::vector<bytesConstRef> rlps;
+    int groupID = 0;
+    int result = decodeTransactionsRequest(
+        bytesConstRef(message->data(), message->dataSize()), groupID, rlps);
+
+    if (result == 0)
+    {
+        try
+        {
+            if (!m_transactionsHandler)
+            {
+                throw(ChannelException(-1, "binary transactions not supported"));
+            }
+            response = encodeTransactionsResponse(m_transactionsHandler(groupID, rlps));
+        }
+        catch (std::exception& e)
+        {
+            CHANNEL_LOG(ERROR) << "submit binary transactions failed, seq:" << message->seq()
+                               << " error:" << boost::diagnostic_information(e);
+            result = TRANSACTIONS_REJECTED;
+            response.clear();
+        }
+    }
+
+    CHANNEL_LOG(DEBUG) << "binary transactions seq:" << message->seq() << " group:" << groupID
+                       << " count:" << rlps.size() << " result:" << result;
+    auto reply = session->messageFactory()->buildMessage();
+    reply->setSeq(message->seq());
+    reply->setResult(result);
+    reply->setType(0x14);
+    reply->setData(response.data(), response.size());
+    session->asyncSendMessage(reply, dev::channel::ChannelSession::CallbackType(), 0);
+}
+
 void dev::ChannelRPCServer::onNodeChannelRequest(
     dev::network::NetworkException, std::shared_ptr<p2p::P2PSession> s, p2p::P2PMessage::Ptr msg)
 {
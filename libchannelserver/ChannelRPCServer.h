@@ -58,10 +58,16 @@ public:
     {
         REMOTE_PEER_UNAVAILIBLE = 100,
         REMOTE_CLIENT_PEER_UNAVAILBLE = 101,
-        TIMEOUT = 102
+        TIMEOUT = 102,
+        INVALID_TRANSACTIONS_FRAME = 103,
+        TRANSACTIONS_REJECTED = 104
     };
 
     typedef std::shared_ptr<ChannelRPCServer> Ptr;
+    /// submits the raw transactions to a group, returns the status and hash of each transaction
+    typedef std::function<std::vector<std::pair<int32_t, h256>>(
+        int, std::vector<bytesConstRef> const&)>
+        TransactionsHandler;
 
     ChannelRPCServer(std::string listenAddr = "", int listenPort = 0)
       : jsonrpc::AbstractServerConnector(), _listenAddr(listenAddr), _listenPort(listenPort){};
@@ -91,6 +97,24 @@ public:
     virtual void onClientChannelRequest(
         dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
 
+    /// binary transactions, data of the request:
+    ///     groupID(uint16) count(uint32) {length(uint32) rlp}*count
+    /// data of the response, whose result is 0 if every transaction has a status:
+    ///     count(uint32) {status(int32) hash(32 bytes)}*count
+    /// integers are big endian, status 0 is success, others are dev::eth::ImportResult
+    virtual void onClientTransactionsRequest(
+        dev::channel::ChannelSession::Ptr session, dev::channel::Message::Ptr message);
+    /// parse the data of a binary transactions request, the rlps refer to _data, returns
+    /// INVALID_TRANSACTIONS_FRAME if it's truncated or has bytes left, 0 otherwise
+    static int decodeTransactionsRequest(
+        bytesConstRef _data, int& _groupID, std::vector<bytesConstRef>& _rlps);
+    static bytes encodeTransactionsResponse(std::vector<std::pair<int32_t, h256>> const& _statuses);
+
+    void setTransactionsHandler(TransactionsHandler const& _handler)
+    {
+        m_transactionsHandler = _handler;
+    }
+
     void setListenAddr(const std::string& listenAddr);
 
     void setListenPort(int listenPort);
@@ -145,6 +169,7 @@ private:
     int _sessionCount = 1;
 
     std::shared_ptr<dev::p2p::P2PInterface> m_service;
+    TransactionsHandler m_transactionsHandler;
 };
 
 }  // namespace dev
@@ -170,9 +170,10 @@ void ChannelSession::startRead()
             std::lock_guard<std::recursive_mutex> lock(_mutex);
 
             auto session = shared_from_this();
+            auto space = _recvBuffer.prepare();
             if (_enableSSL)
             {
-                _sslSocket->async_read_some(boost::asio::buffer(_recvBuffer, bufferLength),
+                _sslSocket->async_read_some(boost::asio::buffer(space.data(), space.size()),
                     [session](const boost::system::error_code& error, size_t bytesTransferred) {
                         auto s = session;
                         if (s)
@@ -184,7 +185,7 @@ void ChannelSession::startRead()
             else
             {
                 _sslSocket->next_layer().async_read_some(
-                    boost::asio::buffer(_recvBuffer, bufferLength),
+                    boost::asio::buffer(space.data(), space.size()),
                     [session](const boost::system::error_code& error, size_t bytesTransferred) {
                         auto s = session;
                         if (s)
@@ -223,15 +224,14 @@ void ChannelSession::onRead(const boost::system::error_code& error, size_t bytes
         {
             CHANNEL_LOG(TRACE) << "Read: " << bytesTransferred;
 
-            _recvProtocolBuffer.insert(
-                _recvProtocolBuffer.end(), _recvBuffer, _recvBuffer + bytesTransferred);
+            _recvBuffer.commit(bytesTransferred);
 
             while (true)
             {
                 auto message = _messageFactory->buildMessage();
 
-                ssize_t result =
-                    message->decode(_recvProtocolBuffer.data(), _recvProtocolBuffer.size());
+                auto data = _recvBuffer.data();
+                ssize_t result = message->decode(data.data(), data.size());
 
                 if (result > 0)
                 {
@@ -239,8 +239,7 @@ void ChannelSession::onRead(const boost::system::error_code& error, size_t bytes
 
                     onMessage(ChannelException(0, ""), message);
 
-                    _recvProtocolBuffer.erase(
-                        _recvProtocolBuffer.begin(), _recvProtocolBuffer.begin() + result);
+                    _recvBuffer.consume(result);
                 }
                 else if (result == 0)
                 {
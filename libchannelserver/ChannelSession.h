@@ -31,6 +31,7 @@
 
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ReceiveBuffer.h>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio/ssl/stream.hpp>
@@ -53,7 +54,8 @@ public:
     typedef std::function<void(dev::channel::ChannelException, dev::channel::Message::Ptr)>
         CallbackType;
 
-    const size_t bufferLength = 1024;
+    /// a read asks for that many bytes at least, the size of a TLS record
+    static const size_t bufferLength = 16 * 1024;
 
     virtual Message::Ptr sendMessage(Message::Ptr request, size_t timeout = 0);
     virtual void asyncSendMessage(Message::Ptr request,
@@ -132,8 +134,7 @@ private:
     std::string _host;
     int _port = 0;
 
-    byte _recvBuffer[1024];
-    bytes _recvProtocolBuffer;
+    ReceiveBuffer _recvBuffer{bufferLength};
 
     std::queue<std::shared_ptr<bytes> > _sendBufferList;
     bool _writing = false;
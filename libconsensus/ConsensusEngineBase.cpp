@@ -94,14 +94,18 @@ void ConsensusEngineBase::checkBlockValid(Block const& block)
                           << std::endl;
         BOOST_THROW_EXCEPTION(ExistedBlock() << errinfo_comment("Block Already Existed, drop now"));
     }
+    /// the parent may be the latest block reaching consensus, which is still being committed
+    auto committing = committingBlocks();
+    bool committingParent = !committing.empty() &&
+                            committing.back()->header().hash() == block.blockHeader().parentHash();
     /// check the existence of the parent block (Must exist)
-    if (!blockExists(block.blockHeader().parentHash()))
+    if (!committingParent && !blockExists(block.blockHeader().parentHash()))
     {
         ENGINE_LOG(DEBUG) << "[#checkBlockValid] Parent doesn't exist: [hash]:  " << block_hash
                           << std::endl;
         BOOST_THROW_EXCEPTION(ParentNoneExist() << errinfo_comment("Parent Block Doesn't Exist"));
     }
-    if (block.blockHeader().number() > 1)
+    if (!committingParent && block.blockHeader().number() > 1)
     {
         if (m_blockChain->numberHash(block.blockHeader().number() - 1) !=
             block.blockHeader().parentHash())
@@ -57,6 +57,8 @@ public:
     virtual IDXTYPE nodeIdx() const = 0;
     /// update the context of PBFT after commit a block into the block-chain
     virtual void reportBlock(dev::eth::Block const& block) = 0;
+    /// blocks which have reached consensus and are still being committed, oldest first
+    virtual std::vector<std::shared_ptr<dev::eth::Block>> committingBlocks() const { return {}; }
 };
 }  // namespace consensus
 }  // namespace dev
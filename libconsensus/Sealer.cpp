@@ -157,12 +157,31 @@ void Sealer::resetSealingBlock(Sealing& sealing)
 {
     resetBlock(sealing.block);
     sealing.m_transactionSet.clear();
+    /// the transactions of the blocks being committed are still in the txpool
+    for (auto const& block : m_consensusEngine->committingBlocks())
+    {
+        for (auto const& tx : block->transactions())
+        {
+            sealing.m_transactionSet.insert(tx.sha3());
+        }
+    }
     sealing.p_execContext = nullptr;
 }
 
 void Sealer::resetBlock(Block& block)
 {
-    block.resetCurrentBlock(m_blockChain->getBlockByNumber(m_blockChain->number())->header());
+    BlockHeader parent = sealingParent();
+    block.resetCurrentBlock(parent);
+}
+
+BlockHeader Sealer::sealingParent()
+{
+    auto committing = m_consensusEngine->committingBlocks();
+    if (!committing.empty())
+    {
+        return committing.back()->header();
+    }
+    return m_blockChain->getBlockByNumber(m_blockChain->number())->header();
 }
 
 void Sealer::resetSealingHeader(BlockHeader& header)
@@ -100,7 +100,7 @@ public:
     bool inline shouldResetSealing()
     {
         return (m_sealing.block.isSealed() ||
-                m_sealing.block.blockHeader().number() <= m_blockChain->number());
+                m_sealing.block.blockHeader().number() <= sealingParent().number());
     }
     /// return the pointer of ConsensusInterface to access common interfaces
     std::shared_ptr<dev::consensus::ConsensusInterface> const consensusEngine()
@@ -141,11 +141,13 @@ protected:
     void resetSealingBlock(Sealing& sealing);
     void resetBlock(dev::eth::Block& block);
     void resetSealingHeader(dev::eth::BlockHeader& header);
+    /// the block the sealing block is built on: the latest block reaching consensus, which may
+    /// still be being committed
+    dev::eth::BlockHeader sealingParent();
     /// reset timestamp of block header
     void resetCurrentTime()
     {
-        uint64_t parentTime =
-            m_blockChain->getBlockByNumber(m_blockChain->number())->header().timestamp();
+        uint64_t parentTime = sealingParent().timestamp();
         m_sealing.block.header().setTimestamp(std::max(parentTime + 1, utcTime()));
     }
 
@@ -48,6 +48,11 @@ enum PBFTPacketType : byte
     SignReqPacket = 0x01,
     CommitReqPacket = 0x02,
     ViewChangeReqPacket = 0x03,
+    /// PrepareReq whose block is a CompactBlock
+    CompactPrepareReqPacket = 0x04,
+    /// ask the sender of a CompactPrepareReqPacket for the transactions missing from the txpool
+    GetMissingTxsPacket = 0x05,
+    MissingTxsPacket = 0x06,
     PBFTPacketCount
 };
 
@@ -371,6 +376,40 @@ struct PrepareReq : public PBFTMsg
     }
 };
 
+/// the block of a PrepareReq with the hashes of its transactions in place of the transactions,
+/// the receivers take the transactions from their txpool
+struct CompactBlock
+{
+    dev::eth::BlockHeader header;
+    h256s txHashes;
+
+    CompactBlock() = default;
+    explicit CompactBlock(dev::eth::Block const& _block) : header(_block.blockHeader())
+    {
+        for (auto const& tx : _block.transactions())
+        {
+            txHashes.push_back(tx.sha3());
+        }
+    }
+
+    void encode(bytes& _out) const
+    {
+        bytes headerData;
+        header.encode(headerData);
+        RLPStream s;
+        s.appendList(2);
+        s.appendRaw(headerData);
+        s.appendVector(txHashes);
+        s.swapOut(_out);
+    }
+    void decode(bytesConstRef _data)
+    {
+        RLP rlp(_data);
+        header.populate(rlp[0]);
+        txHashes = rlp[1].toVector<h256>();
+    }
+};
+
 /// signature request
 struct SignReq : public PBFTMsg
 {
@@ -27,6 +27,7 @@
 #include <libdevcore/Worker.h>
 #include <libethcore/CommonJS.h>
 #include <libstorage/Storage.h>
+#include <atomic>
 using namespace dev::eth;
 using namespace dev::db;
 using namespace dev::blockverifier;
@@ -47,6 +48,35 @@ void PBFTEngine::start()
     PBFTENGINE_LOG(INFO) << "[#Start PBFTEngine...]";
 }
 
+void PBFTEngine::stop()
+{
+    ConsensusEngineBase::stop();
+    /// the blocks reaching consensus are committed before stopping
+    std::unique_lock<std::mutex> l(x_committingBlocks);
+    m_committed.wait(l, [this]() { return m_committingBlocks.empty(); });
+}
+
+void PBFTEngine::setPipelineDepth(size_t _depth)
+{
+    m_pipelineDepth = _depth;
+    if (m_pipelineDepth > 0 && !m_committer)
+    {
+        m_committer = std::make_shared<dev::ThreadPool>("PBFTCommit", 1);
+    }
+    PBFTENGINE_LOG(INFO) << "[#setPipelineDepth] [depth]: " << m_pipelineDepth;
+}
+
+std::vector<std::shared_ptr<Block>> PBFTEngine::committingBlocks() const
+{
+    std::vector<std::shared_ptr<Block>> blocks;
+    Guard l(x_committingBlocks);
+    for (auto const& committing : m_committingBlocks)
+    {
+        blocks.push_back(committing->block);
+    }
+    return blocks;
+}
+
 void PBFTEngine::initPBFTEnv(unsigned view_timeout)
 {
     Guard l(m_mutex);
@@ -217,11 +247,34 @@ void PBFTEngine::backupMsg(std::string const& _key, PBFTMsg const& _msg)
 bool PBFTEngine::generatePrepare(Block const& block)
 {
     Guard l(m_mutex);
+    /// the block was sealed before the highest block reached consensus
+    if (block.blockHeader().number() != m_consensusBlockNumber)
+    {
+        PBFTENGINE_LOG(DEBUG) << "[#generateLocalPrepare] Stale block: [number/consNum]:  "
+                              << block.blockHeader().number() << "/" << m_consensusBlockNumber;
+        return false;
+    }
     PrepareReq prepare_req(block, m_keyPair, m_view, m_idx);
     bytes prepare_data;
-    prepare_req.encode(prepare_data);
+    unsigned packetType = PrepareReqPacket;
+    /// the sealed block has no receipts yet, the transactions are all the receivers need to
+    /// rebuild it
+    if (m_compactPrepare && block.getTransactionSize() > 0 && block.transactionReceipts().empty())
+    {
+        bytes compactBlock;
+        CompactBlock(block).encode(compactBlock);
+        /// the signatures of the prepareReq don't cover the block
+        std::swap(prepare_req.block, compactBlock);
+        prepare_req.encode(prepare_data);
+        std::swap(prepare_req.block, compactBlock);
+        packetType = CompactPrepareReqPacket;
+    }
+    else
+    {
+        prepare_req.encode(prepare_data);
+    }
     /// broadcast the generated preparePacket
-    bool succ = broadcastMsg(PrepareReqPacket, prepare_req.uniqueKey(), ref(prepare_data));
+    bool succ = broadcastMsg(packetType, prepare_req.uniqueKey(), ref(prepare_data));
     if (succ)
     {
         if (block.getTransactionSize() == 0 && m_omitEmptyBlock)
@@ -275,7 +328,7 @@ bool PBFTEngine::checkSign(PBFTMsg const& req) const
     if (getNodeIDByIndex(node_id, req.idx))
     {
         Public pub_id = jsToPublic(toJS(node_id.hex()));
-        return dev::verify(pub_id, req.sig, req.block_hash) &&
+        return verifyBlockSign(req.block_hash, pub_id, req.sig) &&
                dev::verify(pub_id, req.sig2, req.fieldsWithoutBlock());
     }
     return false;
@@ -387,6 +440,7 @@ bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key
 {
     auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
     m_connectedNode = sessions.size();
+    NodeIDs nodeIDsToSend;
     for (auto session : sessions)
     {
         /// get node index of the miner from m_minerList failed ?
@@ -405,11 +459,15 @@ bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key
                               << nodeIdx() << "/" << m_keyPair.pub().abridged() << "/"
                               << session.nodeID.abridged() << "/" << session.nodeIPEndpoint.name()
                               << "/" << packetType << "/" << (ttl == 0 ? maxTTL : ttl);
-        /// send messages
-        m_service->asyncSendMessageByNodeID(
-            session.nodeID, transDataToMessage(data, packetType, ttl), nullptr);
+        nodeIDsToSend.push_back(session.nodeID);
         broadcastMark(session.nodeID, packetType, key);
     }
+    /// send messages, the packet is encoded once and shared by all the sessions
+    if (!nodeIDsToSend.empty())
+    {
+        m_service->asyncMulticastMessageByNodeIDList(
+            nodeIDsToSend, transDataToMessage(data, packetType, ttl));
+    }
     return true;
 }
 
@@ -486,6 +544,86 @@ void PBFTEngine::checkMinerList(Block const& block)
     }
 }
 
+/// verify the signature of the signer on the block hash, verified signatures are cached
+bool PBFTEngine::verifyBlockSign(
+    h256 const& blockHash, h512 const& signer, Signature const& sig) const
+{
+    if (m_sigCache->verified(blockHash, signer, sig))
+        return true;
+    if (!dev::verify(signer, sig, blockHash))
+        return false;
+    m_sigCache->insert(blockHash, signer, sig);
+    return true;
+}
+
+/**
+ * @brief: verify the sig-list of the block on m_sigVerifyPool
+ *         every signature must be valid and come from at least minValidNodes() distinct miners,
+ *         each miner signing once, the verification stops at the first invalid signature
+ */
+bool PBFTEngine::checkSigList(Block const& block)
+{
+    auto const& sig_list = block.sigList();
+    h256 blockHash = block.blockHeader().hash();
+    /// a repeated miner would only have one of its signatures verified
+    std::map<size_t, Signature> signs;
+    for (auto const& sign : sig_list)
+    {
+        if (sign.first >= m_minerList.size())
+        {
+            LOG(ERROR) << "[#checkBlock] invalid idx [idx/minerSize]: " << sign.first << "/"
+                       << m_minerList.size();
+            return false;
+        }
+        if (!signs.insert(std::make_pair(sign.first.convert_to<size_t>(), sign.second)).second)
+        {
+            LOG(ERROR) << "[#checkBlock] duplicate sign idx [idx]: " << sign.first;
+            return false;
+        }
+    }
+    std::vector<std::pair<size_t, Signature>> signList(signs.begin(), signs.end());
+    size_t minValid = minValidNodes();
+    if (signList.size() < minValid)
+    {
+        LOG(ERROR) << "[#checkBlock] insufficient distinct sign items [signNum/minValidSign]"
+                   << signList.size() << "/" << minValid;
+        return false;
+    }
+    std::atomic<bool> invalid(false);
+    auto verify = [&](size_t _worker, size_t _workerNum) {
+        for (size_t i = _worker; i < signList.size() && !invalid; i += _workerNum)
+        {
+            auto const& miner = m_minerList[signList[i].first];
+            bool valid = false;
+            try
+            {
+                valid = verifyBlockSign(blockHash, miner, signList[i].second);
+            }
+            catch (std::exception& e)
+            {
+                LOG(ERROR) << "[#checkBlock] verify sign failed [EINFO]: "
+                           << boost::diagnostic_information(e);
+            }
+            if (!valid)
+            {
+                invalid = true;
+                LOG(ERROR) << "[#checkBlock] invalid sign [idx/pub/hash]: " << signList[i].first
+                           << "/" << miner.abridged() << "/" << blockHash.abridged();
+            }
+        }
+    };
+    size_t workerNum = std::min((size_t)m_sigVerifyThreadNum, signList.size());
+    if (workerNum > 1)
+    {
+        m_sigVerifyPool->runAndWait(workerNum, [&](size_t _worker) { verify(_worker, workerNum); });
+    }
+    else
+    {
+        verify(0, 1);
+    }
+    return !invalid;
+}
+
 /// check Block sign
 bool PBFTEngine::checkBlock(Block const& block)
 {
@@ -515,23 +653,8 @@ bool PBFTEngine::checkBlock(Block const& block)
         return false;
     }
     /// check sign
-    for (auto sign : sig_list)
-    {
-        if (sign.first >= m_minerList.size())
-        {
-            LOG(ERROR) << "[#checkBlock] invalid idx [idx/minerSize]: " << sign.first << "/"
-                       << m_minerList.size();
-            return false;
-        }
-        if (!dev::verify(m_minerList[sign.first.convert_to<size_t>()], sign.second,
-                block.blockHeader().hash()))
-        {
-            LOG(ERROR) << "[#checkBlock] invalid sign [idx/pub/hash]: " << sign.first << "/"
-                       << m_minerList[sign.first.convert_to<size_t>()].abridged() << "/"
-                       << block.blockHeader().hash().abridged();
-            return false;
-        }
-    }  /// end of check sign
+    if (!checkSigList(block))
+        return false;
 
     /// Check whether the number of transactions in block exceeds the limit
     std::string ret =
@@ -553,8 +676,31 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
                           << "/" << working_block.header().hash().abridged() << "/" << req.idx;
     checkBlockValid(working_block);
     m_blockSync->noteSealingBlockNumber(working_block.header().number());
-    sealing.p_execContext = executeBlock(working_block);
+    std::shared_ptr<CommittingBlock> parent;
+    {
+        Guard l(x_committingBlocks);
+        if (!m_committingBlocks.empty() && m_committingBlocks.back()->block->header().hash() ==
+                                               working_block.header().parentHash())
+        {
+            parent = m_committingBlocks.back();
+        }
+    }
+    if (parent)
+    {
+        /// the parent is still being committed, execute on its state
+        auto const& header = parent->block->header();
+        BlockInfo parentBlockInfo{header.hash(), header.number(), header.stateRoot()};
+        sealing.p_execContext =
+            m_blockVerifier->executeBlock(working_block, parentBlockInfo, parent->state);
+    }
+    else
+    {
+        sealing.p_execContext = executeBlock(working_block);
+    }
     sealing.block = working_block;
+    m_executedHash = req.block_hash;
+    m_executedAt = utcTime();
+    m_execTime = m_executedAt - start_exec_time;
     m_timeManager.updateTimeAfterHandleBlock(sealing.block.getTransactionSize(), start_exec_time);
 }
 
@@ -595,7 +741,7 @@ void PBFTEngine::onRecvPBFTMessage(
     bool valid = decodeToRequests(pbft_msg, message, session);
     if (!valid)
         return;
-    if (pbft_msg.packet_id <= ViewChangeReqPacket)
+    if (pbft_msg.packet_id < PBFTPacketCount)
     {
         m_msgQueue.push(pbft_msg);
     }
@@ -682,6 +828,246 @@ void PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
                           << "  [INFO]:  " << oss.str();
 }
 
+bool PBFTEngine::handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg)
+{
+    bool valid = decodeToRequests(prepareReq, ref(pbftMsg.data));
+    if (!valid || m_reqCache->isExistPrepare(prepareReq))
+        return false;
+    if (m_pendingCompactPrepare && m_pendingCompactPrepare->req.block_hash == prepareReq.block_hash)
+    {
+        /// another forwarder to fetch the missing transactions from if the others don't answer
+        auto& sources = m_pendingCompactPrepare->sources;
+        if (std::find(sources.begin(), sources.end(), pbftMsg.node_id) == sources.end())
+        {
+            sources.push_back(pbftMsg.node_id);
+        }
+        return false;
+    }
+    auto pending = std::make_shared<PendingCompactPrepare>();
+    try
+    {
+        pending->block.decode(ref(prepareReq.block));
+    }
+    catch (std::exception& e)
+    {
+        PBFTENGINE_LOG(DEBUG) << "[#handleCompactPrepareMsg] Invalid compact block [from/EINFO]: "
+                              << pbftMsg.endpoint << "/" << e.what();
+        return false;
+    }
+    if (pending->block.header.hash() != prepareReq.block_hash)
+    {
+        PBFTENGINE_LOG(DEBUG) << "[#handleCompactPrepareMsg] Invalid block hash [from/hash]: "
+                              << pbftMsg.endpoint << "/" << prepareReq.block_hash.abridged();
+        return false;
+    }
+    auto const& txHashes = pending->block.txHashes;
+    pending->transactions.resize(txHashes.size());
+    for (unsigned i = 0; i < txHashes.size(); ++i)
+    {
+        auto tx = m_txPool->transactionInPool(txHashes[i]);
+        if (tx)
+        {
+            pending->transactions[i] = *tx;
+        }
+        else
+        {
+            pending->missing.push_back(i);
+        }
+    }
+    pending->req = prepareReq;
+    pending->packet = pbftMsg;
+    if (pending->missing.empty())
+    {
+        rebuildPrepare(*pending);
+        return true;
+    }
+    /// don't fetch the transactions of a forged prepareReq
+    if (!checkSign(prepareReq))
+    {
+        PBFTENGINE_LOG(TRACE) << "[#handleCompactPrepareMsg] Invalid sig [from/hash]: "
+                              << pbftMsg.endpoint << "/" << prepareReq.block_hash.abridged();
+        return false;
+    }
+    pending->sources.push_back(pbftMsg.node_id);
+    h512 leader = getMinerByIndex(prepareReq.idx);
+    if (leader != h512() && leader != pbftMsg.node_id)
+    {
+        pending->sources.push_back(leader);
+    }
+    PBFTENGINE_LOG(DEBUG) << "[#handleCompactPrepareMsg] Fetch missing transactions "
+                             "[myIdx/number/hash/txs/missing/from]: "
+                          << nodeIdx() << "/" << prepareReq.height << "/"
+                          << prepareReq.block_hash.abridged() << "/" << txHashes.size() << "/"
+                          << pending->missing.size() << "/" << pbftMsg.endpoint;
+    requestMissingTxs(*pending);
+    m_pendingCompactPrepare = pending;
+    return false;
+}
+
+void PBFTEngine::requestMissingTxs(PendingCompactPrepare& pending)
+{
+    RLPStream request;
+    request.appendList(2) << pending.req.block_hash;
+    request.appendVector(pending.missing);
+    m_service->asyncSendMessageByNodeID(pending.sources[pending.requested],
+        transDataToMessage(ref(request.out()), GetMissingTxsPacket, 1), nullptr);
+    ++pending.requested;
+    pending.requestTime = utcTime();
+}
+
+void PBFTEngine::checkPendingCompactPrepare()
+{
+    auto pending = m_pendingCompactPrepare;
+    if (!pending || utcTime() - pending->requestTime < c_missingTxsTimeout)
+    {
+        return;
+    }
+    if (pending->req.height <= m_highestBlock.number() ||
+        pending->requested >= pending->sources.size())
+    {
+        /// the block is committed already, or left to the view change or block sync
+        PBFTENGINE_LOG(WARNING) << "[#checkPendingCompactPrepare] Give up the compact prepare "
+                                   "[myIdx/number/hash/requested]: "
+                                << nodeIdx() << "/" << pending->req.height << "/"
+                                << pending->req.block_hash.abridged() << "/" << pending->requested;
+        m_pendingCompactPrepare.reset();
+        return;
+    }
+    PBFTENGINE_LOG(DEBUG) << "[#checkPendingCompactPrepare] Fetch missing transactions again "
+                             "[myIdx/number/hash/missing/requested]: "
+                          << nodeIdx() << "/" << pending->req.height << "/"
+                          << pending->req.block_hash.abridged() << "/" << pending->missing.size()
+                          << "/" << pending->requested;
+    requestMissingTxs(*pending);
+}
+
+/// answer with the requested transactions of the full block of a prepareReq handled by this node
+void PBFTEngine::handleGetMissingTxsMsg(PBFTMsgPacket const& pbftMsg)
+{
+    try
+    {
+        RLP request(ref(pbftMsg.data));
+        h256 blockHash = request[0].toHash<h256>();
+        auto indexes = request[1].toVector<unsigned>();
+        PrepareReq const* prepareReq = nullptr;
+        if (m_reqCache->rawPrepareCache().block_hash == blockHash)
+        {
+            prepareReq = &m_reqCache->rawPrepareCache();
+        }
+        else if (m_reqCache->futurePrepareCache().block_hash == blockHash)
+        {
+            prepareReq = &m_reqCache->futurePrepareCache();
+        }
+        if (!prepareReq || prepareReq->block.empty())
+        {
+            PBFTENGINE_LOG(DEBUG) << "[#handleGetMissingTxsMsg] Unknown block [from/hash]: "
+                                  << pbftMsg.endpoint << "/" << blockHash.abridged();
+            return;
+        }
+        /// copy the encoded transactions without decoding the block
+        RLP transactions = BlockHeader::extractBlock(ref(prepareReq->block))[1];
+        /// each transaction at most once and in order, answered in a single pass over the block
+        bool ordered = indexes.size() <= transactions.itemCount();
+        for (size_t i = 1; ordered && i < indexes.size(); ++i)
+        {
+            ordered = indexes[i - 1] < indexes[i];
+        }
+        if (!ordered)
+        {
+            PBFTENGINE_LOG(DEBUG) << "[#handleGetMissingTxsMsg] Invalid indexes [from/hash/size]: "
+                                  << pbftMsg.endpoint << "/" << blockHash.abridged() << "/"
+                                  << indexes.size();
+            return;
+        }
+        RLPStream response;
+        response.appendList(2) << blockHash;
+        response.appendList(indexes.size());
+        auto index = indexes.begin();
+        unsigned position = 0;
+        size_t responseSize = 0;
+        for (auto it = transactions.begin(); it != transactions.end() && index != indexes.end();
+             ++it, ++position)
+        {
+            if (position != *index)
+            {
+                continue;
+            }
+            bytesConstRef transaction = (*it).data();
+            responseSize += transaction.size();
+            if (responseSize > c_maxMissingTxsSize)
+            {
+                PBFTENGINE_LOG(DEBUG)
+                    << "[#handleGetMissingTxsMsg] Response too large [from/hash/size]: "
+                    << pbftMsg.endpoint << "/" << blockHash.abridged() << "/" << indexes.size();
+                return;
+            }
+            response.appendRaw(transaction);
+            ++index;
+        }
+        if (index != indexes.end())
+        {
+            return;
+        }
+        m_service->asyncSendMessageByNodeID(pbftMsg.node_id,
+            transDataToMessage(ref(response.out()), MissingTxsPacket, 1), nullptr);
+    }
+    catch (std::exception& e)
+    {
+        PBFTENGINE_LOG(DEBUG) << "[#handleGetMissingTxsMsg] Invalid request [from/EINFO]: "
+                              << pbftMsg.endpoint << "/" << e.what();
+    }
+}
+
+void PBFTEngine::handleMissingTxsMsg(PBFTMsgPacket const& pbftMsg)
+{
+    auto pending = m_pendingCompactPrepare;
+    if (!pending)
+        return;
+    try
+    {
+        RLP response(ref(pbftMsg.data));
+        if (response[0].toHash<h256>() != pending->req.block_hash ||
+            response[1].itemCount() != pending->missing.size())
+        {
+            return;
+        }
+        for (unsigned i = 0; i < pending->missing.size(); ++i)
+        {
+            unsigned index = pending->missing[i];
+            Transaction tx;
+            tx.decode(response[1][i]);
+            if (tx.sha3() != pending->block.txHashes[index])
+            {
+                PBFTENGINE_LOG(DEBUG) << "[#handleMissingTxsMsg] Wrong transaction [from/hash]: "
+                                      << pbftMsg.endpoint << "/" << tx.sha3().abridged();
+                return;
+            }
+            pending->transactions[index] = tx;
+        }
+    }
+    catch (std::exception& e)
+    {
+        PBFTENGINE_LOG(DEBUG) << "[#handleMissingTxsMsg] Invalid response [from/EINFO]: "
+                              << pbftMsg.endpoint << "/" << e.what();
+        return;
+    }
+    m_pendingCompactPrepare.reset();
+    rebuildPrepare(*pending);
+    /// forwarded with the ttl it had when received, as a compact prepareReq rebuilt at once is
+    forwardMsg(pending->packet, pending->req, pending->req.uniqueKey());
+}
+
+/// the rebuilt block is encoded as the leader encoded it, so the prepareReq is the one it sent
+void PBFTEngine::rebuildPrepare(PendingCompactPrepare& pending)
+{
+    Block block;
+    block.setBlockHeader(pending.block.header);
+    block.setTransactions(pending.transactions);
+    pending.req.block.clear();
+    block.encode(pending.req.block);
+    handlePrepareMsg(pending.req, pending.packet.endpoint);
+}
+
 
 void PBFTEngine::checkAndCommit()
 {
@@ -754,9 +1140,25 @@ void PBFTEngine::checkAndSave()
         {
             Block block(m_reqCache->prepareCache().block);
             m_reqCache->generateAndSetSigList(block, minValidNodes());
+            auto context =
+                std::shared_ptr<ExecutiveContext>(m_reqCache->prepareCache().p_execContext);
+            if (m_pipelineDepth > 0)
+            {
+                auto mode = commitInBackground(block, context);
+                if (mode == PipelineCommit::Deferred)
+                {
+                    return;
+                }
+                if (mode == PipelineCommit::Background)
+                {
+                    updateHighestBlock(block);
+                    m_blockSync->noteSealingBlockNumber(block.blockHeader().number());
+                    m_blockDecided = true;
+                    return;
+                }
+            }
             /// callback block chain to commit block
-            CommitResult ret = m_blockChain->commitBlock(
-                block, std::shared_ptr<ExecutiveContext>(m_reqCache->prepareCache().p_execContext));
+            CommitResult ret = m_blockChain->commitBlock(block, context);
             /// drop handled transactions
             if (ret == CommitResult::OK)
             {
@@ -794,6 +1196,152 @@ void PBFTEngine::checkAndSave()
     }
 }
 
+PBFTEngine::PipelineCommit PBFTEngine::commitInBackground(
+    Block const& block, ExecutiveContext::Ptr const& context)
+{
+    auto state = context->getMemoryTableFactory()->chainedStorage(
+        block.blockHeader().hash(), block.blockHeader().number());
+    Guard l(x_committingBlocks);
+    if (m_pipelineFailed)
+    {
+        return PipelineCommit::Synchronous;
+    }
+    if (state->written(SYS_MINERS) || state->written(SYS_CONFIG))
+    {
+        /// the miner list and the system configs of the next block are read from the chain
+        if (m_committingBlocks.empty())
+        {
+            return PipelineCommit::Synchronous;
+        }
+        m_deferredCommit = true;
+        return PipelineCommit::Deferred;
+    }
+    auto committing = std::make_shared<CommittingBlock>();
+    committing->block = std::make_shared<Block>(block);
+    committing->context = context;
+    committing->state = state;
+    committing->decideTime = utcTime();
+    if (m_executedHash == block.blockHeader().hash())
+    {
+        committing->execTime = m_execTime;
+        committing->consensusTime = committing->decideTime - m_executedAt;
+    }
+    m_committingBlocks.push_back(committing);
+    m_committer->enqueue([this, committing]() { commitBlock(committing); });
+    return PipelineCommit::Background;
+}
+
+bool PBFTEngine::waitForCommitter()
+{
+    if (m_pipelineDepth == 0)
+    {
+        return true;
+    }
+    bool drained = false;
+    {
+        std::unique_lock<std::mutex> l(x_committingBlocks);
+        bool ready = m_committed.wait_for(l, std::chrono::milliseconds(c_PopWaitSeconds), [this]() {
+            return m_pipelineFailed ||
+                   m_committingBlocks.size() < (m_deferredCommit ? 1 : m_pipelineDepth);
+        });
+        if (!ready)
+        {
+            return false;
+        }
+        drained = m_deferredCommit && !m_pipelineFailed;
+    }
+    if (drained)
+    {
+        /// commit the deferred block, its prepareReq and the commitReqs are still cached
+        Guard l(m_mutex);
+        m_deferredCommit = false;
+        checkAndSave();
+    }
+    return true;
+}
+
+/// runs in the committer, without m_mutex
+void PBFTEngine::commitBlock(std::shared_ptr<CommittingBlock> committing)
+{
+    {
+        Guard l(x_committingBlocks);
+        /// dropped since a block before it failed to be committed
+        if (m_committingBlocks.empty() || m_committingBlocks.front() != committing)
+        {
+            return;
+        }
+    }
+    auto startTime = utcTime();
+    Block const& block = *committing->block;
+    CommitResult ret = m_blockChain->commitBlock(*committing->block, committing->context);
+    /// the block may have been downloaded and committed by the sync meanwhile
+    if (ret != CommitResult::OK &&
+        m_blockChain->numberHash(block.blockHeader().number()) == block.blockHeader().hash())
+    {
+        ret = CommitResult::OK;
+    }
+    if (ret == CommitResult::OK)
+    {
+        dropHandledTransactions(block);
+        committing->state->release();
+        PBFTENGINE_LOG(DEBUG)
+            << "[#CommitBlock Succ:] [myIdx/myNode/number/hash/execTime/consensusTime/commitTime/"
+               "queueTime]:  "
+            << nodeIdx() << "/" << m_keyPair.pub().abridged() << "/"
+            << block.blockHeader().number() << "/" << block.blockHeader().hash().abridged() << "/"
+            << committing->execTime << "/" << committing->consensusTime << "/"
+            << utcTime() - startTime << "/" << startTime - committing->decideTime;
+    }
+    else
+    {
+        PBFTENGINE_LOG(ERROR) << "[#commitBlock Failed] [myIdx/myNode/number/hash]:  " << nodeIdx()
+                              << "/" << m_keyPair.pub().abridged() << "/"
+                              << block.blockHeader().number() << "/"
+                              << block.blockHeader().hash().abridged();
+        m_txPool->handleBadBlock(block);
+        m_pipelineFailed = true;
+    }
+    {
+        Guard l(x_committingBlocks);
+        if (ret == CommitResult::OK)
+        {
+            m_committingBlocks.pop_front();
+        }
+        else
+        {
+            /// the blocks behind were executed on the state of the failed one
+            m_committingBlocks.clear();
+        }
+    }
+    m_committed.notify_all();
+    m_signalled.notify_all();
+}
+
+/// the blocks reached consensus after the block failed to be committed are dropped, go back to
+/// the chain and sync the blocks
+void PBFTEngine::handlePipelineFailure()
+{
+    if (!m_pipelineFailed)
+    {
+        return;
+    }
+    {
+        Guard l(m_mutex);
+        m_pipelineFailed = false;
+        m_deferredCommit = false;
+        auto head = m_blockChain->getBlockByNumber(m_blockChain->number());
+        m_highestBlock = head->header();
+        m_consensusBlockNumber = m_highestBlock.number() + 1;
+        resetConfig();
+        m_reqCache->clearAllExceptCommitCache();
+        m_blockSync->noteSealingBlockNumber(m_blockChain->number());
+        PBFTENGINE_LOG(WARNING) << "[#handlePipelineFailure] Back to the chain: [number/hash]:  "
+                                << m_highestBlock.number() << "/"
+                                << m_highestBlock.hash().abridged();
+    }
+    m_blockDecided = true;
+}
+
 /// update the context of PBFT after commit a block into the block-chain
 /// 1. update the highest to new-committed blockHeader
 /// 2. update m_view/m_toView/m_leaderFailed/m_lastConsensusTime/m_consensusBlockNumber
@@ -803,13 +1351,22 @@ void PBFTEngine::checkAndSave()
 void PBFTEngine::reportBlock(Block const& block)
 {
     Guard l(m_mutex);
-    if (m_blockChain->number() == 0 || m_highestBlock.number() < block.blockHeader().number())
+    updateHighestBlock(block);
+}
+
+void PBFTEngine::updateHighestBlock(Block const& block)
+{
+    /// the blocks committed in background are behind the highest block
+    if ((block.blockHeader().number() == 0 && m_highestBlock.number() == 0) ||
+        m_highestBlock.number() < block.blockHeader().number())
     {
         /// update the highest block
         m_highestBlock = block.blockHeader();
         if (m_highestBlock.number() >= m_consensusBlockNumber)
         {
+            m_consensusTime->observe(utcTime() - m_timeManager.m_lastConsensusTime);
             m_view = m_toView = 0;
+            m_viewGauge->set(0);
             m_leaderFailed = false;
             m_timeManager.m_lastConsensusTime = utcTime();
             m_timeManager.m_changeCycle = 0;
@@ -1006,8 +1563,10 @@ bool PBFTEngine::isValidViewChangeReq(
         return false;
     }
     /// check block hash
+    /// the highest block may be still being committed
     if ((req.height == m_highestBlock.number() && req.block_hash != m_highestBlock.hash()) ||
-        (m_blockChain->getBlockByHash(req.block_hash) == nullptr))
+        (req.block_hash != m_highestBlock.hash() &&
+            m_blockChain->getBlockByHash(req.block_hash) == nullptr))
     {
         PBFTENGINE_LOG(TRACE) << "[#InvalidViewChangeReq] Invalid hash [highHash]:  "
                               << m_highestBlock.hash().abridged() << " [INFO]:  " << oss.str();
@@ -1044,6 +1603,8 @@ void PBFTEngine::checkAndChangeView()
         m_leaderFailed = false;
         m_timeManager.m_lastConsensusTime = utcTime();
         m_view = m_toView;
+        m_viewGauge->set(m_view);
+        m_viewChangeCounter->add();
         m_reqCache->triggerViewChange(m_view);
         m_blockSync->noteSealingBlockNumber(m_blockChain->number());
     }
@@ -1109,6 +1670,24 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
         pbft_msg = prepare_req;
         break;
     }
+    case CompactPrepareReqPacket:
+    {
+        PrepareReq prepare_req;
+        /// only forwarded once rebuilt, so that the receivers can fetch the missing transactions
+        /// from this node
+        if (handleCompactPrepareMsg(prepare_req, pbftMsg))
+        {
+            key = prepare_req.uniqueKey();
+        }
+        pbft_msg = prepare_req;
+        break;
+    }
+    case GetMissingTxsPacket:
+        handleGetMissingTxsMsg(pbftMsg);
+        return;
+    case MissingTxsPacket:
+        handleMissingTxsMsg(pbftMsg);
+        return;
     case SignReqPacket:
     {
         SignReq req;
@@ -1141,7 +1720,12 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
         return;
     }
     }
+    forwardMsg(pbftMsg, pbft_msg, key);
+}
 
+void PBFTEngine::forwardMsg(
+    PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbft_msg, std::string const& key)
+{
     if (pbftMsg.ttl == 1)
         return;
     bool height_flag = (pbft_msg.height > m_highestBlock.number()) ||
@@ -1166,21 +1750,36 @@ void PBFTEngine::workLoop()
     {
         try
         {
-            std::pair<bool, PBFTMsgPacket> ret = m_msgQueue.tryPop(c_PopWaitSeconds);
-            if (ret.first)
+            /// the messages are left in the queue while the committer is behind
+            if (waitForCommitter())
             {
-                PBFTENGINE_LOG(TRACE)
-                    << "[#workLoop: handleMsg] [myIdx/myNode/type/idx]:  " << nodeIdx() << "/"
-                    << m_keyPair.pub().abridged() << "/" << std::to_string(ret.second.packet_id)
-                    << "/" << ret.second.node_idx << std::endl;
-                handleMsg(ret.second);
+                std::pair<bool, PBFTMsgPacket> ret = m_msgQueue.tryPop(c_PopWaitSeconds);
+                if (ret.first)
+                {
+                    PBFTENGINE_LOG(TRACE)
+                        << "[#workLoop: handleMsg] [myIdx/myNode/type/idx]:  " << nodeIdx() << "/"
+                        << m_keyPair.pub().abridged() << "/"
+                        << std::to_string(ret.second.packet_id) << "/" << ret.second.node_idx
+                        << std::endl;
+                    handleMsg(ret.second);
+                }
+                else
+                {
+                    std::unique_lock<std::mutex> l(x_signalled);
+                    m_signalled.wait_for(l, std::chrono::milliseconds(5));
+                }
             }
-            else
+            checkTimeout();
             {
-                std::unique_lock<std::mutex> l(x_signalled);
-                m_signalled.wait_for(l, std::chrono::milliseconds(5));
+                Guard l(m_mutex);
+                checkPendingCompactPrepare();
+            }
+            handlePipelineFailure();
+            /// outside m_mutex, the sealer locks the sealing block before calling the engine
+            if (m_blockDecided.exchange(false) && m_onBlockDecided)
+            {
+                m_onBlockDecided();
             }
-            checkTimeout();
             handleFutureBlock();
             collectGarbage();
         }
@@ -29,8 +29,15 @@
 #include <libconsensus/ConsensusEngineBase.h>
 #include <libdevcore/FileSystem.h>
 #include <libdevcore/LevelDB.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/concurrent_queue.h>
+#include <libstorage/ChainedStorage.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <sstream>
+#include <thread>
 
 #include <libp2p/P2PMessage.h>
 #include <libp2p/P2PSession.h>
@@ -68,6 +75,19 @@ public:
             m_protocolId, boost::bind(&PBFTEngine::onRecvPBFTMessage, this, _1, _2, _3));
         m_broadCastCache = std::make_shared<PBFTBroadcastCache>();
         m_reqCache = std::make_shared<PBFTReqCache>(m_protocolId);
+        m_sigCache = std::make_shared<PBFTSigCache>();
+        m_sigVerifyThreadNum = std::max(
+            1u, std::min(std::thread::hardware_concurrency(), (unsigned)c_maxSigVerifyThreads));
+        m_sigVerifyPool = std::make_shared<dev::ThreadPool>("pbftSigVerify", m_sigVerifyThreadNum);
+
+        std::string groupLabel = "group=\"" + std::to_string(m_groupId) + "\"";
+        m_viewGauge =
+            MetricsRegistry::instance().gauge("fisco_pbft_view", "the current view", groupLabel);
+        m_viewChangeCounter = MetricsRegistry::instance().counter(
+            "fisco_pbft_view_changes_total", "view changes reaching consensus", groupLabel);
+        m_consensusTime = MetricsRegistry::instance().histogram(
+            "fisco_pbft_consensus_milliseconds",
+            "time from the previous block to the commit of a block", groupLabel);
 
         /// register checkMinerList to blockSync for check MinerList
         m_blockSync->registerConsensusVerifyHandler(boost::bind(&PBFTEngine::checkBlock, this, _1));
@@ -87,6 +107,7 @@ public:
         return m_timeManager.m_intervalBlockTime;
     }
     void start() override;
+    void stop() override;
 
     virtual bool reachBlockIntervalTime()
     {
@@ -103,6 +124,8 @@ public:
     /// update the context of PBFT after commit a block into the block-chain
     void reportBlock(dev::eth::Block const& block) override;
     void onViewChange(std::function<void()> const& _f) { m_onViewChange = _f; }
+    /// called after a block reaching consensus is handed over to be committed in background
+    void onBlockDecided(std::function<void()> const& _f) { m_onBlockDecided = _f; }
     bool inline shouldReset(dev::eth::Block const& block)
     {
         return block.getTransactionSize() == 0 && m_omitEmptyBlock;
@@ -112,6 +135,12 @@ public:
     void setOmitEmptyBlock(bool setter) { m_omitEmptyBlock = setter; }
 
     void setMaxTTL(uint8_t const& ttl) { maxTTL = ttl; }
+    /// broadcast the blocks of prepareReq by the hashes of their transactions
+    void setCompactPrepare(bool _compactPrepare) { m_compactPrepare = _compactPrepare; }
+    /// commit up to _depth blocks reaching consensus in background, executing the next block on
+    /// their state meanwhile; 0 commits the blocks synchronously
+    void setPipelineDepth(size_t _depth);
+    std::vector<std::shared_ptr<dev::eth::Block>> committingBlocks() const override;
 
 protected:
     void workLoop() override;
@@ -149,6 +178,18 @@ protected:
     void handlePrepareMsg(PrepareReq const& prepare_req, std::string const& endpoint = "self");
     /// handler prepare messages
     void handlePrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg);
+    /// rebuild the block of a compact prepareReq from the txpool and handle it, the transactions
+    /// missing from the txpool are fetched from the sender first
+    /// @return true if the prepareReq has been rebuilt
+    bool handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg);
+    void handleGetMissingTxsMsg(PBFTMsgPacket const& pbftMsg);
+    void handleMissingTxsMsg(PBFTMsgPacket const& pbftMsg);
+    /// ask the next peer known to have the block of the pending compact prepareReq for its missing
+    /// transactions once the previous one didn't answer in time, give the prepareReq up when there
+    /// is none left
+    void checkPendingCompactPrepare();
+    /// forward a handled message to the peers other than its sender and generator
+    void forwardMsg(PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbft_msg, std::string const& key);
     /// 1. decode the network-received PBFTMsgPacket to signReq
     /// 2. check the validation of the signReq
     /// add the signReq to the cache and
@@ -425,7 +466,29 @@ protected:
     void checkMinerList(dev::eth::Block const& block);
     /// check block
     bool checkBlock(dev::eth::Block const& block);
+    /// verify the sig-list of the block in parallel, must be called with m_minerListMutex held
+    bool checkSigList(dev::eth::Block const& block);
+    bool verifyBlockSign(h256 const& blockHash, h512 const& signer, Signature const& sig) const;
     void execBlock(Sealing& sealing, PrepareReq const& req, std::ostringstream& oss);
+    /// update the context of PBFT to the new highest block, must be called with m_mutex held
+    void updateHighestBlock(dev::eth::Block const& block);
+    /// how a block reaching consensus is committed with the pipeline enabled
+    enum class PipelineCommit
+    {
+        /// handed over to the committer
+        Background,
+        /// committed synchronously once the blocks before it are, see waitForCommitter
+        Deferred,
+        Synchronous
+    };
+    /// hand the block over to the committer without waiting for it, must be called with m_mutex
+    /// held
+    PipelineCommit commitInBackground(dev::eth::Block const& block,
+        dev::blockverifier::ExecutiveContext::Ptr const& context);
+    /// the back-pressure of the pipeline, must be called without m_mutex so that the sealer and
+    /// the sync aren't blocked by a commit, false if the committer is still behind
+    bool waitForCommitter();
+    void handlePipelineFailure();
 
     void changeViewForEmptyBlock();
     virtual bool isDiskSpaceEnough(std::string const& path)
@@ -456,6 +519,12 @@ protected:
 
     std::shared_ptr<PBFTBroadcastCache> m_broadCastCache;
     std::shared_ptr<PBFTReqCache> m_reqCache;
+    /// verified block signatures
+    std::shared_ptr<PBFTSigCache> m_sigCache;
+    /// workers verifying the sig-list of blocks
+    std::shared_ptr<dev::ThreadPool> m_sigVerifyPool;
+    unsigned m_sigVerifyThreadNum;
+    static const unsigned c_maxSigVerifyThreads = 8;
     TimeManager m_timeManager;
     PBFTMsgQueue m_msgQueue;
     mutable Mutex m_mutex;
@@ -468,6 +537,63 @@ protected:
     bool m_emptyBlockViewChange = false;
 
     uint8_t maxTTL = MAXTTL;
+
+    bool m_compactPrepare = false;
+    /// the compact prepareReq waiting for the transactions missing from the txpool
+    struct PendingCompactPrepare
+    {
+        PrepareReq req;
+        /// the received packet, forwarded once the block is rebuilt
+        PBFTMsgPacket packet;
+        CompactBlock block;
+        dev::eth::Transactions transactions;
+        /// indexes of the missing transactions
+        std::vector<unsigned> missing;
+        /// the peers having the block, the sender first, then the leader and other forwarders
+        std::vector<h512> sources;
+        size_t requested = 0;
+        uint64_t requestTime = 0;
+    };
+    std::shared_ptr<PendingCompactPrepare> m_pendingCompactPrepare;
+    /// milliseconds to wait for the missing transactions before asking the next peer
+    static const unsigned c_missingTxsTimeout = 500;
+    /// bytes of transactions answered to a request, the full prepareReq is waited for beyond
+    static const size_t c_maxMissingTxsSize = 16 * 1024 * 1024;
+    void requestMissingTxs(PendingCompactPrepare& pending);
+    void rebuildPrepare(PendingCompactPrepare& pending);
+
+    /// a block reaching consensus which is being committed in background
+    struct CommittingBlock
+    {
+        std::shared_ptr<dev::eth::Block> block;
+        dev::blockverifier::ExecutiveContext::Ptr context;
+        /// the state after the block, for executing the next one
+        dev::storage::ChainedStorage::Ptr state;
+        /// milliseconds taken by execution and by consensus after the execution
+        uint64_t execTime;
+        uint64_t consensusTime;
+        uint64_t decideTime;
+    };
+    void commitBlock(std::shared_ptr<CommittingBlock> committing);
+    size_t m_pipelineDepth = 0;
+    std::deque<std::shared_ptr<CommittingBlock>> m_committingBlocks;
+    mutable Mutex x_committingBlocks;
+    std::condition_variable m_committed;
+    /// commits the blocks one by one in order
+    std::shared_ptr<dev::ThreadPool> m_committer;
+    std::atomic_bool m_pipelineFailed{false};
+    /// a block writing the system tables waits for the blocks before it to be committed
+    std::atomic_bool m_deferredCommit{false};
+    std::atomic_bool m_blockDecided{false};
+    std::function<void()> m_onBlockDecided;
+    /// the latest block executed and when
+    h256 m_executedHash;
+    uint64_t m_execTime = 0;
+    uint64_t m_executedAt = 0;
+
+    MetricGauge::Ptr m_viewGauge;
+    MetricCounter::Ptr m_viewChangeCounter;
+    MetricHistogram::Ptr m_consensusTime;
 };
 }  // namespace consensus
 }  // namespace dev
@@ -29,6 +29,8 @@
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/easylog.h>
+#include <libdevcrypto/Common.h>
+#include <deque>
 #include <unordered_map>
 namespace dev
 {
@@ -50,7 +52,9 @@ public:
     {
         switch (type)
         {
+        /// a compact prepare is the same prepare as the full one
         case PrepareReqPacket:
+        case CompactPrepareReqPacket:
             insertMessage(x_knownPrepare, m_knownPrepare, c_knownPrepare, key);
             return true;
         case SignReqPacket:
@@ -81,6 +85,7 @@ public:
         switch (type)
         {
         case PrepareReqPacket:
+        case CompactPrepareReqPacket:
             return exists(x_knownPrepare, m_knownPrepare, key);
         case SignReqPacket:
             return exists(x_knownSign, m_knownSign, key);
@@ -200,5 +205,43 @@ private:
     /// maps between node id and its broadcast cache
     std::unordered_map<h512, std::shared_ptr<PBFTMsgCache>> m_broadCastKeyCache;
 };
+/// cache of the (blockHash, signer) signatures that have been verified, shared by the consensus
+/// messages and the sig-list check of blocks received from sync
+class PBFTSigCache
+{
+public:
+    /// the signature of the given signer for the given block has been verified
+    inline bool verified(h256 const& blockHash, h512 const& signer, Signature const& sig)
+    {
+        Guard l(x_sigs);
+        auto block = m_sigs.find(blockHash);
+        if (block == m_sigs.end())
+            return false;
+        auto item = block->second.find(signer);
+        return item != block->second.end() && item->second == sig;
+    }
+
+    inline void insert(h256 const& blockHash, h512 const& signer, Signature const& sig)
+    {
+        Guard l(x_sigs);
+        if (!m_sigs.count(blockHash))
+        {
+            if (m_blocks.size() >= c_maxBlocks)
+            {
+                m_sigs.erase(m_blocks.front());
+                m_blocks.pop_front();
+            }
+            m_blocks.push_back(blockHash);
+        }
+        m_sigs[blockHash][signer] = sig;
+    }
+
+private:
+    Mutex x_sigs;
+    std::unordered_map<h256, std::unordered_map<h512, Signature>> m_sigs;
+    /// block hashes in insert order, the oldest is evicted first
+    std::deque<h256> m_blocks;
+    static const unsigned c_maxBlocks = 64;
+};
 }  // namespace consensus
 }  // namespace dev
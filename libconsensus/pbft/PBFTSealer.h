@@ -50,7 +50,7 @@ public:
         m_consensusEngine = std::make_shared<PBFTEngine>(_service, _txPool, _blockChain, _blockSync,
             _blockVerifier, _protocolId, _baseDir, _key_pair, _minerList);
         m_pbftEngine = std::dynamic_pointer_cast<PBFTEngine>(m_consensusEngine);
-        m_pbftEngine->onViewChange([this]() {
+        auto resetSealing = [this]() {
             DEV_WRITE_GUARDED(x_sealing)
             {
                 if (shouldResetSealing())
@@ -60,7 +60,10 @@ public:
                 m_signalled.notify_all();
                 m_blockSignalled.notify_all();
             }
-        });
+        };
+        m_pbftEngine->onViewChange(resetSealing);
+        /// seal the next block on the block reaching consensus without waiting for its commit
+        m_pbftEngine->onBlockDecided(resetSealing);
     }
     void start() override;
     void stop() override;
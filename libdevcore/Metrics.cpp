@@ -0,0 +1,195 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @file Metrics.cpp
+ * @date 2019-04-03
+ */
+
+#include "Metrics.h"
+#include <sstream>
+
+using namespace dev;
+
+const size_t MetricHistogram::BUCKETS;
+
+/// values below that are counted in buckets of their own
+static const uint64_t c_exactValues = 4;
+static const size_t c_subBucketBits = 2;
+
+void MetricHistogram::observe(uint64_t _value)
+{
+    m_buckets[bucketIndex(_value)]++;
+    m_count++;
+    m_sum += _value;
+}
+
+size_t MetricHistogram::bucketIndex(uint64_t _value)
+{
+    if (_value < c_exactValues)
+    {
+        return _value;
+    }
+    /// the power of two below the value, and the next bits below its highest bit
+    size_t exponent = 63 - __builtin_clzll(_value);
+    size_t subBucket = (_value >> (exponent - c_subBucketBits)) & ((1 << c_subBucketBits) - 1);
+    size_t index = c_exactValues + ((exponent - c_subBucketBits) << c_subBucketBits) + subBucket;
+    return std::min(index, BUCKETS - 1);
+}
+
+uint64_t MetricHistogram::bucketBound(size_t _index)
+{
+    if (_index < c_exactValues)
+    {
+        return _index;
+    }
+    size_t exponent = ((_index - c_exactValues) >> c_subBucketBits) + c_subBucketBits;
+    uint64_t subBucket = (_index - c_exactValues) & ((1 << c_subBucketBits) - 1);
+    return ((c_exactValues + subBucket + 1) << (exponent - c_subBucketBits)) - 1;
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry s_instance;
+    return s_instance;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(
+    std::string const& _name, std::string const& _help, Type _type)
+{
+    auto it = m_families.find(_name);
+    if (it == m_families.end())
+    {
+        Family newFamily;
+        newFamily.type = _type;
+        newFamily.help = _help;
+        it = m_families.insert(std::make_pair(_name, newFamily)).first;
+    }
+    else if (it->second.type != _type)
+    {
+        BOOST_THROW_EXCEPTION(MetricTypeMismatch() << errinfo_comment(_name));
+    }
+    return it->second;
+}
+
+MetricCounter::Ptr MetricsRegistry::counter(
+    std::string const& _name, std::string const& _help, std::string const& _labels)
+{
+    Guard l(x_families);
+    auto& metric = family(_name, _help, Type::Counter).counters[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<MetricCounter>();
+    }
+    return metric;
+}
+
+MetricGauge::Ptr MetricsRegistry::gauge(
+    std::string const& _name, std::string const& _help, std::string const& _labels)
+{
+    Guard l(x_families);
+    auto& metric = family(_name, _help, Type::Gauge).gauges[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<MetricGauge>();
+    }
+    return metric;
+}
+
+MetricHistogram::Ptr MetricsRegistry::histogram(
+    std::string const& _name, std::string const& _help, std::string const& _labels)
+{
+    Guard l(x_families);
+    auto& metric = family(_name, _help, Type::Histogram).histograms[_labels];
+    if (!metric)
+    {
+        metric = std::make_shared<MetricHistogram>();
+    }
+    return metric;
+}
+
+/// name{labels}, with _extra appended to the labels
+static std::string series(
+    std::string const& _name, std::string const& _labels, std::string const& _extra = "")
+{
+    std::string labels = _labels;
+    if (!_extra.empty())
+    {
+        labels += (labels.empty() ? "" : ",") + _extra;
+    }
+    return labels.empty() ? _name : _name + "{" + labels + "}";
+}
+
+std::string MetricsRegistry::exposition() const
+{
+    std::ostringstream out;
+    Guard l(x_families);
+    for (auto const& it : m_families)
+    {
+        auto const& name = it.first;
+        auto const& metrics = it.second;
+        out << "# HELP " << name << " " << metrics.help << "\n";
+        switch (metrics.type)
+        {
+        case Type::Counter:
+            out << "# TYPE " << name << " counter\n";
+            for (auto const& counter : metrics.counters)
+            {
+                out << series(name, counter.first) << " " << counter.second->value() << "\n";
+            }
+            break;
+        case Type::Gauge:
+            out << "# TYPE " << name << " gauge\n";
+            for (auto const& gauge : metrics.gauges)
+            {
+                out << series(name, gauge.first) << " " << gauge.second->value() << "\n";
+            }
+            break;
+        case Type::Histogram:
+            out << "# TYPE " << name << " histogram\n";
+            for (auto const& histogram : metrics.histograms)
+            {
+                /// read the count first, the buckets observed since then only add up to more
+                uint64_t count = histogram.second->count();
+                uint64_t sum = histogram.second->sum();
+                /// the buckets above the largest observed value are left out, they'd repeat the
+                /// count
+                size_t last = 0;
+                for (size_t i = 0; i < MetricHistogram::BUCKETS; ++i)
+                {
+                    if (histogram.second->bucketCount(i))
+                    {
+                        last = i;
+                    }
+                }
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i <= last && i < MetricHistogram::BUCKETS - 1; ++i)
+                {
+                    cumulative += histogram.second->bucketCount(i);
+                    out << series(name + "_bucket", histogram.first,
+                               "le=\"" + std::to_string(MetricHistogram::bucketBound(i)) + "\"")
+                        << " " << std::min(cumulative, count) << "\n";
+                }
+                out << series(name + "_bucket", histogram.first, "le=\"+Inf\"") << " " << count
+                    << "\n";
+                out << series(name + "_sum", histogram.first) << " " << sum << "\n";
+                out << series(name + "_count", histogram.first) << " " << count << "\n";
+            }
+            break;
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,149 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief: counters, gauges and histograms of the node internals, exported in the prometheus text
+ * format by MetricsServer
+ *
+ * @file Metrics.h
+ * @date 2019-04-03
+ */
+
+#pragma once
+#include "Exceptions.h"
+#include "Guards.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace dev
+{
+DEV_SIMPLE_EXCEPTION(MetricTypeMismatch);
+
+class MetricCounter
+{
+public:
+    typedef std::shared_ptr<MetricCounter> Ptr;
+
+    void add(uint64_t _value = 1) { m_value += _value; }
+    uint64_t value() const { return m_value; }
+
+private:
+    std::atomic<uint64_t> m_value = {0};
+};
+
+class MetricGauge
+{
+public:
+    typedef std::shared_ptr<MetricGauge> Ptr;
+
+    void set(int64_t _value) { m_value = _value; }
+    void add(int64_t _value = 1) { m_value += _value; }
+    void sub(int64_t _value = 1) { m_value -= _value; }
+    int64_t value() const { return m_value; }
+
+private:
+    std::atomic<int64_t> m_value = {0};
+};
+
+/// log-linear buckets like HdrHistogram: values below 4 are exact, every power of two above is
+/// split into 4 buckets, so a quantile is off by 25% at most
+class MetricHistogram
+{
+public:
+    typedef std::shared_ptr<MetricHistogram> Ptr;
+    /// values up to 2^40 have their own bucket, larger ones share the last
+    static const size_t BUCKETS = 4 + 38 * 4;
+
+    void observe(uint64_t _value);
+
+    uint64_t count() const { return m_count; }
+    uint64_t sum() const { return m_sum; }
+    uint64_t bucketCount(size_t _index) const { return m_buckets[_index]; }
+
+    static size_t bucketIndex(uint64_t _value);
+    /// the largest value in the bucket
+    static uint64_t bucketBound(size_t _index);
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+    std::atomic<uint64_t> m_count = {0};
+    std::atomic<uint64_t> m_sum = {0};
+};
+
+/// observes the microseconds from its construction to its destruction
+class ScopedMetricTimer
+{
+public:
+    explicit ScopedMetricTimer(MetricHistogram::Ptr _histogram)
+      : m_histogram(_histogram), m_start(std::chrono::steady_clock::now())
+    {}
+    ~ScopedMetricTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram->observe(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+private:
+    MetricHistogram::Ptr m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/// all the metrics of the node, registering takes a lock, updating a metric doesn't
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry& instance();
+
+    /// the metric named _name with _labels (e.g. group="1"), registered by the first call,
+    /// throws MetricTypeMismatch if _name is registered with another type
+    MetricCounter::Ptr counter(
+        std::string const& _name, std::string const& _help, std::string const& _labels = "");
+    MetricGauge::Ptr gauge(
+        std::string const& _name, std::string const& _help, std::string const& _labels = "");
+    MetricHistogram::Ptr histogram(
+        std::string const& _name, std::string const& _help, std::string const& _labels = "");
+
+    /// all the metrics in the prometheus text format
+    std::string exposition() const;
+
+private:
+    enum class Type
+    {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    struct Family
+    {
+        Type type;
+        std::string help;
+        std::map<std::string, MetricCounter::Ptr> counters;
+        std::map<std::string, MetricGauge::Ptr> gauges;
+        std::map<std::string, MetricHistogram::Ptr> histograms;
+    };
+
+    Family& family(std::string const& _name, std::string const& _help, Type _type);
+
+    std::map<std::string, Family> m_families;
+    mutable Mutex x_families;
+};
+
+}  // namespace dev
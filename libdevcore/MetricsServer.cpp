@@ -0,0 +1,98 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @file MetricsServer.cpp
+ * @date 2019-04-03
+ */
+
+#include "MetricsServer.h"
+#include "Metrics.h"
+#include "easylog.h"
+
+using namespace dev;
+namespace ba = boost::asio;
+namespace bi = boost::asio::ip;
+
+/// a request header longer than that isn't a scrape
+static const size_t c_maxRequestLength = 8192;
+
+MetricsServer::MetricsServer(std::string const& _listenIP, uint16_t _listenPort)
+  : m_listenIP(_listenIP), m_listenPort(_listenPort)
+{}
+
+void MetricsServer::start()
+{
+    m_acceptor = std::make_shared<bi::tcp::acceptor>(m_ioService,
+        bi::tcp::endpoint(bi::address::from_string(m_listenIP), m_listenPort));
+    accept();
+    m_thread = std::thread([this]() {
+        dev::pthread_setThreadName("metrics");
+        m_ioService.run();
+    });
+    LOG(INFO) << "[#MetricsServer] started [listenIP/listenPort]: " << m_listenIP << "/"
+              << m_listenPort;
+}
+
+void MetricsServer::stop()
+{
+    m_ioService.stop();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void MetricsServer::accept()
+{
+    auto socket = std::make_shared<bi::tcp::socket>(m_ioService);
+    m_acceptor->async_accept(*socket, [this, socket](boost::system::error_code const& _ec) {
+        if (!_ec)
+        {
+            serve(socket);
+        }
+        else if (_ec == ba::error::operation_aborted)
+        {
+            return;
+        }
+        accept();
+    });
+}
+
+void MetricsServer::serve(std::shared_ptr<bi::tcp::socket> _socket)
+{
+    auto request = std::make_shared<ba::streambuf>(c_maxRequestLength);
+    ba::async_read_until(*_socket, *request, "\r\n\r\n",
+        [_socket, request](boost::system::error_code const& _ec, std::size_t) {
+            if (_ec)
+            {
+                return;
+            }
+            std::string body = MetricsRegistry::instance().exposition();
+            auto response = std::make_shared<std::string>(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Connection: close\r\n"
+                "Content-Length: " +
+                std::to_string(body.size()) + "\r\n\r\n" + body);
+            ba::async_write(*_socket, ba::buffer(*response),
+                [_socket, response](boost::system::error_code const&, std::size_t) {
+                    boost::system::error_code ec;
+                    _socket->shutdown(bi::tcp::socket::shutdown_both, ec);
+                    _socket->close(ec);
+                });
+        });
+}
@@ -0,0 +1,57 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief: http endpoint prometheus scrapes the metrics of MetricsRegistry from
+ *
+ * @file MetricsServer.h
+ * @date 2019-04-03
+ */
+
+#pragma once
+#include <boost/asio.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace dev
+{
+/// answers every http request with the metrics, each connection is served with one response and
+/// closed, on a thread of its own
+class MetricsServer
+{
+public:
+    typedef std::shared_ptr<MetricsServer> Ptr;
+
+    MetricsServer(std::string const& _listenIP, uint16_t _listenPort);
+    ~MetricsServer() { stop(); }
+
+    /// throws if the address can't be listened on
+    void start();
+    void stop();
+
+private:
+    void accept();
+    void serve(std::shared_ptr<boost::asio::ip::tcp::socket> _socket);
+
+    std::string m_listenIP;
+    uint16_t m_listenPort;
+    boost::asio::io_service m_ioService;
+    std::shared_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+    std::thread m_thread;
+};
+
+}  // namespace dev
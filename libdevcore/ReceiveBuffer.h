@@ -0,0 +1,89 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief: buffer of the bytes received from a connection and not decoded yet
+ *
+ * @file ReceiveBuffer.h
+ * @date 2019-04-04
+ */
+
+#pragma once
+#include "Common.h"
+#include <cstring>
+
+namespace dev
+{
+/// the socket reads into the free space at the end, the decoded messages are consumed from the
+/// front without moving the bytes behind them; the undecoded bytes are only moved to the front when
+/// the free space runs out, so a received byte is moved once at most before it's decoded
+class ReceiveBuffer
+{
+public:
+    explicit ReceiveBuffer(size_t _readSize) : m_readSize(_readSize) {}
+
+    /// the free space for the next read, readSize bytes at least
+    bytesRef prepare()
+    {
+        if (m_buffer.size() - m_end < m_readSize)
+        {
+            if (m_begin > 0)
+            {
+                std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+                m_end -= m_begin;
+                m_begin = 0;
+            }
+            if (m_buffer.size() - m_end < m_readSize)
+            {
+                m_buffer.resize(std::max(m_buffer.size() * 2, m_end + m_readSize));
+            }
+        }
+        return bytesRef(m_buffer.data() + m_end, m_buffer.size() - m_end);
+    }
+    /// _size bytes have been read into the space returned by prepare
+    void commit(size_t _size) { m_end += _size; }
+
+    /// the bytes not consumed yet, invalidated by prepare
+    bytesConstRef data() const
+    {
+        return bytesConstRef(m_buffer.data() + m_begin, m_end - m_begin);
+    }
+    size_t size() const { return m_end - m_begin; }
+
+    void consume(size_t _size)
+    {
+        m_begin += _size;
+        if (m_begin == m_end)
+        {
+            m_begin = m_end = 0;
+            /// give back the memory taken by a large message
+            if (m_buffer.size() > c_maxIdleReads * m_readSize)
+            {
+                bytes().swap(m_buffer);
+            }
+        }
+    }
+
+private:
+    static const size_t c_maxIdleReads = 16;
+
+    size_t m_readSize;
+    bytes m_buffer;
+    size_t m_begin = 0;
+    size_t m_end = 0;
+};
+
+}  // namespace dev
@@ -28,8 +28,10 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 namespace dev
 {
@@ -69,6 +71,36 @@ public:
         _ioService.post(f);
     }
 
+    /// run _task(0), ..., _task(_workers - 1) on the pool and wait for all of them,
+    /// the exception of the first failed task is rethrown once every task has finished
+    /// (must not be called from a thread of the same pool)
+    template <class F>
+    void runAndWait(size_t _workers, F const& _task)
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(_workers);
+        for (size_t worker = 0; worker < _workers; ++worker)
+        {
+            auto promise = std::make_shared<std::promise<void>>();
+            futures.push_back(promise->get_future());
+            enqueue([&_task, worker, promise]() {
+                try
+                {
+                    _task(worker);
+                    promise->set_value();
+                }
+                catch (...)
+                {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+        }
+        for (auto& future : futures)
+            future.wait();
+        for (auto& future : futures)
+            future.get();
+    }
+
 private:
     std::string _threadName;
     boost::thread_group _workers;
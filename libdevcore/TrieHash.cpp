@@ -16,16 +16,30 @@
 */
 
 #include "TrieHash.h"
+#include "ThreadPool.h"
 #include "TrieCommon.h"
 #include "TrieDB.h"  // @TODO replace ASAP!
 
 namespace dev
 {
+/// subtries hashed ahead on several threads: a first pass collects the subtries with fewer items
+/// than minItems, the second pass takes their hashes instead of hashing them
+struct Subtries
+{
+    size_t minItems;
+    bool collecting = true;
+    std::vector<std::tuple<HexMap::const_iterator, HexMap::const_iterator, unsigned>> ranges;
+    /// the item appended for a subtrie, by its first key and its prefix length
+    std::map<std::pair<bytes const*, unsigned>, bytes> hashed;
+};
+
 void hash256aux(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp);
+    unsigned _preLen, RLPStream& _rlp, Subtries* _subtries = nullptr);
+bool subtrieItem(HexMap::const_iterator _begin, HexMap::const_iterator _end, unsigned _preLen,
+    RLPStream& _rlp, Subtries* _subtries);
 
 void hash256rlp(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp)
+    unsigned _preLen, RLPStream& _rlp, Subtries* _subtries = nullptr)
 {
     if (_begin == _end)
         _rlp << "";  // NULL
@@ -55,7 +69,7 @@ void hash256rlp(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_i
         {
             // if they all have the same next nibble, we also want a pair.
             _rlp.appendList(2) << hexPrefixEncode(_begin->first, false, _preLen, (int)sharedPre);
-            hash256aux(_s, _begin, _end, (unsigned)sharedPre, _rlp);
+            hash256aux(_s, _begin, _end, (unsigned)sharedPre, _rlp, _subtries);
         }
         else
         {
@@ -64,18 +78,45 @@ void hash256rlp(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_i
             auto b = _begin;
             if (_preLen == b->first.size())
                 ++b;
+            /// the nodes of the 16 subtries are hashed together, see dev::sha3Batch
+            std::vector<bytes> items(16);
+            std::vector<bytes> nodes;
+            std::vector<unsigned> nodeIndexes;
             for (auto i = 0; i < 16; ++i)
             {
                 auto n = b;
                 for (; n != _end && n->first[_preLen] == i; ++n)
                 {
                 }
+                RLPStream item;
                 if (b == n)
-                    _rlp << "";
-                else
-                    hash256aux(_s, b, n, _preLen + 1, _rlp);
+                    item << "";
+                else if (!_subtries || !subtrieItem(b, n, _preLen + 1, item, _subtries))
+                {
+                    RLPStream node;
+                    hash256rlp(_s, b, n, _preLen + 1, node, _subtries);
+                    if (node.out().size() < 32)
+                    {
+                        // RECURSIVE RLP
+                        item.appendRaw(node.out());
+                    }
+                    else
+                    {
+                        nodes.push_back(node.out());
+                        nodeIndexes.push_back(i);
+                    }
+                }
+                items[i] = item.out();
                 b = n;
             }
+            std::vector<bytesConstRef> refs;
+            for (auto const& node : nodes)
+                refs.push_back(bytesConstRef(&node));
+            h256s hashes = sha3Batch(refs);
+            for (size_t i = 0; i < hashes.size(); ++i)
+                items[nodeIndexes[i]] = rlp(hashes[i]);
+            for (auto const& item : items)
+                _rlp.appendRaw(item);
             if (_preLen == _begin->first.size())
                 _rlp << _begin->second;
             else
@@ -84,11 +125,44 @@ void hash256rlp(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_i
     }
 }
 
+/// append the item of a subtrie hashed ahead, or collected to be, false if it isn't one
+bool subtrieItem(HexMap::const_iterator _begin, HexMap::const_iterator _end, unsigned _preLen,
+    RLPStream& _rlp, Subtries* _subtries)
+{
+    if (_subtries->collecting)
+    {
+        size_t items = 0;
+        for (auto i = _begin; i != _end && items < _subtries->minItems; ++i)
+        {
+            ++items;
+        }
+        if (items < _subtries->minItems)
+        {
+            _subtries->ranges.push_back(std::make_tuple(_begin, _end, _preLen));
+            /// the output of the collecting pass is dropped
+            _rlp << "";
+            return true;
+        }
+    }
+    else
+    {
+        auto it = _subtries->hashed.find(std::make_pair(&_begin->first, _preLen));
+        if (it != _subtries->hashed.end())
+        {
+            _rlp.appendRaw(it->second);
+            return true;
+        }
+    }
+    return false;
+}
+
 void hash256aux(HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp)
+    unsigned _preLen, RLPStream& _rlp, Subtries* _subtries)
 {
+    if (_subtries && subtrieItem(_begin, _end, _preLen, _rlp, _subtries))
+        return;
     RLPStream rlp;
-    hash256rlp(_s, _begin, _end, _preLen, rlp);
+    hash256rlp(_s, _begin, _end, _preLen, rlp, _subtries);
     if (rlp.out().size() < 32)
     {
         // RECURSIVE RLP
@@ -125,6 +199,44 @@ h256 orderedTrieRoot(std::vector<bytes> const& _data)
     return hash256(m);
 }
 
+h256 orderedTrieRoot(std::vector<bytes> const& _data, ThreadPool& _pool, size_t _threadNum)
+{
+    if (_data.empty())
+        return sha3(rlp(""));
+    HexMap hexMap;
+    for (unsigned j = 0; j < _data.size(); ++j)
+    {
+        bytes key = rlp(j);
+        hexMap[asNibbles(bytesConstRef(&key))] = _data[j];
+    }
+    Subtries subtries;
+    subtries.minItems = std::max<size_t>(1, hexMap.size() / (_threadNum * 4));
+    RLPStream collecting;
+    hash256rlp(hexMap, hexMap.cbegin(), hexMap.cend(), 0, collecting, &subtries);
+
+    auto const& ranges = subtries.ranges;
+    std::vector<bytes> hashed(ranges.size());
+    _pool.runAndWait(std::min(_threadNum, ranges.size()), [&](size_t worker) {
+        for (size_t i = worker; i < ranges.size(); i += _threadNum)
+        {
+            RLPStream s;
+            hash256aux(
+                hexMap, std::get<0>(ranges[i]), std::get<1>(ranges[i]), std::get<2>(ranges[i]), s);
+            hashed[i] = s.out();
+        }
+    });
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        subtries.hashed[std::make_pair(&std::get<0>(ranges[i])->first, std::get<2>(ranges[i]))] =
+            std::move(hashed[i]);
+    }
+    subtries.collecting = false;
+    RLPStream s;
+    hash256rlp(hexMap, hexMap.cbegin(), hexMap.cend(), 0, s, &subtries);
+    return sha3(s.out());
+}
+
 h256 orderedTrieRoot(std::vector<bytesConstRef> const& _data)
 {
     BytesMap m;
@@ -44,4 +44,8 @@ inline h256 trieRootOver(unsigned _itemCount, T const& _getKey, U const& _getVal
 h256 orderedTrieRoot(std::vector<bytesConstRef> const& _data);
 h256 orderedTrieRoot(std::vector<bytes> const& _data);
 
+class ThreadPool;
+/// the same root as orderedTrieRoot, the subtries are hashed by _threadNum workers of _pool
+h256 orderedTrieRoot(std::vector<bytes> const& _data, ThreadPool& _pool, size_t _threadNum);
+
 }  // namespace dev
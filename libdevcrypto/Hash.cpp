@@ -23,6 +23,7 @@
 #include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
 #include <secp256k1_sha256.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -175,6 +176,84 @@ defshake(128) defshake(256)
     /*** FIPS202 SHA3 FOFs ***/
     defsha3(224) defsha3(256) defsha3(384) defsha3(512)
 
+/*** Keccak-f[1600] of several independent states at once, a state in every vector lane ***/
+#define LANES 4
+typedef uint64_t lanes_t __attribute__((vector_size(8 * LANES)));
+
+/// compiled for the vector extensions the CPUs may have, chosen at runtime
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define LANES_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define LANES_TARGETS
+#endif
+
+LANES_TARGETS static void keccakfLanes(lanes_t* a)
+{
+    lanes_t b[5] = {};
+    lanes_t t = {};
+    uint8_t x, y;
+
+    for (int i = 0; i < 24; i++)
+    {
+        // Theta
+        FOR5(x, 1, b[x] = lanes_t{}; FOR5(y, 5, b[x] ^= a[x + y];))
+        FOR5(x, 1, FOR5(y, 5, a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1);))
+        // Rho and pi
+        t = a[1];
+        x = 0;
+        REPEAT24(b[0] = a[pi[x]]; a[pi[x]] = rol(t, rho[x]); t = b[0]; x++;)
+        // Chi
+        FOR5(y, 5,
+            FOR5(x, 1, b[x] = a[y + x];)
+                FOR5(x, 1, a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]);))
+        // Iota
+        a[0] ^= RC[i];
+    }
+}
+
+/// SHA3-256 of LANES inputs of the same number of blocks
+static inline void sha3_256Lanes(uint8_t* const* out, const uint8_t* const* in, const size_t* inlen)
+{
+    const size_t rate = 200 - (256 / 4);
+    size_t blocks = inlen[0] / rate + 1;
+    // the padded last blocks
+    uint8_t last[LANES][rate];
+    for (size_t j = 0; j < LANES; ++j)
+    {
+        size_t tail = inlen[j] - (blocks - 1) * rate;
+        memset(last[j], 0, rate);
+        if (tail > 0)
+        {
+            memcpy(last[j], in[j] + (blocks - 1) * rate, tail);
+        }
+        last[j][tail] ^= 0x01;
+        last[j][rate - 1] ^= 0x80;
+    }
+    lanes_t a[Plen / 8] = {};
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        for (size_t j = 0; j < LANES; ++j)
+        {
+            const uint8_t* data = (block + 1 < blocks) ? in[j] + block * rate : last[j];
+            for (size_t i = 0; i < rate / 8; ++i)
+            {
+                uint64_t word;
+                memcpy(&word, data + 8 * i, 8);
+                a[i][j] ^= word;
+            }
+        }
+        keccakfLanes(a);
+    }
+    for (size_t j = 0; j < LANES; ++j)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            uint64_t word = a[i][j];
+            memcpy(out[j] + 8 * i, &word, 8);
+        }
+    }
+}
+
 }  // namespace keccak
 
 bool sha3(bytesConstRef _input, bytesRef o_output)
@@ -186,6 +265,46 @@ bool sha3(bytesConstRef _input, bytesRef o_output)
     return true;
 }
 
+void sha3Batch(std::vector<bytesConstRef> const& _inputs, h256* o_outputs)
+{
+    const size_t rate = 200 - (256 / 4);
+    auto blocks = [&](size_t _index) { return _inputs[_index].size() / rate; };
+    /// the lanes hash the same number of blocks, take the inputs in the order of their blocks
+    std::vector<size_t> order(_inputs.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    if (order.size() >= LANES)
+    {
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t _a, size_t _b) { return blocks(_a) < blocks(_b); });
+    }
+    size_t i = 0;
+    while (i < order.size())
+    {
+        if (i + LANES <= order.size() && blocks(order[i]) == blocks(order[i + LANES - 1]))
+        {
+            uint8_t* out[LANES];
+            const uint8_t* in[LANES];
+            size_t inlen[LANES];
+            for (size_t j = 0; j < LANES; ++j)
+            {
+                out[j] = o_outputs[order[i + j]].data();
+                in[j] = _inputs[order[i + j]].data();
+                inlen[j] = _inputs[order[i + j]].size();
+            }
+            keccak::sha3_256Lanes(out, in, inlen);
+            i += LANES;
+        }
+        else
+        {
+            sha3(_inputs[order[i]], o_outputs[order[i]].ref());
+            ++i;
+        }
+    }
+}
+
 // add sha2 -- sha256 to this file begin
 h256 sha256(bytesConstRef _input) noexcept
 {
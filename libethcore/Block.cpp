@@ -24,11 +24,47 @@
 #include "Block.h"
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
+#include <thread>
 namespace dev
 {
 namespace eth
 {
+/// blocks with fewer items are encoded and hashed on the calling thread
+static const size_t c_minParallelItems = 64;
+static const size_t c_rootThreadNum =
+    std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+
+static dev::ThreadPool& rootThreadPool()
+{
+    static dev::ThreadPool pool("BlockRoot", c_rootThreadNum);
+    return pool;
+}
+
+/// encode the transactions or receipts into _encoded and return the root of their trie,
+/// both in parallel for large blocks
+template <class T>
+static h256 encodeAndHash(std::vector<T> const& _items, std::vector<bytes>& _encoded)
+{
+    _encoded.resize(_items.size());
+    if (_items.size() < c_minParallelItems || c_rootThreadNum < 2)
+    {
+        for (size_t i = 0; i < _items.size(); i++)
+        {
+            _items[i].encode(_encoded[i]);
+        }
+        return orderedTrieRoot(_encoded);
+    }
+    rootThreadPool().runAndWait(c_rootThreadNum, [&](size_t worker) {
+        for (size_t i = worker; i < _items.size(); i += c_rootThreadNum)
+        {
+            _items[i].encode(_encoded[i]);
+        }
+    });
+    return orderedTrieRoot(_encoded, rootThreadPool(), c_rootThreadNum);
+}
+
 Block::Block(bytesConstRef _data)
 {
     decode(_data);
@@ -99,22 +135,18 @@ void Block::encode(bytes& _out) const
 void Block::calTransactionRoot(bool update) const
 {
     WriteGuard l(x_txsCache);
-    RLPStream txs;
-    txs.appendList(m_transactions.size());
     if (m_txsCache == bytes())
     {
-        BytesMap txsMapCache;
-        for (size_t i = 0; i < m_transactions.size(); i++)
+        /// the encoded transactions make both the trie and the transaction list of the block
+        std::vector<bytes> encoded;
+        m_transRootCache = encodeAndHash(m_transactions, encoded);
+        RLPStream txs;
+        txs.appendList(m_transactions.size());
+        for (auto const& trans_data : encoded)
         {
-            RLPStream s;
-            s << i;
-            bytes trans_data;
-            m_transactions[i].encode(trans_data);
             txs.appendRaw(trans_data);
-            txsMapCache.insert(std::make_pair(s.out(), trans_data));
         }
         txs.swapOut(m_txsCache);
-        m_transRootCache = hash256(txsMapCache);
     }
     if (update == true)
         m_blockHeader.setTransactionsRoot(m_transRootCache);
@@ -126,20 +158,15 @@ void Block::calReceiptRoot(bool update) const
     WriteGuard l(x_txReceiptsCache);
     if (m_tReceiptsCache == bytes())
     {
+        std::vector<bytes> encoded;
+        m_receiptRootCache = encodeAndHash(m_transactionReceipts, encoded);
         RLPStream txReceipts;
         txReceipts.appendList(m_transactionReceipts.size());
-        BytesMap mapCache;
-        for (size_t i = 0; i < m_transactionReceipts.size(); i++)
+        for (auto const& tranReceipts_data : encoded)
         {
-            RLPStream s;
-            s << i;
-            bytes tranReceipts_data;
-            m_transactionReceipts[i].encode(tranReceipts_data);
             txReceipts.appendRaw(tranReceipts_data);
-            mapCache.insert(std::make_pair(s.out(), tranReceipts_data));
         }
         txReceipts.swapOut(m_tReceiptsCache);
-        m_receiptRootCache = hash256(mapCache);
     }
     if (update == true)
     {
@@ -182,6 +182,34 @@ h256 Transaction::sha3(IncludeSignature _sig) const
     return ret;
 }
 
+void Transaction::calculateHashes(std::vector<Transaction> const& _txs)
+{
+    std::vector<size_t> unhashed;
+    for (size_t i = 0; i < _txs.size(); ++i)
+    {
+        if (!_txs[i].m_hashWith)
+        {
+            unhashed.push_back(i);
+        }
+    }
+    if (unhashed.size() < 2)
+    {
+        return;
+    }
+    std::vector<bytes> encoded(unhashed.size());
+    std::vector<bytesConstRef> inputs(unhashed.size());
+    for (size_t i = 0; i < unhashed.size(); ++i)
+    {
+        _txs[unhashed[i]].encode(encoded[i], WithSignature);
+        inputs[i] = bytesConstRef(&encoded[i]);
+    }
+    h256s hashes = dev::sha3Batch(inputs);
+    for (size_t i = 0; i < unhashed.size(); ++i)
+    {
+        _txs[unhashed[i]].m_hashWith = hashes[i];
+    }
+}
+
 void Transaction::tiggerRpcCallback(LocalisedTransactionReceipt::Ptr pReceipt) const
 {
     try
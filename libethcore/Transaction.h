@@ -141,6 +141,8 @@ public:
 
     /// @returns the SHA3 hash of the RLP serialisation of this transaction.
     h256 sha3(IncludeSignature _sig = WithSignature) const;
+    /// hash the transactions not hashed yet together, see dev::sha3Batch
+    static void calculateHashes(std::vector<Transaction> const& _txs);
 
     /// @returns the amount of ETH to be transferred by this (message-call)
     /// transaction, in Wei. Synonym for endowment().
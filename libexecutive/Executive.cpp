@@ -112,6 +112,11 @@ bool Executive::execute()
     LOG(TRACE) << "Practical limitation of tx gas: " << txGasLimit;
 
     assert(txGasLimit >= (u256)m_baseGasRequired);
+    if (m_staticCall && m_t.isCreation())
+    {
+        m_excepted = TransactionException::Unknown;
+        BOOST_THROW_EXCEPTION(DisallowedStateChange() << errinfo_comment("static call creation"));
+    }
     if (m_t.isCreation())
         return create(m_t.sender(), m_t.value(), m_t.gasPrice(),
             txGasLimit - (u256)m_baseGasRequired, &m_t.data(), m_t.sender());
@@ -125,13 +130,14 @@ bool Executive::call(Address const& _receiveAddress, Address const& _senderAddre
 {
     CallParameters params{
         _senderAddress, _receiveAddress, _receiveAddress, _value, _value, _gas, _data, {}};
+    params.staticCall = m_staticCall;
     return call(params, _gasPrice, _senderAddress);
 }
 
 bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address const& _origin)
 {
-    // If external transaction.
-    if (m_t)
+    // If external transaction, a static call leaves the nonce as it is.
+    if (m_t && !_p.staticCall)
     {
         // FIXME: changelog contains unrevertable balance change that paid
         //        for the transaction.
@@ -162,6 +162,10 @@ public:
     /// Collect execution results in the result storage provided.
     void setResultRecipient(ExecutionResult& _res) { m_res = &_res; }
 
+    /// Execute the transaction as a static call: a creation is refused and the EVM stops at the
+    /// first state change, calls of precompiled contracts aren't affected.
+    void setStaticCall(bool _staticCall) { m_staticCall = _staticCall; }
+
     /// Revert all changes made to the state by this execution.
     void revert();
 
@@ -195,6 +199,7 @@ private:
     u256 m_gasCost;
 
     bool m_isCreation = false;
+    bool m_staticCall = false;
     Address m_newAddress;
     size_t m_savepoint = 0;
     size_t m_tableFactorySavepoint = 0;
@@ -40,6 +40,9 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
         std::string publicID = _pt.get<std::string>("p2p.public_ip", "127.0.0.1");
         std::string listenIP = _pt.get<std::string>("p2p.listen_ip", "0.0.0.0");
         int listenPort = _pt.get<int>("p2p.listen_port", 30300);
+        bool enableCompression = _pt.get<bool>("p2p.enable_compression", true);
+        size_t compressionThreshold =
+            _pt.get<size_t>("p2p.compression_threshold", Compression::DEFAULT_THRESHOLD);
 
         std::map<NodeIPEndpoint, NodeID> nodes;
         for (auto it : _pt.get_child("p2p"))
@@ -129,6 +132,9 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
         m_p2pService->setStaticNodes(nodes);
         m_p2pService->setKeyPair(m_keyPair);
         m_p2pService->setP2PMessageFactory(messageFactory);
+        m_p2pService->setCompression(enableCompression, compressionThreshold);
+        INITIALIZER_LOG(DEBUG) << "[#P2PInitializer::initConfig] [enableCompression/threshold]: "
+                               << enableCompression << "/" << compressionThreshold;
 
         m_p2pService->start();
     }
@@ -30,7 +30,13 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
     std::string listenIP = _pt.get<std::string>("rpc.listen_ip", "0.0.0.0");
     int listenPort = _pt.get<int>("rpc.channel_listen_port", 30301);
     int httpListenPort = _pt.get<int>("rpc.jsonrpc_listen_port", 0);
-    if (!isValidPort(listenPort) || !isValidPort(httpListenPort))
+    /// 0 disables the metrics endpoint, which is only reachable locally unless configured
+    int metricsListenPort = _pt.get<int>("rpc.metrics_listen_port", 0);
+    std::string metricsListenIP = _pt.get<std::string>("rpc.metrics_listen_ip", "127.0.0.1");
+    /// 0 handles the requests of a batch one by one
+    int batchThreadNum = _pt.get<int>("rpc.batch_thread_num", RPC_BATCH_THREAD_NUM_DEFAULT);
+    if (!isValidPort(listenPort) || !isValidPort(httpListenPort) ||
+        !isValidPort(metricsListenPort))
     {
         INITIALIZER_LOG(ERROR) << "[#RPCInitializer] initConfig for RPCInitializer failed";
         ERROR_OUTPUT << "[#RPCInitializer] initConfig for RPCInitializer failed! Invalid "
@@ -38,6 +44,14 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
                      << std::endl;
         exit(1);
     }
+    if (batchThreadNum < 0)
+    {
+        INITIALIZER_LOG(ERROR) << "[#RPCInitializer] initConfig for RPCInitializer failed";
+        ERROR_OUTPUT << "[#RPCInitializer] initConfig for RPCInitializer failed! Invalid "
+                        "batch_thread_num for RPC, must not be negative"
+                     << std::endl;
+        exit(1);
+    }
     /// init channelServer
     ChannelRPCServer::Ptr m_channelRPCServer;
     ///< TODO: Double free or no free?
@@ -62,7 +76,17 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
         m_channelRPCServer->setChannelServer(server);
 
         auto rpcEntity = new rpc::Rpc(m_ledgerManager, m_p2pService);
+        m_channelRPCServer->setTransactionsHandler(
+            [rpcEntity](int _groupID, std::vector<bytesConstRef> const& _rlps) {
+                std::vector<std::pair<int32_t, h256>> statuses;
+                for (auto& result : rpcEntity->submitTransactions(_groupID, _rlps))
+                {
+                    statuses.emplace_back((int32_t)result.first, result.second);
+                }
+                return statuses;
+            });
         m_channelRPCHttpServer = new ModularServer<rpc::Rpc>(rpcEntity);
+        m_channelRPCHttpServer->setBatchThreadNum(batchThreadNum);
         m_channelRPCHttpServer->addConnector(m_channelRPCServer.get());
         m_channelRPCHttpServer->StartListening();
         INITIALIZER_LOG(INFO) << "ChannelRPCHttpServer started.";
@@ -72,9 +96,19 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
         m_safeHttpServer.reset(
             new SafeHttpServer(listenIP, httpListenPort), [](SafeHttpServer* p) { (void)p; });
         m_jsonrpcHttpServer = new ModularServer<rpc::Rpc>(rpcEntity);
+        m_jsonrpcHttpServer->setBatchThreadNum(batchThreadNum);
         m_jsonrpcHttpServer->addConnector(m_safeHttpServer.get());
         m_jsonrpcHttpServer->StartListening();
         INITIALIZER_LOG(INFO) << "JsonrpcHttpServer started.";
+
+        if (metricsListenPort != 0)
+        {
+            m_metricsServer =
+                std::make_shared<MetricsServer>(metricsListenIP, metricsListenPort);
+            m_metricsServer->start();
+            INITIALIZER_LOG(INFO) << "MetricsServer started [listenIP/port]: " << metricsListenIP
+                                  << "/" << metricsListenPort;
+        }
     }
     catch (std::exception& e)
     {
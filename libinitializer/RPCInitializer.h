@@ -24,6 +24,7 @@
 
 #include "Common.h"
 #include <libchannelserver/ChannelRPCServer.h>
+#include <libdevcore/MetricsServer.h>
 #include <libledger/LedgerManager.h>
 #include <libp2p/P2PInterface.h>
 #include <librpc/Rpc.h>
@@ -74,6 +75,7 @@ private:
     ChannelRPCServer::Ptr m_channelRPCServer;
     ModularServer<>* m_channelRPCHttpServer;
     ModularServer<>* m_jsonrpcHttpServer;
+    MetricsServer::Ptr m_metricsServer;
 };
 
 }  // namespace initializer
@@ -0,0 +1,152 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CodeCache.cpp
+ *  @date 20190327
+ */
+
+#include "CodeCache.h"
+#include "VMConfig.h"
+
+using namespace dev;
+using namespace dev::eth;
+
+/// bookkeeping bytes of a cached code besides its buffers
+static const size_t c_codeOverhead = 256;
+static const size_t c_defaultCapacity = 32 * 1024 * 1024;
+
+int64_t AnalyzedCode::findJumpDest(u256 const& _dest) const
+{
+    // check for overflow
+    if (_dest <= 0x7FFFFFFFFFFFFFFF)
+    {
+        // check for within bounds and to a jump destination
+        // use binary search of array because hashtable collisions are exploitable
+        uint64_t pc = uint64_t(_dest);
+        if (std::binary_search(jumpDests.begin(), jumpDests.end(), pc))
+            return pc;
+    }
+    return -1;
+}
+
+size_t AnalyzedCode::size() const
+{
+    return c_codeOverhead + code.capacity() + jumpDests.capacity() * sizeof(uint64_t) +
+           pool.capacity() * sizeof(u256);
+}
+
+CodeCache& CodeCache::instance()
+{
+    static CodeCache s_instance(c_defaultCapacity, EVM_OPTIMIZE);
+    return s_instance;
+}
+
+CodeCache::CodeCache(size_t _capacity, bool _optimize)
+  : m_capacity(_capacity), m_optimize(_optimize)
+{}
+
+AnalyzedCode::Ptr CodeCache::get(h256 const& _codeHash, uint8_t const* _code, size_t _codeSize)
+{
+    bool optimize = m_optimize;
+    if (!_codeHash)
+    {
+        return AnalyzedCode::analyze(_code, _codeSize, optimize);
+    }
+
+    {
+        Guard l(x_codes);
+        auto it = m_index.find(_codeHash);
+        /// the code analyzed the other way is replaced
+        if (it != m_index.end() && it->second->code->codeSize == _codeSize &&
+            it->second->code->optimized == optimize)
+        {
+            m_codes.splice(m_codes.begin(), m_codes, it->second);
+            m_hits++;
+            return it->second->code;
+        }
+    }
+
+    /// analyze without the lock, a code missed by several threads at once is analyzed by each
+    m_misses++;
+    AnalyzedCode::Ptr code = AnalyzedCode::analyze(_code, _codeSize, optimize);
+    {
+        Guard l(x_codes);
+        update(_codeHash, code);
+    }
+    return code;
+}
+
+void CodeCache::setCapacity(size_t _capacity)
+{
+    Guard l(x_codes);
+    m_capacity = _capacity;
+    evict(m_capacity);
+}
+
+void CodeCache::clear()
+{
+    Guard l(x_codes);
+    m_codes.clear();
+    m_index.clear();
+    m_size = 0;
+}
+
+CodeCache::Metrics CodeCache::metrics() const
+{
+    Metrics cacheMetrics;
+    cacheMetrics.hits = m_hits;
+    cacheMetrics.misses = m_misses;
+    cacheMetrics.evictions = m_evictions;
+    Guard l(x_codes);
+    cacheMetrics.codes = m_index.size();
+    cacheMetrics.size = m_size;
+    cacheMetrics.capacity = m_capacity;
+    return cacheMetrics;
+}
+
+void CodeCache::update(h256 const& _codeHash, AnalyzedCode::Ptr _code)
+{
+    auto it = m_index.find(_codeHash);
+    if (it != m_index.end())
+    {
+        m_size -= it->second->code->size();
+        m_codes.erase(it->second);
+        m_index.erase(it);
+    }
+
+    size_t size = _code->size();
+    /// too large to be cached
+    if (size > m_capacity)
+    {
+        return;
+    }
+    evict(m_capacity - size);
+    m_codes.push_front(CachedCode{_codeHash, _code});
+    m_index[_codeHash] = m_codes.begin();
+    m_size += size;
+}
+
+void CodeCache::evict(size_t _capacity)
+{
+    while (m_size > _capacity)
+    {
+        auto& last = m_codes.back();
+        m_size -= last.code->size();
+        m_index.erase(last.codeHash);
+        m_codes.pop_back();
+        m_evictions++;
+    }
+}
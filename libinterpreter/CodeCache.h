@@ -0,0 +1,116 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CodeCache.h
+ *  @date 20190327
+ */
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace dev
+{
+namespace eth
+{
+/// code of a contract prepared for the interpreter, never modified once analyzed so that the VMs
+/// of all the threads can share it
+struct AnalyzedCode
+{
+    typedef std::shared_ptr<AnalyzedCode const> Ptr;
+
+    /// the code extended by 33 zero bytes, synthetic ops of user code replaced by INVALID, and
+    /// PUSHn/JUMP/JUMPI replaced by PUSHC/JUMPC/JUMPCI if optimized
+    bytes code;
+    size_t codeSize = 0;
+    /// sorted positions of JUMPDEST
+    std::vector<uint64_t> jumpDests;
+    /// decoded immediates of PUSHC
+    std::vector<u256> pool;
+    bool optimized = false;
+
+    static Ptr analyze(uint8_t const* _code, size_t _codeSize, bool _optimize);
+
+    /// the position to jump to, -1 if _dest is not a JUMPDEST
+    int64_t findJumpDest(u256 const& _dest) const;
+    /// estimated bytes held by the analyzed code
+    size_t size() const;
+};
+
+/// process-wide LRU cache of analyzed code keyed by code hash, so that a contract is analyzed
+/// once instead of every time it is called
+class CodeCache
+{
+public:
+    struct Metrics
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t codes = 0;
+        /// estimated bytes of the cached codes
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    static CodeCache& instance();
+
+    /// _capacity: the max estimated bytes of the cached codes, 0 disables the cache
+    explicit CodeCache(size_t _capacity, bool _optimize = true);
+
+    /// analyzed code of _code, whose hash given by the host is _codeHash,
+    /// code with zero hash is analyzed without being cached
+    AnalyzedCode::Ptr get(h256 const& _codeHash, uint8_t const* _code, size_t _codeSize);
+
+    void setCapacity(size_t _capacity);
+    /// whether to do the first pass optimizations when analyzing code,
+    /// codes analyzed the other way are analyzed again when they are used
+    void setOptimize(bool _optimize) { m_optimize = _optimize; }
+    bool optimize() const { return m_optimize; }
+    void clear();
+
+    Metrics metrics() const;
+
+private:
+    struct CachedCode
+    {
+        h256 codeHash;
+        AnalyzedCode::Ptr code;
+    };
+
+    /// the lock must be held
+    void update(h256 const& _codeHash, AnalyzedCode::Ptr _code);
+    void evict(size_t _capacity);
+
+    /// most recently used first
+    std::list<CachedCode> m_codes;
+    std::unordered_map<h256, std::list<CachedCode>::iterator> m_index;
+    size_t m_size = 0;
+    size_t m_capacity;
+    mutable Mutex x_codes;
+
+    std::atomic<bool> m_optimize;
+    std::atomic<uint64_t> m_hits = {0};
+    std::atomic<uint64_t> m_misses = {0};
+    std::atomic<uint64_t> m_evictions = {0};
+};
+
+}  // namespace eth
+}  // namespace dev
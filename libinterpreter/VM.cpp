@@ -1155,7 +1155,6 @@ void VM::interpretCases()
 
             CASE(PUSHC)
         {
-#if EVM_USE_CONSTANT_POOL
             ON_OP();
             updateIOGas();
 
@@ -1168,9 +1167,6 @@ void VM::interpretCases()
             m_PC += m_code[m_PC];
             m_SPP[0] = m_pool[off];
             TRACE_VAL(2, "Retrieved pooled const", m_SPP[0]);
-#else
-            throwBadInstruction();
-#endif
         }
         CONTINUE
 
@@ -1250,20 +1246,15 @@ void VM::interpretCases()
 
         CASE(JUMPC)
         {
-#if EVM_REPLACE_CONST_JUMP
             ON_OP();
             updateIOGas();
 
             m_PC = uint64_t(m_SP[0]);
-#else
-            throwBadInstruction();
-#endif
         }
         CONTINUE
 
         CASE(JUMPCI)
         {
-#if EVM_REPLACE_CONST_JUMP
             ON_OP();
             updateIOGas();
 
@@ -1271,9 +1262,6 @@ void VM::interpretCases()
                 m_PC = uint64_t(m_SP[0]);
             else
                 ++m_PC;
-#else
-            throwBadInstruction();
-#endif
         }
         CONTINUE
 
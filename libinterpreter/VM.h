@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "CodeCache.h"
 #include "VMConfig.h"
 
 #include <libdevcore/Common.h>
@@ -84,7 +85,6 @@ private:
     static std::array<evmc_instruction_metrics, 256> c_metrics;
     static void initMetrics();
     static u256 exp256(u256 _base, u256 _exponent);
-    void copyCode(int);
     typedef void (VM::*MemFnPtr)();
     MemFnPtr m_bounce = nullptr;
     uint64_t m_nSteps = 0;
@@ -97,8 +97,9 @@ private:
 
     uint8_t const* m_pCode = nullptr;
     size_t m_codeSize = 0;
-    // space for code
-    bytes m_code;
+    // analyzed code shared by the VMs running the same code
+    AnalyzedCode::Ptr m_analysis;
+    byte const* m_code = nullptr;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -109,7 +110,7 @@ private:
     size_t stackSize() { return m_stackEnd - m_SP; }
 
     // constant pool
-    std::vector<u256> m_pool;
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -124,7 +125,6 @@ private:
 
     // initialize interpreter
     void initEntry();
-    void optimize();
 
     // interpreter loop & switch
     void interpretCases();
@@ -148,7 +148,6 @@ private:
     void throwBufferOverrun(bigint const& _enfOfAccess);
 
     std::vector<uint64_t> m_beginSubs;
-    std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
 
     void onOperation() {}
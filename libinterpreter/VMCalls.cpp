@@ -92,18 +92,10 @@ void VM::throwBufferOverrun(bigint const& _endOfAccess)
 
 int64_t VM::verifyJumpDest(u256 const& _dest, bool _throw)
 {
-    // check for overflow
-    if (_dest <= 0x7FFFFFFFFFFFFFFF)
-    {
-        // check for within bounds and to a jump destination
-        // use binary search of array because hashtable collisions are exploitable
-        uint64_t pc = uint64_t(_dest);
-        if (std::binary_search(m_jumpDests.begin(), m_jumpDests.end(), pc))
-            return pc;
-    }
-    if (_throw)
+    int64_t pc = m_analysis->findJumpDest(_dest);
+    if (pc < 0 && _throw)
         throwBadJumpDestination();
-    return -1;
+    return pc;
 }
 
 
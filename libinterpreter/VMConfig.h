@@ -30,15 +30,12 @@ namespace eth
 //
 // interpreter configuration macros for development, optimizations and tracing
 //
-// EVM_OPTIMIZE           - all optimizations off when false (TO DO - MAKE DYNAMIC)
+// EVM_OPTIMIZE           - default of the first pass optimizations, which replace constants
+//                          and constant jumps when code is analyzed, see CodeCache::setOptimize
 //
 // EVM_SWITCH_DISPATCH    - dispatch via loop and switch
 // EVM_JUMP_DISPATCH      - dispatch via a jump table - available only on GCC
 //
-// EVM_USE_CONSTANT_POOL  - constants unpacked and ready to assign to stack
-//
-// EVM_REPLACE_CONST_JUMP - pre-verified jumps to save runtime lookup
-//
 // EVM_TRACE              - provides various levels of tracing
 
 #ifndef EVM_JUMP_DISPATCH
@@ -57,12 +54,7 @@ namespace eth
 #endif
 
 #ifndef EVM_OPTIMIZE
-#define EVM_OPTIMIZE false
-#endif
-#if EVM_OPTIMIZE
-#define EVM_REPLACE_CONST_JUMP true
-#define EVM_USE_CONSTANT_POOL true
-#define EVM_DO_FIRST_PASS_OPTIMIZATION (EVM_REPLACE_CONST_JUMP || EVM_USE_CONSTANT_POOL)
+#define EVM_OPTIMIZE true
 #endif
 
 
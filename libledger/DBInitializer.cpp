@@ -26,7 +26,9 @@
 #include <libdevcore/Common.h>
 #include <libmptstate/MPTStateFactory.h>
 #include <libsecurity/EncryptedLevelDB.h>
+#include <libstorage/CachedStorage.h>
 #include <libstorage/LevelDBStorage.h>
+#include <libstorage/WriteBehindStorage.h>
 #include <libstoragestate/StorageStateFactory.h>
 
 using namespace dev;
@@ -100,7 +102,28 @@ void DBInitializer::initLevelDBStorage()
         std::shared_ptr<dev::db::BasicLevelDB> leveldb_handler =
             std::shared_ptr<dev::db::BasicLevelDB>(pleveldb);
         leveldb_storage->setDB(leveldb_handler);
-        m_storage = leveldb_storage;
+        unsigned maxPendingBlocks = m_param->mutableStorageParam().maxPendingBlocks;
+        if (maxPendingBlocks > 0)
+        {
+            DBInitializer_LOG(DEBUG)
+                << "[#initStorageDB] [#initLevelDBStorage]: write-behind [maxPendingBlocks]: "
+                << maxPendingBlocks << std::endl;
+            m_writeBehindStorage =
+                std::make_shared<WriteBehindStorage>(leveldb_storage, maxPendingBlocks);
+            m_storage = m_writeBehindStorage;
+        }
+        else
+        {
+            m_storage = leveldb_storage;
+        }
+        unsigned cacheSize = m_param->mutableStorageParam().cacheSize;
+        if (cacheSize > 0)
+        {
+            DBInitializer_LOG(DEBUG)
+                << "[#initStorageDB] [#initLevelDBStorage]: cached [cacheSize(MB)]: " << cacheSize
+                << std::endl;
+            m_storage = std::make_shared<CachedStorage>(m_storage, (size_t)cacheSize << 20);
+        }
     }
     catch (std::exception& e)
     {
@@ -110,6 +133,16 @@ void DBInitializer::initLevelDBStorage()
     }
 }
 
+void DBInitializer::flushStorage()
+{
+    if (!m_writeBehindStorage)
+        return;
+    bool succ = m_writeBehindStorage->flush();
+    DBInitializer_LOG(INFO) << "[#flushStorage] [succ/flushedNumber/pendingBlocks]: " << succ
+                            << "/" << m_writeBehindStorage->flushedNumber() << "/"
+                            << m_writeBehindStorage->pendingBlocks() << std::endl;
+}
+
 /// TODO: init AMOP Storage
 void DBInitializer::initAMOPStorage()
 {
@@ -131,6 +164,9 @@ void DBInitializer::createExecutiveContext()
     m_executiveContextFac->setStateStorage(m_storage);
     // mpt or storage
     m_executiveContextFac->setStateFactory(m_stateFactory);
+    m_executiveContextFac->setStateHash(m_param->mutableStateParam().hashVersion,
+        m_param->mutableTxExecuteParam().hashThreadNum);
+    m_executiveContextFac->setConditionVersion(m_param->mutableStateParam().conditionVersion);
     DBInitializer_LOG(DEBUG) << "[#createExecutiveContext SUCC]" << std::endl;
 }
 
@@ -157,7 +193,8 @@ void DBInitializer::createStateFactory(dev::h256 const& genesisHash)
 void DBInitializer::createStorageState()
 {
     DBInitializer_LOG(DEBUG) << "[#createStateFactory] [#createStorageState]" << std::endl;
-    m_stateFactory = std::make_shared<StorageStateFactory>(u256(0x0));
+    m_stateFactory =
+        std::make_shared<StorageStateFactory>(u256(0x0), m_param->mutableStateParam().encoding);
     DBInitializer_LOG(DEBUG) << "[#createStateFactory] [#createStorageState SUCC]" << std::endl;
 }
 
@@ -29,6 +29,7 @@
 #include <libexecutive/StateFactoryInterface.h>
 #include <libstorage/MemoryTableFactory.h>
 #include <libstorage/Storage.h>
+#include <libstorage/WriteBehindStorage.h>
 #include <memory>
 #define DBInitializer_LOG(LEVEL) LOG(LEVEL) << "[#DBINITIALIZER] "
 namespace dev
@@ -54,6 +55,8 @@ public:
     }
 
     dev::storage::Storage::Ptr storage() const { return m_storage; }
+    /// wait for the write-behind layer of the storage to write its blocks, if there is one
+    void flushStorage();
     std::shared_ptr<dev::executive::StateFactoryInterface> stateFactory() { return m_stateFactory; }
     std::shared_ptr<dev::blockverifier::ExecutiveContextFactory> executiveContextFactory() const
     {
@@ -79,6 +82,7 @@ private:
     std::shared_ptr<LedgerParamInterface> m_param;
     std::shared_ptr<dev::executive::StateFactoryInterface> m_stateFactory;
     dev::storage::Storage::Ptr m_storage = nullptr;
+    std::shared_ptr<dev::storage::WriteBehindStorage> m_writeBehindStorage;
     std::shared_ptr<dev::blockverifier::ExecutiveContextFactory> m_executiveContextFac;
 };
 }  // namespace ledger
@@ -31,6 +31,8 @@
 #include <libconsensus/raft/RaftSealer.h>
 #include <libdevcore/OverlayDB.h>
 #include <libdevcore/easylog.h>
+#include <libstorage/MemoryTableFactory.h>
+#include <libstoragestate/StorageState.h>
 #include <libsync/SyncInterface.h>
 #include <libsync/SyncMaster.h>
 #include <libtxpool/TxPool.h>
@@ -111,8 +113,10 @@ void Ledger::initIniConfig(std::string const& iniConfigFileName)
 {
     try
     {
-        Ledger_LOG(INFO) << "[#initIniConfig] [initTxPoolConfig/initSyncConfig] fileName:"
-                         << iniConfigFileName;
+        Ledger_LOG(INFO)
+            << "[#initIniConfig] "
+               "[initTxPoolConfig/initSyncConfig/initTxExecuteConfig/initStorageConfig] fileName:"
+            << iniConfigFileName;
         ptree pt;
         /// read the configuration file for a specified group
         read_ini(iniConfigFileName, pt);
@@ -120,6 +124,12 @@ void Ledger::initIniConfig(std::string const& iniConfigFileName)
         initTxPoolConfig(pt);
         /// init params related to sync
         initSyncConfig(pt);
+        /// init params related to consensus of this node
+        initConsensusIniConfig(pt);
+        /// init params related to tx execution
+        initTxExecuteConfig(pt);
+        /// init params related to storage commit
+        initStorageConfig(pt);
     }
     catch (std::exception& e)
     {
@@ -134,8 +144,11 @@ void Ledger::initIniConfig(std::string const& iniConfigFileName)
 void Ledger::initTxPoolConfig(ptree const& pt)
 {
     m_param->mutableTxPoolParam().txPoolLimit = pt.get<uint64_t>("txPool.limit", 102400);
-    Ledger_LOG(DEBUG) << "[#initTxPoolConfig] [limit]:  "
-                      << m_param->mutableTxPoolParam().txPoolLimit << std::endl;
+    m_param->mutableTxPoolParam().verifyThreadNum =
+        pt.get<unsigned>("txPool.verifyThreadNum", TX_POOL_VERIFY_THREAD_NUM_DEFAULT);
+    Ledger_LOG(DEBUG) << "[#initTxPoolConfig] [limit/verifyThreadNum]:  "
+                      << m_param->mutableTxPoolParam().txPoolLimit << "/"
+                      << m_param->mutableTxPoolParam().verifyThreadNum << std::endl;
 }
 
 /// init consensus configurations:
@@ -151,16 +164,19 @@ void Ledger::initConsensusConfig(ptree const& pt)
     m_param->mutableConsensusParam().maxTransactions =
         pt.get<uint64_t>("consensus.maxTransNum", 1000);
     m_param->mutableConsensusParam().maxTTL = pt.get<uint8_t>("consensus.maxTTL", MAXTTL);
+    m_param->mutableConsensusParam().compactPrepare =
+        pt.get<bool>("consensus.compactPrepare", false);
 
     m_param->mutableConsensusParam().minElectTime =
         pt.get<uint64_t>("consensus.minElectTime", 1000);
     m_param->mutableConsensusParam().maxElectTime =
         pt.get<uint64_t>("consensus.maxElectTime", 2000);
 
-    Ledger_LOG(DEBUG) << "[#initConsensusConfig] [type/maxTxNum/maxTTL]:  "
+    Ledger_LOG(DEBUG) << "[#initConsensusConfig] [type/maxTxNum/maxTTL/compactPrepare]:  "
                       << m_param->mutableConsensusParam().consensusType << "/"
                       << m_param->mutableConsensusParam().maxTransactions << "/"
-                      << std::to_string(m_param->mutableConsensusParam().maxTTL);
+                      << std::to_string(m_param->mutableConsensusParam().maxTTL) << "/"
+                      << m_param->mutableConsensusParam().compactPrepare;
 
     std::stringstream nodeListMark;
     try
@@ -195,8 +211,19 @@ void Ledger::initSyncConfig(ptree const& pt)
 {
     m_param->mutableSyncParam().idleWaitMs =
         pt.get<unsigned>("sync.idleWaitMs", SYNC_IDLE_WAIT_DEFAULT);
-    Ledger_LOG(DEBUG) << "[#initSyncConfig] [idleWaitMs]:" << m_param->mutableSyncParam().idleWaitMs
-                      << std::endl;
+    m_param->mutableSyncParam().prepareThreadNum =
+        pt.get<unsigned>("sync.prepareThreadNum", SYNC_PREPARE_THREAD_NUM_DEFAULT);
+    Ledger_LOG(DEBUG) << "[#initSyncConfig] [idleWaitMs/prepareThreadNum]:"
+                      << m_param->mutableSyncParam().idleWaitMs << "/"
+                      << m_param->mutableSyncParam().prepareThreadNum << std::endl;
+}
+
+void Ledger::initConsensusIniConfig(ptree const& pt)
+{
+    m_param->mutableConsensusParam().pipelineDepth =
+        pt.get<unsigned>("consensus.pipelineDepth", 0);
+    Ledger_LOG(DEBUG) << "[#initConsensusIniConfig] [pipelineDepth]:"
+                      << m_param->mutableConsensusParam().pipelineDepth << std::endl;
 }
 
 /// init db related configurations:
@@ -211,11 +238,43 @@ void Ledger::initDBConfig(ptree const& pt)
     m_param->mutableStorageParam().path = m_param->baseDir() + "/block";
     /// set state db related param
     m_param->mutableStateParam().type = pt.get<std::string>("state.type", "mpt");
+    m_param->mutableStateParam().hashVersion =
+        pt.get<unsigned>("state.hashVersion", STATE_HASH_VERSION_DEFAULT);
+    if (m_param->mutableStateParam().hashVersion != dev::storage::CONCAT_STATE_HASH &&
+        m_param->mutableStateParam().hashVersion != dev::storage::BUCKET_STATE_HASH)
+    {
+        BOOST_THROW_EXCEPTION(dev::InitLedgerConfigFailed() << errinfo_comment(
+                                  "unsupported state.hashVersion " +
+                                  toString(m_param->mutableStateParam().hashVersion)));
+    }
+    m_param->mutableStateParam().encoding =
+        pt.get<unsigned>("state.encoding", STATE_ENCODING_DEFAULT);
+    if (m_param->mutableStateParam().encoding != dev::storagestate::TEXT_STORAGE_ENCODING &&
+        m_param->mutableStateParam().encoding != dev::storagestate::BINARY_STORAGE_ENCODING)
+    {
+        BOOST_THROW_EXCEPTION(dev::InitLedgerConfigFailed() << errinfo_comment(
+                                  "unsupported state.encoding " +
+                                  toString(m_param->mutableStateParam().encoding)));
+    }
+    m_param->mutableStateParam().conditionVersion =
+        pt.get<unsigned>("state.conditionVersion", STATE_CONDITION_VERSION_DEFAULT);
+    if (m_param->mutableStateParam().conditionVersion != dev::storage::INT_CONDITION &&
+        m_param->mutableStateParam().conditionVersion != dev::storage::BIGINT_CONDITION)
+    {
+        BOOST_THROW_EXCEPTION(dev::InitLedgerConfigFailed() << errinfo_comment(
+                                  "unsupported state.conditionVersion " +
+                                  toString(m_param->mutableStateParam().conditionVersion)));
+    }
 
-    Ledger_LOG(DEBUG) << "[#initDBConfig] [storageDB/storagePath/stateDB/baseDir]:  "
+    Ledger_LOG(DEBUG) << "[#initDBConfig] "
+                         "[storageDB/storagePath/stateDB/hashVersion/encoding/conditionVersion/"
+                         "baseDir]:  "
                       << m_param->mutableStorageParam().type << "/"
-                      << m_param->mutableStorageParam().path << "/" << m_param->baseDir()
-                      << std::endl;
+                      << m_param->mutableStorageParam().path << "/"
+                      << m_param->mutableStateParam().hashVersion << "/"
+                      << m_param->mutableStateParam().encoding << "/"
+                      << m_param->mutableStateParam().conditionVersion << "/"
+                      << m_param->baseDir() << std::endl;
 }
 
 /// init tx related configurations
@@ -226,6 +285,48 @@ void Ledger::initTxConfig(boost::property_tree::ptree const& pt)
     Ledger_LOG(DEBUG) << "[#initTxConfig] [txGasLimit]:" << m_param->mutableTxParam().txGasLimit;
 }
 
+/// init tx execution related configurations
+/// 1. enableParallel: execute transactions of a block in parallel, default is false
+/// 2. threadNum: threads used by parallel execution, default is 4
+/// 3. hashThreadNum: threads hashing the modified tables for the state root, default is 4
+/// 4. callThreadNum: threads executing the calls of RPC, default is 4
+/// 5. callQueueLimit: calls waiting for a thread beyond which calls are rejected, default is 1000
+/// 6. callReadOnly: calls fail at the first change of the EVM state, default is false
+void Ledger::initTxExecuteConfig(ptree const& pt)
+{
+    m_param->mutableTxExecuteParam().enableParallel =
+        pt.get<bool>("txExecute.enableParallel", false);
+    m_param->mutableTxExecuteParam().threadNum =
+        pt.get<unsigned>("txExecute.threadNum", TX_EXECUTE_THREAD_NUM_DEFAULT);
+    m_param->mutableTxExecuteParam().hashThreadNum =
+        pt.get<unsigned>("txExecute.hashThreadNum", TX_EXECUTE_HASH_THREAD_NUM_DEFAULT);
+    m_param->mutableTxExecuteParam().callThreadNum =
+        pt.get<unsigned>("txExecute.callThreadNum", TX_EXECUTE_CALL_THREAD_NUM_DEFAULT);
+    m_param->mutableTxExecuteParam().callQueueLimit =
+        pt.get<unsigned>("txExecute.callQueueLimit", TX_EXECUTE_CALL_QUEUE_LIMIT_DEFAULT);
+    m_param->mutableTxExecuteParam().callReadOnly = pt.get<bool>("txExecute.callReadOnly", false);
+    Ledger_LOG(DEBUG) << "[#initTxExecuteConfig] "
+                         "[enableParallel/threadNum/hashThreadNum/callThreadNum/callQueueLimit/"
+                         "callReadOnly]:"
+                      << m_param->mutableTxExecuteParam().enableParallel << "/"
+                      << m_param->mutableTxExecuteParam().threadNum << "/"
+                      << m_param->mutableTxExecuteParam().hashThreadNum << "/"
+                      << m_param->mutableTxExecuteParam().callThreadNum << "/"
+                      << m_param->mutableTxExecuteParam().callQueueLimit << "/"
+                      << m_param->mutableTxExecuteParam().callReadOnly;
+}
+
+void Ledger::initStorageConfig(ptree const& pt)
+{
+    m_param->mutableStorageParam().maxPendingBlocks =
+        pt.get<unsigned>("storage.maxPendingBlocks", STORAGE_MAX_PENDING_BLOCKS_DEFAULT);
+    m_param->mutableStorageParam().cacheSize =
+        pt.get<unsigned>("storage.cacheSize", STORAGE_CACHE_SIZE_DEFAULT);
+    Ledger_LOG(DEBUG) << "[#initStorageConfig] [maxPendingBlocks/cacheSize]:"
+                      << m_param->mutableStorageParam().maxPendingBlocks << "/"
+                      << m_param->mutableStorageParam().cacheSize;
+}
+
 /// init mark of this group
 void Ledger::initMark()
 {
@@ -237,6 +338,18 @@ void Ledger::initMark()
     s << m_param->mutableStateParam().type << "-";
     s << m_param->mutableConsensusParam().maxTransactions << "-";
     s << m_param->mutableTxParam().txGasLimit;
+    /// groups created before hashVersion and encoding keep their genesis block
+    if (m_param->mutableStateParam().hashVersion != STATE_HASH_VERSION_DEFAULT ||
+        m_param->mutableStateParam().encoding != STATE_ENCODING_DEFAULT)
+    {
+        s << "-" << m_param->mutableStateParam().hashVersion << "-"
+          << m_param->mutableStateParam().encoding;
+    }
+    /// and groups created before conditionVersion
+    if (m_param->mutableStateParam().conditionVersion != STATE_CONDITION_VERSION_DEFAULT)
+    {
+        s << "-" << m_param->mutableStateParam().conditionVersion;
+    }
     m_param->mutableGenesisParam().genesisMark = s.str();
     Ledger_LOG(DEBUG) << "[#initMark] [genesisMark]:  "
                       << m_param->mutableGenesisParam().genesisMark << std::endl;
@@ -255,6 +368,7 @@ bool Ledger::initTxPool()
     m_txPool = std::make_shared<dev::txpool::TxPool>(
         m_service, m_blockChain, protocol_id, m_param->mutableTxPoolParam().txPoolLimit);
     m_txPool->setMaxBlockLimit(SystemConfigMgr::c_blockLimit);
+    m_txPool->setVerifyThreadNum(m_param->mutableTxPoolParam().verifyThreadNum);
     Ledger_LOG(DEBUG) << "[#initLedger] [#initTxPool SUCC] [Protocol ID]:  " << protocol_id
                       << std::endl;
     return true;
@@ -275,6 +389,15 @@ bool Ledger::initBlockVerifier()
     std::shared_ptr<BlockChainImp> blockChain =
         std::dynamic_pointer_cast<BlockChainImp>(m_blockChain);
     blockVerifier->setNumberHash(boost::bind(&BlockChainImp::numberHash, blockChain, _1));
+    /// transactions can only be merged into the state of MemoryTableFactory
+    if (m_param->mutableStateParam().type == "storage")
+    {
+        blockVerifier->setParallelExecution(m_param->mutableTxExecuteParam().enableParallel,
+            m_param->mutableTxExecuteParam().threadNum);
+    }
+    blockVerifier->setCallExecution(m_param->mutableTxExecuteParam().callThreadNum,
+        m_param->mutableTxExecuteParam().callQueueLimit,
+        m_param->mutableTxExecuteParam().callReadOnly);
     m_blockVerifier = blockVerifier;
     Ledger_LOG(DEBUG) << "[#initLedger] [#initBlockVerifier SUCC]" << std::endl;
     return true;
@@ -343,6 +466,12 @@ std::shared_ptr<Sealer> Ledger::createPBFTSealer()
     pbftEngine->setStorage(m_dbInitializer->storage());
     pbftEngine->setOmitEmptyBlock(SystemConfigMgr::c_omitEmptyBlock);
     pbftEngine->setMaxTTL(m_param->mutableConsensusParam().maxTTL);
+    pbftEngine->setCompactPrepare(m_param->mutableConsensusParam().compactPrepare);
+    /// the blocks are executed on the state of the blocks being committed, only for storage state
+    if (m_param->mutableStateParam().type == "storage")
+    {
+        pbftEngine->setPipelineDepth(m_param->mutableConsensusParam().pipelineDepth);
+    }
     return pbftSealer;
 }
 
@@ -421,7 +550,8 @@ bool Ledger::initSync()
     dev::PROTOCOL_ID protocol_id = getGroupProtoclID(m_groupId, ProtocolID::BlockSync);
     dev::h256 genesisHash = m_blockChain->getBlockByNumber(int64_t(0))->headerHash();
     m_sync = std::make_shared<SyncMaster>(m_service, m_txPool, m_blockChain, m_blockVerifier,
-        protocol_id, m_keyPair.pub(), genesisHash, m_param->mutableSyncParam().idleWaitMs);
+        protocol_id, m_keyPair.pub(), genesisHash, m_param->mutableSyncParam().idleWaitMs,
+        m_param->mutableSyncParam().prepareThreadNum);
     Ledger_LOG(DEBUG) << "[#initLedger] [#initSync SUCC]" << std::endl;
     return true;
 }
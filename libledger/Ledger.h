@@ -106,6 +106,9 @@ public:
         Ledger_LOG(INFO) << "[#stopAll...]" << std::endl;
         m_sealer->stop();
         m_sync->stop();
+        /// write the blocks still held by the write-behind storage
+        if (m_dbInitializer)
+            m_dbInitializer->flushStorage();
     }
 
     virtual ~Ledger(){};
@@ -151,8 +154,11 @@ private:
     void initTxPoolConfig(boost::property_tree::ptree const& pt);
     void initConsensusConfig(boost::property_tree::ptree const& pt);
     void initSyncConfig(boost::property_tree::ptree const& pt);
+    void initConsensusIniConfig(boost::property_tree::ptree const& pt);
     void initDBConfig(boost::property_tree::ptree const& pt);
     void initTxConfig(boost::property_tree::ptree const& pt);
+    void initTxExecuteConfig(boost::property_tree::ptree const& pt);
+    void initStorageConfig(boost::property_tree::ptree const& pt);
     void initMark();
     /// load ini config of group
     void initIniConfig(std::string const& iniConfigFileName);
@@ -33,9 +33,12 @@ namespace ledger
 {
 /// forward class declaration
 #define SYNC_TX_POOL_SIZE_DEFAULT 102400
+#define TX_POOL_VERIFY_THREAD_NUM_DEFAULT 2
 struct TxPoolParam
 {
     uint64_t txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
+    /// threads recovering the senders of transactions received from peers
+    unsigned verifyThreadNum = TX_POOL_VERIFY_THREAD_NUM_DEFAULT;
 };
 struct ConsensusParam
 {
@@ -44,6 +47,10 @@ struct ConsensusParam
     dev::h512s observerList = dev::h512s();
     uint64_t maxTransactions;
     uint8_t maxTTL;
+    /// broadcast the blocks of prepareReq by the hashes of their transactions
+    bool compactPrepare = false;
+    /// blocks reaching consensus committed in background, 0 commits synchronously
+    unsigned pipelineDepth = 0;
     /// unsigned intervalBlockTime;
     uint64_t minElectTime;
     uint64_t maxElectTime;
@@ -57,10 +64,13 @@ struct AMDBParam
 };
 
 #define SYNC_IDLE_WAIT_DEFAULT 30
+#define SYNC_PREPARE_THREAD_NUM_DEFAULT 2
 struct SyncParam
 {
     /// TODO: syncParam related
     unsigned idleWaitMs = SYNC_IDLE_WAIT_DEFAULT;
+    /// threads decoding downloaded blocks ahead of execution
+    unsigned prepareThreadNum = SYNC_PREPARE_THREAD_NUM_DEFAULT;
 };
 
 struct GenesisParam
@@ -68,19 +78,52 @@ struct GenesisParam
     std::string genesisMark;
     std::string nodeListMark;
 };
+#define STORAGE_MAX_PENDING_BLOCKS_DEFAULT 4
+#define STORAGE_CACHE_SIZE_DEFAULT 32
 struct StorageParam
 {
     std::string type;
     std::string path;
+    /// committed blocks held in memory while written to disk, 0 writes synchronously
+    unsigned maxPendingBlocks = STORAGE_MAX_PENDING_BLOCKS_DEFAULT;
+    /// MB of rows cached across blocks, 0 disables the cache
+    unsigned cacheSize = STORAGE_CACHE_SIZE_DEFAULT;
 };
+#define STATE_HASH_VERSION_DEFAULT 1
+#define STATE_ENCODING_DEFAULT 1
+#define STATE_CONDITION_VERSION_DEFAULT 1
 struct StateParam
 {
     std::string type;
+    /// dev::storage::StateHashVersion, set in the genesis file since it changes the state root
+    unsigned hashVersion = STATE_HASH_VERSION_DEFAULT;
+    /// dev::storagestate::StorageEncoding, set in the genesis file for the same reason
+    unsigned encoding = STATE_ENCODING_DEFAULT;
+    /// dev::storage::ConditionVersion, set in the genesis file since it changes query results
+    unsigned conditionVersion = STATE_CONDITION_VERSION_DEFAULT;
 };
 struct TxParam
 {
     uint64_t txGasLimit;
 };
+#define TX_EXECUTE_THREAD_NUM_DEFAULT 4
+#define TX_EXECUTE_HASH_THREAD_NUM_DEFAULT 4
+#define TX_EXECUTE_CALL_THREAD_NUM_DEFAULT 4
+#define TX_EXECUTE_CALL_QUEUE_LIMIT_DEFAULT 1000
+struct TxExecuteParam
+{
+    /// only takes effect when the state type is storage
+    bool enableParallel = false;
+    unsigned threadNum = TX_EXECUTE_THREAD_NUM_DEFAULT;
+    /// threads hashing the modified tables for the state root of storage state
+    unsigned hashThreadNum = TX_EXECUTE_HASH_THREAD_NUM_DEFAULT;
+    /// threads executing the calls of RPC, 0 executes each call on the thread receiving it
+    unsigned callThreadNum = TX_EXECUTE_CALL_THREAD_NUM_DEFAULT;
+    /// calls waiting for a thread beyond which new calls are rejected
+    unsigned callQueueLimit = TX_EXECUTE_CALL_QUEUE_LIMIT_DEFAULT;
+    /// execute the calls as static calls, which fail at the first change of the EVM state
+    bool callReadOnly = false;
+};
 class LedgerParam : public LedgerParamInterface
 {
 public:
@@ -94,6 +137,7 @@ public:
     StorageParam& mutableStorageParam() override { return m_storageParam; }
     StateParam& mutableStateParam() override { return m_stateParam; }
     TxParam& mutableTxParam() override { return m_txParam; }
+    TxExecuteParam& mutableTxExecuteParam() override { return m_txExecuteParam; }
 
 private:
     TxPoolParam m_txPoolParam;
@@ -105,6 +149,7 @@ private:
     StorageParam m_storageParam;
     StateParam m_stateParam;
     TxParam m_txParam;
+    TxExecuteParam m_txExecuteParam;
 };
 }  // namespace ledger
 }  // namespace dev
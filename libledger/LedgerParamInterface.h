@@ -42,6 +42,7 @@ struct AMDBParam;
 struct StorageParam;
 struct StateParam;
 struct TxParam;
+struct TxExecuteParam;
 class LedgerParamInterface
 {
 public:
@@ -57,6 +58,7 @@ public:
     virtual StorageParam& mutableStorageParam() = 0;
     virtual StateParam& mutableStateParam() = 0;
     virtual TxParam& mutableTxParam() = 0;
+    virtual TxExecuteParam& mutableTxExecuteParam() = 0;
 };
 }  // namespace ledger
 }  // namespace dev
@@ -157,6 +157,36 @@ public:
         });
     }
 
+    /// gather-write several buffers with a single write operation
+    virtual void asyncWrite(std::shared_ptr<SocketFace> socket,
+        std::vector<boost::asio::const_buffer> const& buffers, ReadWriteHandler handler)
+    {
+        auto type = m_type;
+        m_ioService->post([type, socket, buffers, handler]() {
+            if (socket->isConnected())
+            {
+                switch (type)
+                {
+                case TCP_ONLY:
+                {
+                    ba::async_write(socket->ref(), buffers, handler);
+                    break;
+                }
+                case SSL:
+                {
+                    ba::async_write(socket->sslref(), buffers, handler);
+                    break;
+                }
+                case WEBSOCKET:
+                {
+                    socket->wsref().async_write(buffers, handler);
+                    break;
+                }
+                }
+            }
+        });
+    }
+
     virtual void asyncRead(std::shared_ptr<SocketFace> socket,
         boost::asio::mutable_buffers_1 buffers, ReadWriteHandler handler)
     {
@@ -128,6 +128,10 @@ public:
 
     virtual void encode(bytes& buffer) = 0;
     virtual ssize_t decode(const byte* buffer, size_t size) = 0;
+
+    /// the encoded message shared by all the sessions it's sent to, nullptr if it hasn't been
+    /// encoded in advance
+    virtual std::shared_ptr<bytes> encodedBuffer() { return nullptr; }
 };
 
 class MessageFactory : public std::enable_shared_from_this<MessageFactory>
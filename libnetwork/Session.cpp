@@ -28,6 +28,7 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/CommonJS.h>
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/Metrics.h>
 #include <libdevcore/easylog.h>
 #include <chrono>
 
@@ -39,6 +40,20 @@
 using namespace dev;
 using namespace dev::network;
 
+/// limits of the messages gathered by a single write
+static const size_t c_maxWriteMessages = 64;
+static const size_t c_maxWriteBytes = 1024 * 1024;
+/// log the metrics once every that many writes
+static const uint64_t c_metricsLogInterval = 10000;
+
+/// the metrics of all the sessions together
+static MetricGauge::Ptr s_writeQueueMessages = MetricsRegistry::instance().gauge(
+    "fisco_p2p_write_queue_messages", "messages queued to be written to the peers");
+static MetricCounter::Ptr s_writtenMessages = MetricsRegistry::instance().counter(
+    "fisco_p2p_written_messages_total", "messages written to the peers");
+static MetricHistogram::Ptr s_writeBytes = MetricsRegistry::instance().histogram(
+    "fisco_p2p_write_bytes", "bytes gathered by a write to a peer");
+
 Session::Session()
 {
     m_seq2Callback = std::make_shared<std::unordered_map<uint32_t, ResponseCallback::Ptr>>();
@@ -47,6 +62,7 @@ Session::Session()
 Session::~Session()
 {
     SESSION_LOG(INFO) << "Closing peer session";
+    s_writeQueueMessages->sub(m_writeQueue.size());
 
     try
     {
@@ -96,8 +112,13 @@ void Session::asyncSendMessage(
 
     addSeqCallback(message->seq(), handler);
 
-    auto buffer = std::make_shared<bytes>();
-    message->encode(*buffer);
+    /// a message multicasted to several sessions is encoded only once
+    auto buffer = message->encodedBuffer();
+    if (!buffer)
+    {
+        buffer = std::make_shared<bytes>();
+        message->encode(*buffer);
+    }
 
     send(buffer);
 }
@@ -125,13 +146,27 @@ void Session::send(std::shared_ptr<bytes> _msg)
         Guard l(x_writeQueue);
 
         m_writeQueue.push(make_pair(_msg, u256(utcTime())));
+        s_writeQueueMessages->add();
+        m_maxWriteQueueSize = std::max(m_maxWriteQueueSize, m_writeQueue.size());
     }
 
     write();
 }
 
-void Session::onWrite(
-    boost::system::error_code ec, std::size_t length, std::shared_ptr<bytes> buffer)
+Session::Metrics Session::metrics() const
+{
+    Metrics sessionMetrics;
+    sessionMetrics.writes = m_writes;
+    sessionMetrics.messages = m_writtenMessages;
+    sessionMetrics.bytes = m_writtenBytes;
+    Guard l(x_writeQueue);
+    sessionMetrics.writeQueueSize = m_writeQueue.size();
+    sessionMetrics.maxWriteQueueSize = m_maxWriteQueueSize;
+    return sessionMetrics;
+}
+
+void Session::onWrite(boost::system::error_code ec, std::size_t length,
+    std::shared_ptr<std::vector<std::shared_ptr<bytes>>> buffers)
 {
     if (!actived())
     {
@@ -147,6 +182,20 @@ void Session::onWrite(
             drop(TCPError);
             return;
         }
+        m_writtenMessages += buffers->size();
+        m_writtenBytes += length;
+        s_writtenMessages->add(buffers->size());
+        s_writeBytes->observe(length);
+        if (++m_writes % c_metricsLogInterval == 0)
+        {
+            auto sessionMetrics = metrics();
+            SESSION_LOG(DEBUG) << "[#onWrite] [writes/messages/bytesPerWrite/writeQueue/"
+                                  "maxWriteQueue]: "
+                               << sessionMetrics.writes << "/" << sessionMetrics.messages << "/"
+                               << sessionMetrics.bytes / sessionMetrics.writes << "/"
+                               << sessionMetrics.writeQueueSize << "/"
+                               << sessionMetrics.maxWriteQueueSize;
+        }
         {
             Guard l(x_writeQueue);
             if (m_writing)
@@ -193,30 +242,38 @@ void Session::write()
 
         m_writing = true;
 
-        std::pair<std::shared_ptr<bytes>, u256> task;
-        u256 enter_time = u256(0);
-
         if (m_writeQueue.empty())
         {
             m_writing = false;
             return;
         }
 
-        task = m_writeQueue.top();
-        m_writeQueue.pop();
+        /// gather the queued messages into one write, the buffers are kept alive until onWrite
+        auto buffers = std::make_shared<std::vector<std::shared_ptr<bytes>>>();
+        std::vector<boost::asio::const_buffer> gathered;
+        size_t gatheredBytes = 0;
+        while (!m_writeQueue.empty() && buffers->size() < c_maxWriteMessages &&
+               (buffers->empty() ||
+                   gatheredBytes + m_writeQueue.top().first->size() <= c_maxWriteBytes))
+        {
+            auto buffer = m_writeQueue.top().first;
+            m_writeQueue.pop();
+            s_writeQueueMessages->sub();
+            gatheredBytes += buffer->size();
+            gathered.push_back(boost::asio::buffer(*buffer));
+            buffers->push_back(buffer);
+        }
 
-        enter_time = task.second;
         auto session = shared_from_this();
-        auto buffer = task.first;
 
         auto server = m_server.lock();
         if (server && server->haveNetwork())
         {
             if (m_socket->isConnected())
             {
-                server->asioInterface()->asyncWrite(m_socket, boost::asio::buffer(*buffer),
+                server->asioInterface()->asyncWrite(m_socket, gathered,
                     boost::bind(&Session::onWrite, session, boost::asio::placeholders::error,
-                        boost::asio::placeholders::bytes_transferred, buffer));
+                        boost::asio::placeholders::bytes_transferred, buffers));
             }
             else
             {
@@ -403,19 +460,19 @@ void Session::doRead()
                     s->drop(TCPError);
                     return;
                 }
-                s->m_data.insert(
-                    s->m_data.end(), s->m_recvBuffer, s->m_recvBuffer + bytesTransferred);
+                s->m_recvBuffer.commit(bytesTransferred);
 
                 while (true)
                 {
                     Message::Ptr message = s->m_messageFactory->buildMessage();
-                    ssize_t result = message->decode(s->m_data.data(), s->m_data.size());
+                    auto data = s->m_recvBuffer.data();
+                    ssize_t result = message->decode(data.data(), data.size());
                     if (result > 0)
                     {
                         /// SESSION_LOG(TRACE) << "Decode success: " << result;
                         NetworkException e(P2PExceptionType::Success, "Success");
                         s->onMessage(e, s, message);
-                        s->m_data.erase(s->m_data.begin(), s->m_data.begin() + result);
+                        s->m_recvBuffer.consume(result);
                     }
                     else if (result == 0)
                     {
@@ -436,8 +493,9 @@ void Session::doRead()
 
         if (m_socket->isConnected())
         {
+            auto space = m_recvBuffer.prepare();
             server->asioInterface()->asyncReadSome(
-                m_socket, boost::asio::buffer(m_recvBuffer, BUFFER_LENGTH), asyncRead);
+                m_socket, boost::asio::buffer(space.data(), space.size()), asyncRead);
         }
         else
         {
@@ -24,8 +24,10 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/ReceiveBuffer.h>
 #include <boost/heap/priority_queue.hpp>
 #include <array>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -49,7 +51,19 @@ public:
     virtual ~Session();
 
     typedef std::shared_ptr<Session> Ptr;
-    static const size_t BUFFER_LENGTH = 1024;
+    /// a read asks for that many bytes at least, the size of a TLS record
+    static const size_t BUFFER_LENGTH = 16 * 1024;
+
+    struct Metrics
+    {
+        /// write operations, each one gathers the messages queued when it starts
+        uint64_t writes = 0;
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        /// messages waiting to be written, now and at most
+        size_t writeQueueSize = 0;
+        size_t maxWriteQueueSize = 0;
+    };
 
     virtual void start() override;
     virtual void disconnect(DisconnectReason _reason) override;
@@ -117,12 +131,13 @@ public:
         }
     }
 
+    Metrics metrics() const;
+
 private:
     void send(std::shared_ptr<bytes> _msg);
 
     void doRead();
-    std::vector<byte> m_data;  ///< Buffer for ingress packet data.
-    byte m_recvBuffer[BUFFER_LENGTH];
+    ReceiveBuffer m_recvBuffer{BUFFER_LENGTH};  ///< Buffer for ingress packet data.
 
     /// Drop the connection for the reason @a _r.
     void drop(DisconnectReason _r);
@@ -132,9 +147,10 @@ private:
 
     void onTimeout(const boost::system::error_code& error, uint32_t seq);
 
-    /// Perform a single round of the write operation. This could end up calling itself
-    /// asynchronously.
-    void onWrite(boost::system::error_code ec, std::size_t length, std::shared_ptr<bytes> buffer);
+    /// Perform a single round of the write operation, which writes all the queued messages at once.
+    /// This could end up calling itself asynchronously.
+    void onWrite(boost::system::error_code ec, std::size_t length,
+        std::shared_ptr<std::vector<std::shared_ptr<bytes>>> buffers);
     void write();
 
     /// call by doRead() to deal with mesage
@@ -160,7 +176,12 @@ private:
         boost::heap::compare<QueueCompare>, boost::heap::stable<true>>
         m_writeQueue;
     bool m_writing = false;
-    Mutex x_writeQueue;
+    mutable Mutex x_writeQueue;
+
+    std::atomic<uint64_t> m_writes = {0};
+    std::atomic<uint64_t> m_writtenMessages = {0};
+    std::atomic<uint64_t> m_writtenBytes = {0};
+    size_t m_maxWriteQueueSize = 0;
 
     mutable Mutex x_info;
 
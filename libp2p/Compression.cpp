@@ -0,0 +1,154 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file Compression.cpp
+ *  @date 20190402
+ */
+
+#include "Compression.h"
+#include "Common.h"
+#include <cryptopp/filters.h>
+#include <cryptopp/zdeflate.h>
+#include <cryptopp/zinflate.h>
+#include <chrono>
+
+using namespace dev;
+using namespace dev::p2p;
+
+const std::string Compression::CODEC = "deflate";
+const size_t Compression::DEFAULT_THRESHOLD;
+const size_t Compression::MAX_DECOMPRESSED_LENGTH;
+
+/// the fastest deflate level, the payloads are mostly RLP that compresses well even so
+static const int c_deflateLevel = 1;
+/// compressed data is inflated in chunks of that size, so that the decompressed data can't grow
+/// far beyond the length announced by the peer
+static const size_t c_inflateChunk = 4096;
+/// log the metrics once every that many compressed payloads
+static const uint64_t c_metricsLogInterval = 1000;
+
+static uint64_t elapsedMicroseconds(std::chrono::steady_clock::time_point const& _start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start)
+        .count();
+}
+
+Compression& Compression::instance()
+{
+    static Compression s_instance;
+    return s_instance;
+}
+
+bool Compression::compress(bytesConstRef _data, bytes& _compressed)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::string deflated;
+    CryptoPP::Deflator deflator(new CryptoPP::StringSink(deflated), c_deflateLevel);
+    deflator.Put(_data.data(), _data.size());
+    deflator.MessageEnd();
+    m_compressTime += elapsedMicroseconds(start);
+
+    if (deflated.size() + sizeof(uint32_t) >= _data.size())
+    {
+        ++m_incompressible;
+        return false;
+    }
+    uint32_t length = htonl(_data.size());
+    _compressed.clear();
+    _compressed.reserve(sizeof(length) + deflated.size());
+    _compressed.insert(_compressed.end(), (byte*)&length, (byte*)&length + sizeof(length));
+    _compressed.insert(_compressed.end(), deflated.begin(), deflated.end());
+
+    m_rawBytes += _data.size();
+    m_compressedBytes += _compressed.size();
+    if (++m_compressed % c_metricsLogInterval == 0)
+    {
+        auto compressionMetrics = metrics();
+        P2PMSG_LOG(INFO) << "[#Compression] [compressed/incompressible/ratio/avgCompressTime/"
+                            "decompressed/avgDecompressTime]: "
+                         << compressionMetrics.compressed << "/"
+                         << compressionMetrics.incompressible << "/"
+                         << (double)compressionMetrics.compressedBytes /
+                                compressionMetrics.rawBytes
+                         << "/" << compressionMetrics.compressTime / compressionMetrics.compressed
+                         << "/" << compressionMetrics.decompressed << "/"
+                         << (compressionMetrics.decompressed ?
+                                    compressionMetrics.decompressTime /
+                                        compressionMetrics.decompressed :
+                                    0);
+    }
+    return true;
+}
+
+void Compression::decompress(bytesConstRef _compressed, bytes& _data)
+{
+    if (_compressed.size() < sizeof(uint32_t))
+    {
+        BOOST_THROW_EXCEPTION(
+            DecompressionFailed() << errinfo_comment("compressed payload is too short"));
+    }
+    size_t length = ntohl(*((uint32_t*)_compressed.data()));
+    if (length > MAX_DECOMPRESSED_LENGTH)
+    {
+        BOOST_THROW_EXCEPTION(
+            DecompressionFailed() << errinfo_comment("decompressed payload is too long"));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string inflated;
+    try
+    {
+        CryptoPP::Inflator inflator(new CryptoPP::StringSink(inflated));
+        for (size_t offset = sizeof(uint32_t); offset < _compressed.size();
+             offset += c_inflateChunk)
+        {
+            inflator.Put(_compressed.data() + offset,
+                std::min(c_inflateChunk, _compressed.size() - offset));
+            if (inflated.size() > length)
+            {
+                break;
+            }
+        }
+        inflator.MessageEnd();
+    }
+    catch (CryptoPP::Exception const& e)
+    {
+        BOOST_THROW_EXCEPTION(DecompressionFailed() << errinfo_comment(e.what()));
+    }
+    if (inflated.size() != length)
+    {
+        BOOST_THROW_EXCEPTION(DecompressionFailed()
+                              << errinfo_comment("decompressed payload has a wrong length"));
+    }
+    _data.assign(inflated.begin(), inflated.end());
+
+    m_decompressTime += elapsedMicroseconds(start);
+    ++m_decompressed;
+}
+
+Compression::Metrics Compression::metrics() const
+{
+    Metrics compressionMetrics;
+    compressionMetrics.compressed = m_compressed;
+    compressionMetrics.incompressible = m_incompressible;
+    compressionMetrics.rawBytes = m_rawBytes;
+    compressionMetrics.compressedBytes = m_compressedBytes;
+    compressionMetrics.decompressed = m_decompressed;
+    compressionMetrics.compressTime = m_compressTime;
+    compressionMetrics.decompressTime = m_decompressTime;
+    return compressionMetrics;
+}
@@ -0,0 +1,77 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file Compression.h
+ *  @date 20190402
+ */
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/Exceptions.h>
+#include <atomic>
+
+namespace dev
+{
+namespace p2p
+{
+DEV_SIMPLE_EXCEPTION(DecompressionFailed);
+
+/// compresses the payloads of p2p messages with deflate at its fastest level
+/// compressed payload: original length (uint32, big-endian) + deflate stream
+class Compression
+{
+public:
+    /// name of the codec advertised to the peers
+    static const std::string CODEC;
+    /// payloads smaller than that aren't worth compressing
+    static const size_t DEFAULT_THRESHOLD = 1024;
+    /// a decompressed payload is never larger than that
+    static const size_t MAX_DECOMPRESSED_LENGTH = 64 * 1024 * 1024;
+
+    struct Metrics
+    {
+        uint64_t compressed = 0;
+        /// payloads that didn't shrink and were sent as they are
+        uint64_t incompressible = 0;
+        uint64_t rawBytes = 0;
+        uint64_t compressedBytes = 0;
+        uint64_t decompressed = 0;
+        /// microseconds spent compressing and decompressing
+        uint64_t compressTime = 0;
+        uint64_t decompressTime = 0;
+    };
+
+    static Compression& instance();
+
+    /// returns false if the compressed payload wouldn't be smaller than _data
+    bool compress(bytesConstRef _data, bytes& _compressed);
+    /// throws DecompressionFailed if _compressed is corrupted
+    void decompress(bytesConstRef _compressed, bytes& _data);
+
+    Metrics metrics() const;
+
+private:
+    std::atomic<uint64_t> m_compressed = {0};
+    std::atomic<uint64_t> m_incompressible = {0};
+    std::atomic<uint64_t> m_rawBytes = {0};
+    std::atomic<uint64_t> m_compressedBytes = {0};
+    std::atomic<uint64_t> m_decompressed = {0};
+    std::atomic<uint64_t> m_compressTime = {0};
+    std::atomic<uint64_t> m_decompressTime = {0};
+};
+
+}  // namespace p2p
+}  // namespace dev
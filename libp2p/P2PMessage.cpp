@@ -21,6 +21,7 @@
 
 #include "P2PMessage.h"
 #include "Common.h"
+#include "Compression.h"
 
 using namespace dev;
 using namespace dev::p2p;
@@ -42,6 +43,42 @@ void P2PMessage::encode(bytes& buffer)
     buffer.insert(buffer.end(), m_buffer->begin(), m_buffer->end());
 }
 
+std::shared_ptr<P2PMessage> P2PMessage::compressedMessage(size_t _threshold)
+{
+    if (m_buffer->size() < _threshold || (m_packetType & COMPRESSED_FLAG))
+    {
+        return nullptr;
+    }
+    if (!m_compressionTried)
+    {
+        m_compressionTried = true;
+        auto compressedBuffer = std::make_shared<bytes>();
+        if (Compression::instance().compress(ref(*m_buffer), *compressedBuffer))
+        {
+            auto compressed = std::make_shared<P2PMessage>();
+            compressed->setProtocolID(m_protocolID);
+            compressed->setPacketType(m_packetType | COMPRESSED_FLAG);
+            compressed->setSeq(m_seq);
+            compressed->setBuffer(compressedBuffer);
+            compressed->setLength(HEADER_LENGTH + compressedBuffer->size());
+            /// shared by the sessions just like the uncompressed message
+            if (m_encoded)
+            {
+                compressed->encodeOnce();
+            }
+            m_compressed = compressed;
+        }
+    }
+    return m_compressed;
+}
+
+void P2PMessage::encodeOnce()
+{
+    auto encoded = std::make_shared<bytes>();
+    encode(*encoded);
+    m_encoded = encoded;
+}
+
 ssize_t P2PMessage::decode(const byte* buffer, size_t size)
 {
     if (size < HEADER_LENGTH)
@@ -49,6 +86,7 @@ ssize_t P2PMessage::decode(const byte* buffer, size_t size)
         return dev::network::PACKET_INCOMPLETE;
     }
 
+    invalidate();
     int32_t offset = 0;
     m_length = ntohl(*((uint32_t*)&buffer[offset]));
 
@@ -68,6 +106,29 @@ ssize_t P2PMessage::decode(const byte* buffer, size_t size)
     m_packetType = ntohs(*((PACKET_TYPE*)&buffer[offset]));
     offset += sizeof(m_packetType);
     m_seq = ntohl(*((uint32_t*)&buffer[offset]));
+    if (m_packetType & COMPRESSED_FLAG)
+    {
+        if (m_length < HEADER_LENGTH)
+        {
+            return dev::network::PACKET_ERROR;
+        }
+        auto data = std::make_shared<bytes>();
+        try
+        {
+            Compression::instance().decompress(
+                bytesConstRef(&buffer[HEADER_LENGTH], m_length - HEADER_LENGTH), *data);
+        }
+        catch (std::exception& e)
+        {
+            P2PMSG_LOG(ERROR) << "[#decode] decompress failed [EINFO]: " << e.what();
+            return dev::network::PACKET_ERROR;
+        }
+        ssize_t length = m_length;
+        m_buffer = data;
+        m_packetType &= ~COMPRESSED_FLAG;
+        m_length = HEADER_LENGTH + m_buffer->size();
+        return length;
+    }
     ///< TODO: assign to std::move
     m_buffer->assign(&buffer[HEADER_LENGTH], &buffer[HEADER_LENGTH] + m_length - HEADER_LENGTH);
 
@@ -82,6 +143,7 @@ void P2PMessage::encodeAMOPBuffer(std::string const& topic)
         return;
     }
 
+    invalidate();
     ///< new buffer format:topic lenght + topic data + ori buffer data
     m_buffer->insert(m_buffer->begin(), topic.begin(), topic.end());
     uint32_t topicLen = htonl(topic.size());
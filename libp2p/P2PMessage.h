@@ -38,24 +38,52 @@ public:
 
     const static size_t HEADER_LENGTH = 12;
     const static size_t MAX_LENGTH = 1024 * 1024;  ///< The maximum length of data is 1M.
+    ///< Set in the packet type of a message whose payload is compressed, only sent to the peers
+    ///< that advertised they can decompress it.
+    const static PACKET_TYPE COMPRESSED_FLAG = 0x8000;
 
     P2PMessage() { m_buffer = std::make_shared<bytes>(); }
 
     virtual ~P2PMessage() {}
 
     virtual uint32_t length() override { return m_length; }
-    virtual void setLength(uint32_t _length) { m_length = _length; }
+    virtual void setLength(uint32_t _length)
+    {
+        if (_length != m_length)
+            invalidate();
+        m_length = _length;
+    }
 
     virtual PROTOCOL_ID protocolID() { return m_protocolID; }
-    virtual void setProtocolID(PROTOCOL_ID _protocolID) { m_protocolID = _protocolID; }
+    virtual void setProtocolID(PROTOCOL_ID _protocolID)
+    {
+        if (_protocolID != m_protocolID)
+            invalidate();
+        m_protocolID = _protocolID;
+    }
     virtual PACKET_TYPE packetType() { return m_packetType; }
-    virtual void setPacketType(PACKET_TYPE _packetType) { m_packetType = _packetType; }
+    virtual void setPacketType(PACKET_TYPE _packetType)
+    {
+        if (_packetType != m_packetType)
+            invalidate();
+        m_packetType = _packetType;
+    }
 
     virtual uint32_t seq() override { return m_seq; }
-    virtual void setSeq(uint32_t _seq) { m_seq = _seq; }
+    virtual void setSeq(uint32_t _seq)
+    {
+        if (_seq != m_seq)
+            invalidate();
+        m_seq = _seq;
+    }
 
     virtual std::shared_ptr<bytes> buffer() { return m_buffer; }
-    virtual void setBuffer(std::shared_ptr<bytes> _buffer) { m_buffer = _buffer; }
+    virtual void setBuffer(std::shared_ptr<bytes> _buffer)
+    {
+        if (_buffer != m_buffer)
+            invalidate();
+        m_buffer = _buffer;
+    }
 
     virtual bool isRequestPacket() override { return (m_protocolID > 0); }
     virtual PROTOCOL_ID getResponceProtocolID()
@@ -72,6 +100,16 @@ public:
     /// returned.
     virtual ssize_t decode(const byte* buffer, size_t size) override;
 
+    ///< Encode the message once for all the peers it's multicasted to, the sessions then share the
+    ///< encoded buffer. The data in buffer() shouldn't be changed after that.
+    void encodeOnce();
+    virtual std::shared_ptr<bytes> encodedBuffer() override { return m_encoded; }
+
+    ///< The message with its payload compressed, nullptr if the payload is shorter than _threshold
+    ///< or doesn't shrink. Compressed once for all the peers it's sent to, the first call isn't
+    ///< thread safe, so a multicast message is compressed before it's shared.
+    std::shared_ptr<P2PMessage> compressedMessage(size_t _threshold);
+
     ///< This buffer param is the m_buffer member stored in struct Messger, and the topic info will
     ///< be encoded in buffer.
     void encodeAMOPBuffer(std::string const& topic);
@@ -98,19 +136,32 @@ public:
     }
 
 private:
+    void invalidate()
+    {
+        m_encoded.reset();
+        m_compressed.reset();
+        m_compressionTried = false;
+    }
+
     uint32_t m_length = 0;            ///< m_length = HEADER_LENGTH + length(m_buffer)
     PROTOCOL_ID m_protocolID = 0;     ///< message type, the first two bytes of information, when
                                       ///< greater than 0 is the ID of the request package.
     PACKET_TYPE m_packetType = 0;     ///< message sub type, the second two bytes of information
     uint32_t m_seq = 0;               ///< the message identify
     std::shared_ptr<bytes> m_buffer;  ///< message data
+    std::shared_ptr<bytes> m_encoded;  ///< set by encodeOnce
+    std::shared_ptr<P2PMessage> m_compressed;  ///< set by compressedMessage
+    bool m_compressionTried = false;
 };
 
 enum AMOPPacketType
 {
     SendTopicSeq = 1,
     RequestTopics = 2,
-    SendTopics = 3
+    SendTopics = 3,
+    ///< The codecs a node can decompress, sent once a session starts. Nodes without compression
+    ///< support ignore it, so compressed payloads are never sent to them.
+    SendCodecs = 4
 };
 
 class P2PMessageFactory : public dev::network::MessageFactory
@@ -20,11 +20,13 @@
  */
 
 #include "P2PSession.h"
+#include "Compression.h"
 #include "Service.h"
 #include <libdevcore/Common.h>
 #include <libnetwork/Common.h>
 #include <libnetwork/Host.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 
 using namespace dev;
 using namespace dev::p2p;
@@ -36,10 +38,30 @@ void P2PSession::start()
         m_run = true;
 
         m_session->start();
+        sendCodecs();
         heartBeat();
     }
 }
 
+void P2PSession::sendCodecs()
+{
+    auto service = m_service.lock();
+    if (service && service->actived() && m_session->isConnected())
+    {
+        auto message =
+            std::dynamic_pointer_cast<P2PMessage>(service->p2pMessageFactory()->buildMessage());
+
+        message->setProtocolID(dev::eth::ProtocolID::Topic);
+        message->setPacketType(AMOPPacketType::SendCodecs);
+        std::shared_ptr<bytes> buffer = std::make_shared<bytes>(
+            Compression::CODEC.begin(), Compression::CODEC.end());
+        message->setBuffer(buffer);
+        message->setLength(P2PMessage::HEADER_LENGTH + message->buffer()->size());
+
+        m_session->asyncSendMessage(message);
+    }
+}
+
 void P2PSession::stop(dev::network::DisconnectReason reason)
 {
     if (m_run)
@@ -213,6 +235,16 @@ void P2PSession::onTopicMessage(P2PMessage::Ptr message)
 
                 break;
             }
+            case AMOPPacketType::SendCodecs:
+            {
+                std::string s((const char*)message->buffer()->data(), message->buffer()->size());
+                std::vector<std::string> codecs;
+                boost::split(codecs, s, boost::is_any_of("\t"));
+                m_peerDecompresses =
+                    std::find(codecs.begin(), codecs.end(), Compression::CODEC) != codecs.end();
+                SESSION_LOG(DEBUG) << "Received codecs: [" << s << "] from " << m_nodeID.hex();
+                break;
+            }
             default:
             {
                 SESSION_LOG(ERROR) << "Unknown topic packet type: " << message->packetType();
@@ -25,6 +25,7 @@
 #include <libnetwork/Common.h>
 #include <libnetwork/Session.h>
 #include <libp2p/Common.h>
+#include <atomic>
 #include <memory>
 
 namespace dev
@@ -71,7 +72,13 @@ public:
         m_topics = topics;
     }
 
+    /// the peer advertised it can decompress the payloads compressed by Compression
+    virtual bool peerDecompresses() { return m_peerDecompresses; }
+
 private:
+    /// tell the peer which codecs it may compress the payloads with
+    void sendCodecs();
+
     dev::network::SessionFace::Ptr m_session;
     NodeID m_nodeID;
 
@@ -82,6 +89,7 @@ private:
     uint32_t failTimes = 0;
     std::shared_ptr<boost::asio::deadline_timer> m_timer;
     bool m_run = false;
+    std::atomic<bool> m_peerDecompresses = {false};
 
     const uint32_t HEARTBEAT_INTERVEL = 5000;
     const uint32_t MAX_IDLE = HEARTBEAT_INTERVEL * 10;
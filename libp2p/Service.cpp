@@ -380,7 +380,17 @@ void Service::asyncSendMessageByNodeID(NodeID nodeID, P2PMessage::Ptr message,
                 message->setSeq(m_p2pMessageFactory->newSeq());
             }
             auto session = it->second;
-            session->session()->asyncSendMessage(message, options,
+            /// the peer answers with the same seq, whether the request was compressed or not
+            auto toSend = message;
+            if (m_compression && session->peerDecompresses())
+            {
+                auto compressed = message->compressedMessage(m_compressionThreshold);
+                if (compressed)
+                {
+                    toSend = compressed;
+                }
+            }
+            session->session()->asyncSendMessage(toSend, options,
                 [session, callback](
                     dev::network::NetworkException e, dev::network::Message::Ptr message) {
                     P2PMessage::Ptr p2pMessage = std::dynamic_pointer_cast<P2PMessage>(message);
@@ -560,6 +570,7 @@ void Service::asyncMulticastMessageByTopic(std::string topic, P2PMessage::Ptr me
     P2PMSG_LOG(DEBUG) << "[#asyncMulticastMessageByTopic] [node size]: " << nodeIDsToSend.size();
     try
     {
+        prepareMulticast(message, nodeIDsToSend.size());
         for (auto nodeID : nodeIDsToSend)
         {
             asyncSendMessageByNodeID(
@@ -578,6 +589,7 @@ void Service::asyncMulticastMessageByNodeIDList(NodeIDs nodeIDs, P2PMessage::Ptr
                        << nodeIDs.size();
     try
     {
+        prepareMulticast(message, nodeIDs.size());
         for (auto nodeID : nodeIDs)
         {
             asyncSendMessageByNodeID(
@@ -601,6 +613,7 @@ void Service::asyncBroadcastMessage(P2PMessage::Ptr message, dev::network::Optio
             sessions = m_sessions;
         }
 
+        prepareMulticast(message, sessions.size());
         for (auto s : sessions)
         {
             asyncSendMessageByNodeID(
@@ -613,6 +626,26 @@ void Service::asyncBroadcastMessage(P2PMessage::Ptr message, dev::network::Optio
     }
 }
 
+void Service::prepareMulticast(P2PMessage::Ptr message, size_t peers)
+{
+    if (peers < 2)
+    {
+        return;
+    }
+    /// fill in what asyncSendMessageByNodeID would, so that every peer gets the same encoding
+    message->setLength(P2PMessage::HEADER_LENGTH + message->buffer()->size());
+    if (message->seq() == 0 && m_p2pMessageFactory)
+    {
+        message->setSeq(m_p2pMessageFactory->newSeq());
+    }
+    message->encodeOnce();
+    /// the sessions only read the compressed copy, they don't race to create it
+    if (m_compression)
+    {
+        message->compressedMessage(m_compressionThreshold);
+    }
+}
+
 bool Service::isSessionInNodeIDList(NodeID const& targetNodeID, NodeIDs const& nodeIDs)
 {
     for (auto const& nodeID : nodeIDs)
@@ -24,6 +24,7 @@
  */
 
 #pragma once
+#include "Compression.h"
 #include "P2PInterface.h"
 #include "P2PMessage.h"
 #include "P2PSession.h"
@@ -131,6 +132,14 @@ public:
         m_p2pMessageFactory = _p2pMessageFactory;
     }
 
+    /// compress the payloads not shorter than _threshold sent to the peers that can
+    /// decompress them
+    virtual void setCompression(bool _enable, size_t _threshold)
+    {
+        m_compression = _enable;
+        m_compressionThreshold = _threshold;
+    }
+
     virtual KeyPair keyPair() { return m_alias; }
     virtual void setKeyPair(KeyPair keyPair) { m_alias = keyPair; }
     void updateStaticNodes(
@@ -139,6 +148,9 @@ public:
 private:
     NodeIDs getPeersByTopic(std::string const& topic);
 
+    /// encode and compress a message sent to several peers once, instead of once per session
+    void prepareMulticast(P2PMessage::Ptr message, size_t peers);
+
     bool isSessionInNodeIDList(NodeID const& targetNodeID, NodeIDs const& nodeIDs);
 
     std::map<dev::network::NodeIPEndpoint, NodeID> m_staticNodes;
@@ -173,6 +185,9 @@ private:
 
     bool m_run = false;
 
+    bool m_compression = false;
+    size_t m_compressionThreshold = Compression::DEFAULT_THRESHOLD;
+
     std::string printSessionInfos(P2PSessionInfos const& sessionInfos) const;
 };
 
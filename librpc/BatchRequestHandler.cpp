@@ -0,0 +1,101 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @file BatchRequestHandler.cpp
+ * @date 2019-04-01
+ */
+#include "BatchRequestHandler.h"
+#include "Common.h"
+#include <json/json.h>
+#include <jsonrpccpp/common/exception.h>
+#include <boost/exception/diagnostic_information.hpp>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::rpc;
+
+BatchRequestHandler::BatchRequestHandler(
+    jsonrpc::IClientConnectionHandler* _handler, size_t _threadNum)
+  : m_handler(_handler), m_threadNum(_threadNum)
+{
+    if (_threadNum > 0)
+    {
+        m_threadPool = make_shared<dev::ThreadPool>("rpcBatch", _threadNum);
+    }
+}
+
+void BatchRequestHandler::HandleRequest(const string& _request, string& _response)
+{
+    size_t begin = _request.find_first_not_of(" \t\r\n");
+    Json::Value batch;
+    if (!m_threadPool || begin == string::npos || _request[begin] != '[' ||
+        !Json::Reader().parse(_request, batch, false) || !batch.isArray() || batch.size() < 2)
+    {
+        m_handler->HandleRequest(_request, _response);
+        return;
+    }
+
+    /// the requests of a batch are independent, whatever group they are sent to
+    vector<string> responses(batch.size());
+    size_t workerNum = min(m_threadNum, (size_t)batch.size());
+    m_threadPool->runAndWait(workerNum, [&](size_t _worker) {
+        Json::FastWriter writer;
+        for (size_t i = _worker; i < batch.size(); i += workerNum)
+        {
+            try
+            {
+                m_handler->HandleRequest(writer.write(batch[(Json::ArrayIndex)i]), responses[i]);
+            }
+            catch (std::exception& e)
+            {
+                RPC_LOG(ERROR) << "[#HandleRequest] batch request failed, [EINFO]: "
+                               << boost::diagnostic_information(e);
+                /// answered like the other requests, unless it's a notification
+                Json::Value const& request = batch[(Json::ArrayIndex)i];
+                if (request.isObject() && request.isMember("id"))
+                {
+                    Json::Value error;
+                    error["jsonrpc"] = "2.0";
+                    error["id"] = request["id"];
+                    error["error"]["code"] = jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR;
+                    error["error"]["message"] = e.what();
+                    responses[i] = writer.write(error);
+                }
+            }
+        }
+    });
+
+    /// notifications have no response, a batch of notifications has no response either
+    _response.clear();
+    for (auto& response : responses)
+    {
+        while (!response.empty() && response.back() == '\n')
+        {
+            response.pop_back();
+        }
+        if (response.empty())
+        {
+            continue;
+        }
+        _response += _response.empty() ? "[" : ",";
+        _response += response;
+    }
+    if (!_response.empty())
+    {
+        _response += "]\n";
+    }
+}
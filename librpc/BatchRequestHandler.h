@@ -0,0 +1,50 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @file BatchRequestHandler.h
+ * @date 2019-04-01
+ */
+#pragma once
+
+#include <jsonrpccpp/server/iclientconnectionhandler.h>
+#include <libdevcore/ThreadPool.h>
+#include <string>
+
+#define RPC_BATCH_THREAD_NUM_DEFAULT 4
+
+namespace dev
+{
+namespace rpc
+{
+/// handles the requests of a JSON-RPC 2.0 batch in parallel, other requests are passed to the
+/// protocol handler as they are
+class BatchRequestHandler : public jsonrpc::IClientConnectionHandler
+{
+public:
+    /// _threadNum: threads handling the requests of a batch, 0 handles them one by one
+    BatchRequestHandler(jsonrpc::IClientConnectionHandler* _handler, size_t _threadNum);
+    virtual ~BatchRequestHandler() {}
+
+    void HandleRequest(const std::string& _request, std::string& _response) override;
+
+private:
+    jsonrpc::IClientConnectionHandler* m_handler;
+    size_t m_threadNum;
+    dev::ThreadPool::Ptr m_threadPool;
+};
+
+}  // namespace rpc
+}  // namespace dev
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "BatchRequestHandler.h"
 #include <jsonrpccpp/common/exception.h>
 #include <jsonrpccpp/common/procedure.h>
 #include <jsonrpccpp/server/abstractserverconnector.h>
@@ -91,6 +92,8 @@ public:
         m_handler->AddProcedure(jsonrpc::Procedure(
             "rpc_modules", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL));
         m_implementedModules = Json::objectValue;
+        m_batchHandler.reset(
+            new dev::rpc::BatchRequestHandler(m_handler.get(), RPC_BATCH_THREAD_NUM_DEFAULT));
     }
     inline virtual void modules(const Json::Value& request, Json::Value& response)
     {
@@ -100,6 +103,12 @@ public:
 
     virtual ~ModularServer() { StopListening(); }
 
+    /// threads handling the requests of a batch, to be set before adding the connectors
+    void setBatchThreadNum(size_t _threadNum)
+    {
+        m_batchHandler.reset(new dev::rpc::BatchRequestHandler(m_handler.get(), _threadNum));
+    }
+
     virtual bool StartListening()
     {
         for (auto const& connector : m_connectors)
@@ -135,7 +144,7 @@ public:
     unsigned addConnector(jsonrpc::AbstractServerConnector* _connector)
     {
         m_connectors.emplace_back(_connector);
-        _connector->SetHandler(m_handler.get());
+        _connector->SetHandler(m_batchHandler.get());
         return m_connectors.size() - 1;
     }
 
@@ -147,6 +156,8 @@ public:
 protected:
     std::vector<std::unique_ptr<jsonrpc::AbstractServerConnector>> m_connectors;
     std::unique_ptr<jsonrpc::IProtocolHandler> m_handler;
+    /// the handler of the connectors, passing requests other than batches to m_handler
+    std::unique_ptr<dev::rpc::BatchRequestHandler> m_batchHandler;
     /// Mapping for implemented modules, to be filled by subclasses during construction.
     Json::Value m_implementedModules;
 };
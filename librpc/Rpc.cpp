@@ -897,3 +897,41 @@ std::string Rpc::sendRawTransaction(int _groupID, const std::string& _rlp)
             JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, boost::diagnostic_information(e)));
     }
 }
+
+std::vector<std::pair<ImportResult, dev::h256>> Rpc::submitTransactions(
+    int _groupID, std::vector<bytesConstRef> const& _rlps)
+{
+    auto txPool = ledgerManager()->txPool(_groupID);
+    if (!txPool)
+        BOOST_THROW_EXCEPTION(
+            JsonRpcException(RPCExceptionType::GroupID, RPCMsg[RPCExceptionType::GroupID]));
+
+    std::vector<std::pair<ImportResult, dev::h256>> results(
+        _rlps.size(), std::make_pair(ImportResult::Malformed, dev::h256()));
+    Transactions txs;
+    std::vector<size_t> decoded;
+    txs.reserve(_rlps.size());
+    for (size_t i = 0; i < _rlps.size(); ++i)
+    {
+        try
+        {
+            /// signatures are checked by batchImport on the verifying threads of the pool
+            txs.emplace_back(_rlps[i], CheckTransaction::None);
+            decoded.push_back(i);
+        }
+        catch (std::exception& e)
+        {
+            RPC_LOG(WARNING) << "[#submitTransactions] invalid transaction [index/EINFO]: " << i
+                             << "/" << boost::diagnostic_information(e);
+        }
+    }
+
+    auto importResults = txPool->batchImport(txs);
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        results[decoded[i]] = std::make_pair(importResults[i], txs[i].sha3());
+    }
+    RPC_LOG(INFO) << "[#submitTransactions] [groupID/transactions/decoded]: " << _groupID << "/"
+                  << _rlps.size() << "/" << decoded.size();
+    return results;
+}
@@ -92,6 +92,12 @@ public:
     virtual Json::Value call(int _groupID, const Json::Value& request) override;
     virtual std::string sendRawTransaction(int _groupID, const std::string& _rlp) override;
 
+    /// submit raw transactions to the pool of _groupID without the hex and JSON of
+    /// sendRawTransaction, returns the import result and the hash of each transaction, a
+    /// transaction which can't be decoded is Malformed with zero hash
+    std::vector<std::pair<dev::eth::ImportResult, h256>> submitTransactions(
+        int _groupID, std::vector<bytesConstRef> const& _rlps);
+
 protected:
     std::shared_ptr<dev::ledger::LedgerManager> ledgerManager() { return m_ledgerManager; }
     std::shared_ptr<dev::ledger::LedgerManager> m_ledgerManager;
@@ -0,0 +1,192 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CachedStorage.cpp
+ *  @date 20190325
+ */
+
+#include "CachedStorage.h"
+#include "Common.h"
+#include <libdevcore/easylog.h>
+
+using namespace dev;
+using namespace dev::storage;
+
+/// bookkeeping bytes of a row and of an entry besides their strings
+static const size_t c_rowOverhead = 128;
+static const size_t c_entryOverhead = 64;
+
+CachedStorage::CachedStorage(Storage::Ptr _backend, size_t _capacity)
+  : m_backend(_backend), m_shardCapacity(_capacity / c_shardNum)
+{}
+
+Entries::Ptr CachedStorage::select(
+    h256 hash, int num, const std::string& table, const std::string& key)
+{
+    std::string rowKey = table + "_" + key;
+    Shard& rowShard = shard(rowKey);
+    {
+        Guard l(rowShard.lock);
+        auto it = rowShard.index.find(rowKey);
+        if (it != rowShard.index.end())
+        {
+            rowShard.rows.splice(rowShard.rows.begin(), rowShard.rows, it->second);
+            m_hits++;
+            return copyEntries(it->second->entries);
+        }
+    }
+
+    m_misses++;
+    uint64_t commitSeq = m_commitSeq;
+    Entries::Ptr entries = m_backend->select(hash, num, table, key);
+    {
+        Guard l(rowShard.lock);
+        if (commitSeq % 2 == 0 && commitSeq == m_commitSeq)
+        {
+            update(rowShard, rowKey, copyEntries(entries));
+        }
+    }
+    return entries;
+}
+
+size_t CachedStorage::commit(
+    h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash)
+{
+    Guard l(x_commit);
+    m_commitSeq++;
+    size_t total = 0;
+    try
+    {
+        total = m_backend->commit(hash, num, datas, blockHash);
+    }
+    catch (...)
+    {
+        /// the backend may have written part of the rows
+        for (auto& rowShard : m_shards)
+        {
+            Guard shardLock(rowShard.lock);
+            rowShard.rows.clear();
+            rowShard.index.clear();
+            rowShard.size = 0;
+        }
+        m_commitSeq++;
+        throw;
+    }
+
+    for (auto& tableData : datas)
+    {
+        for (auto& it : tableData->data)
+        {
+            /// the backend keeps the former row if the committed one is empty
+            if (it.second->size() == 0u)
+            {
+                continue;
+            }
+            std::string rowKey = tableData->tableName + "_" + it.first;
+            Shard& rowShard = shard(rowKey);
+            Guard shardLock(rowShard.lock);
+            update(rowShard, rowKey, committedRow(it.second, hash, num));
+        }
+    }
+    m_commitSeq++;
+
+    auto cacheMetrics = metrics();
+    STORAGE_LOG(DEBUG) << "[#CachedStorage] [#commit] [num/hits/misses/evictions/rows/size]: "
+                       << num << "/" << cacheMetrics.hits << "/" << cacheMetrics.misses << "/"
+                       << cacheMetrics.evictions << "/" << cacheMetrics.rows << "/"
+                       << cacheMetrics.size;
+    return total;
+}
+
+bool CachedStorage::onlyDirty()
+{
+    return false;
+}
+
+CachedStorage::Metrics CachedStorage::metrics() const
+{
+    Metrics cacheMetrics;
+    cacheMetrics.hits = m_hits;
+    cacheMetrics.misses = m_misses;
+    cacheMetrics.evictions = m_evictions;
+    cacheMetrics.capacity = m_shardCapacity * c_shardNum;
+    for (auto& rowShard : m_shards)
+    {
+        Guard l(rowShard.lock);
+        cacheMetrics.rows += rowShard.index.size();
+        cacheMetrics.size += rowShard.size;
+    }
+    return cacheMetrics;
+}
+
+void CachedStorage::update(Shard& rowShard, const std::string& key, Entries::Ptr entries)
+{
+    auto it = rowShard.index.find(key);
+    if (it != rowShard.index.end())
+    {
+        rowShard.size -= it->second->size;
+        rowShard.rows.erase(it->second);
+        rowShard.index.erase(it);
+    }
+
+    size_t size = rowSize(key, entries);
+    /// too large to be cached
+    if (size > m_shardCapacity)
+    {
+        return;
+    }
+    while (rowShard.size + size > m_shardCapacity)
+    {
+        auto& last = rowShard.rows.back();
+        rowShard.size -= last.size;
+        rowShard.index.erase(last.key);
+        rowShard.rows.pop_back();
+        m_evictions++;
+    }
+    rowShard.rows.push_front(Row{key, entries, size});
+    rowShard.index[key] = rowShard.rows.begin();
+    rowShard.size += size;
+}
+
+Entries::Ptr CachedStorage::copyEntries(Entries::Ptr entries)
+{
+    Entries::Ptr copied = std::make_shared<Entries>();
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        for (auto& field : *(entries->get(i)->fields()))
+        {
+            entry->setField(field.first, field.second);
+        }
+        entry->setDirty(false);
+        copied->addEntry(entry);
+    }
+    return copied;
+}
+
+size_t CachedStorage::rowSize(const std::string& key, Entries::Ptr entries)
+{
+    size_t size = c_rowOverhead + key.size();
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        size += c_entryOverhead;
+        for (auto& field : *(entries->get(i)->fields()))
+        {
+            size += field.first.size() + field.second.size();
+        }
+    }
+    return size;
+}
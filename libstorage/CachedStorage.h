@@ -0,0 +1,107 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file CachedStorage.h
+ *  @date 20190325
+ */
+#pragma once
+
+#include "Storage.h"
+#include <libdevcore/Guards.h>
+#include <array>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace dev
+{
+namespace storage
+{
+/// LRU cache of the rows selected from a storage which commits whole rows, shared by all the
+/// MemoryTableFactory of a group. Rows committed through it replace the cached ones.
+/// Callers always get a copy of the cached entries, since MemoryTable modifies them.
+class CachedStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<CachedStorage> Ptr;
+
+    struct Metrics
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t rows = 0;
+        /// estimated bytes of the cached rows
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    /// _capacity: the max estimated bytes of the cached rows
+    CachedStorage(Storage::Ptr _backend, size_t _capacity);
+    virtual ~CachedStorage() {}
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override;
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override;
+    virtual bool onlyDirty() override;
+
+    Metrics metrics() const;
+
+private:
+    struct Row
+    {
+        std::string key;
+        Entries::Ptr entries;
+        size_t size;
+    };
+    struct Shard
+    {
+        /// most recently used first
+        std::list<Row> rows;
+        std::unordered_map<std::string, std::list<Row>::iterator> index;
+        size_t size = 0;
+        mutable Mutex lock;
+    };
+
+    static const size_t c_shardNum = 16;
+
+    Shard& shard(const std::string& key)
+    {
+        return m_shards[std::hash<std::string>()(key) % c_shardNum];
+    }
+    /// add or replace a row, the shard lock must be held
+    void update(Shard& shard, const std::string& key, Entries::Ptr entries);
+    static Entries::Ptr copyEntries(Entries::Ptr entries);
+    static size_t rowSize(const std::string& key, Entries::Ptr entries);
+
+    Storage::Ptr m_backend;
+    size_t m_shardCapacity;
+    std::array<Shard, c_shardNum> m_shards;
+
+    /// odd while a commit is updating the backend and the cache, rows selected from the
+    /// backend are only cached if no commit happened in between
+    std::atomic<uint64_t> m_commitSeq = {0};
+    Mutex x_commit;
+
+    std::atomic<uint64_t> m_hits = {0};
+    std::atomic<uint64_t> m_misses = {0};
+    std::atomic<uint64_t> m_evictions = {0};
+};
+
+}  // namespace storage
+
+}  // namespace dev
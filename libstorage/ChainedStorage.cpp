@@ -0,0 +1,106 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file ChainedStorage.cpp
+ *  @date 20190405
+ */
+
+#include "ChainedStorage.h"
+
+using namespace dev;
+using namespace dev::storage;
+
+ChainedStorage::ChainedStorage(Storage::Ptr _parent, h256 const& _hash, int64_t _num,
+    const std::vector<TableData::Ptr>& _datas)
+  : m_parent(_parent), m_hash(_hash), m_num(_num)
+{
+    for (auto& tableData : _datas)
+    {
+        m_tables.insert(tableData->tableName);
+        for (auto& it : tableData->data)
+        {
+            /// the entries of the block go on changing while it's committed
+            m_rows[std::make_pair(tableData->tableName, it.first)] =
+                committedRow(it.second, _hash, _num);
+        }
+    }
+}
+
+Entries::Ptr ChainedStorage::select(
+    h256 hash, int num, const std::string& table, const std::string& key)
+{
+    Storage::Ptr parent;
+    {
+        ReadGuard l(x_rows);
+        auto it = m_rows.find(std::make_pair(table, key));
+        if (it != m_rows.end())
+        {
+            /// the caller modifies the entries it selects
+            return committedRow(it->second, m_hash, m_num);
+        }
+        parent = m_parent;
+    }
+    return parent->select(hash, num, table, key);
+}
+
+size_t ChainedStorage::commit(
+    h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash)
+{
+    return parent()->commit(hash, num, datas, blockHash);
+}
+
+bool ChainedStorage::onlyDirty()
+{
+    return parent()->onlyDirty();
+}
+
+void ChainedStorage::release()
+{
+    WriteGuard l(x_rows);
+    m_rows.clear();
+    m_released = true;
+    /// the blocks are committed in order, a released parent has already skipped its own parents
+    auto chained = std::dynamic_pointer_cast<ChainedStorage>(m_parent);
+    if (chained)
+    {
+        ReadGuard parentLock(chained->x_rows);
+        if (chained->m_released)
+        {
+            m_parent = chained->m_parent;
+        }
+    }
+}
+
+h256 ChainedStorage::blockHash(int64_t _num) const
+{
+    Storage::Ptr parent;
+    for (auto chained = this; chained && chained->m_num >= _num;
+         chained = dynamic_cast<ChainedStorage const*>(parent.get()))
+    {
+        if (chained->m_num == _num)
+        {
+            return chained->m_hash;
+        }
+        parent = chained->parent();
+    }
+    return h256();
+}
+
+Storage::Ptr ChainedStorage::parent() const
+{
+    ReadGuard l(x_rows);
+    return m_parent;
+}
@@ -0,0 +1,76 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file ChainedStorage.h
+ *  @date 20190405
+ */
+#pragma once
+
+#include "Storage.h"
+#include <libdevcore/Guards.h>
+#include <map>
+#include <set>
+
+namespace dev
+{
+namespace storage
+{
+/// State of a block which has been executed but not committed yet, for executing the next block
+/// before it's committed. The rows written by the block are served from a copy taken when the
+/// block is handed over to be committed, the other rows from the storage the block was executed
+/// on. commit() goes through to that storage, so the next block is committed the usual way once
+/// the block has been committed.
+class ChainedStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<ChainedStorage> Ptr;
+
+    /// _datas: the rows written by block _num of hash _hash, executed on _parent
+    ChainedStorage(Storage::Ptr _parent, h256 const& _hash, int64_t _num,
+        const std::vector<TableData::Ptr>& _datas);
+    virtual ~ChainedStorage() {}
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override;
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override;
+    virtual bool onlyDirty() override;
+
+    /// whether the block wrote rows of the table
+    bool written(const std::string& _table) const { return m_tables.count(_table); }
+    /// the block has been committed to the parent, drop the copied rows and the parents
+    /// committed before it, so that a chain of blocks doesn't grow with the blocks committed
+    void release();
+    /// the hash of block _num if it's this block or one below it in the chain, h256() if it's
+    /// not, the blocks released skip their parents
+    h256 blockHash(int64_t _num) const;
+
+    Storage::Ptr parent() const;
+
+private:
+    Storage::Ptr m_parent;
+    h256 m_hash;
+    int64_t m_num;
+    /// the rows written by the block, by table and key
+    std::map<std::pair<std::string, std::string>, Entries::Ptr> m_rows;
+    std::set<std::string> m_tables;
+    bool m_released = false;
+    mutable SharedMutex x_rows;
+};
+
+}  // namespace storage
+
+}  // namespace dev
@@ -23,12 +23,24 @@
 #include "Table.h"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
+#include <boost/lexical_cast.hpp>
 #include <memory>
 
 using namespace dev;
 using namespace dev::storage;
 
+const uint8_t LevelDBStorage::c_binaryRowVersion;
+
+static MetricHistogram::Ptr s_getTime = MetricsRegistry::instance().histogram(
+    "fisco_leveldb_get_microseconds", "Time spent reading a row from leveldb");
+static MetricHistogram::Ptr s_writeTime = MetricsRegistry::instance().histogram(
+    "fisco_leveldb_write_microseconds", "Time spent writing the rows of a block to leveldb");
+static MetricCounter::Ptr s_writtenRows = MetricsRegistry::instance().counter(
+    "fisco_leveldb_written_rows_total", "Rows written to leveldb");
+
 Entries::Ptr LevelDBStorage::select(
     h256 hash, int num, const std::string& table, const std::string& key)
 {
@@ -37,7 +49,11 @@ Entries::Ptr LevelDBStorage::select(
         std::string entryKey = table + "_" + key;
         std::string value;
         ReadGuard l(m_remoteDBMutex);
-        auto s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(entryKey), &value);
+        leveldb::Status s;
+        {
+            ScopedMetricTimer timer(s_getTime);
+            s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(entryKey), &value);
+        }
         if (!s.ok() && !s.IsNotFound())
         {
             STORAGE_LEVELDB_LOG(ERROR) << "Query leveldb failed:" + s.ToString();
@@ -48,23 +64,10 @@ Entries::Ptr LevelDBStorage::select(
         Entries::Ptr entries = std::make_shared<Entries>();
         if (!s.IsNotFound())
         {
-            // parse json
-            std::stringstream ssIn;
-            ssIn << value;
-
-            Json::Value valueJson;
-            ssIn >> valueJson;
-
-            Json::Value values = valueJson["values"];
-            for (auto it = values.begin(); it != values.end(); ++it)
+            Entries::Ptr values = decodeEntries(value);
+            for (size_t i = 0; i < values->size(); ++i)
             {
-                Entry::Ptr entry = std::make_shared<Entry>();
-
-                for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
-                {
-                    entry->setField(valueIt.key().asString(), valueIt->asString());
-                }
-
+                Entry::Ptr entry = values->get(i);
                 if (entry->getStatus() == Entry::Status::NORMAL)
                 {
                     entry->setDirty(false);
@@ -106,40 +109,30 @@ size_t LevelDBStorage::commit(
                     continue;
                 }
                 std::string entryKey = it->tableName + "_" + dataIt.first;
-                Json::Value entry;
-
-                for (size_t i = 0; i < dataIt.second->size(); ++i)
-                {
-                    Json::Value value;
-                    for (auto fieldIt : *(dataIt.second->get(i)->fields()))
-                    {
-                        value[fieldIt.first] = fieldIt.second;
-                    }
-                    value["_hash_"] = hash.hex();
-                    value["_num_"] = num;
-                    entry["values"].append(value);
-                }
-
-                std::stringstream ssOut;
-                ssOut << entry;
+                std::string value = encodeEntries(dataIt.second, hash, num);
 
-                batch->insertSlice(leveldb::Slice(entryKey), leveldb::Slice(ssOut.str()));
+                batch->insertSlice(leveldb::Slice(entryKey), leveldb::Slice(value));
                 ++total;
                 STORAGE_LEVELDB_LOG(TRACE)
-                    << "leveldb commit key:" << entryKey << " data size:" << ssOut.tellp();
+                    << "leveldb commit key:" << entryKey << " data size:" << value.size();
             }
         }
 
         leveldb::WriteOptions writeOptions;
         writeOptions.sync = false;
         WriteGuard l(m_remoteDBMutex);
-        auto s = m_db->Write(writeOptions, &(batch->writeBatch()));
+        leveldb::Status s;
+        {
+            ScopedMetricTimer timer(s_writeTime);
+            s = m_db->Write(writeOptions, &(batch->writeBatch()));
+        }
         if (!s.ok())
         {
             STORAGE_LEVELDB_LOG(ERROR) << "Commit leveldb failed: " << s.ToString();
 
             BOOST_THROW_EXCEPTION(StorageException(-1, "Commit leveldb exception:" + s.ToString()));
         }
+        s_writtenRows->add(total);
 
         return total;
     }
@@ -163,3 +156,164 @@ void LevelDBStorage::setDB(std::shared_ptr<dev::db::BasicLevelDB> db)
 {
     m_db = db;
 }
+
+size_t LevelDBStorage::migrate()
+{
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    /// the rows are written while iterating, the iterator reads the db as it was when created
+    WriteGuard l(m_remoteDBMutex);
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(leveldb::ReadOptions()));
+    std::shared_ptr<dev::db::LevelDBWriteBatch> batch = m_db->createWriteBatch();
+    size_t batchRows = 0;
+    size_t total = 0;
+    auto writeBatch = [&]() {
+        auto s = m_db->Write(writeOptions, &(batch->writeBatch()));
+        if (!s.ok())
+        {
+            STORAGE_LEVELDB_LOG(ERROR) << "Migrate leveldb failed: " << s.ToString();
+
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "Migrate leveldb exception:" + s.ToString()));
+        }
+        batch = m_db->createWriteBatch();
+        batchRows = 0;
+    };
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        std::string key = it->key().ToString();
+        if (key == dev::c_cipherDataKeyName)
+        {
+            continue;
+        }
+        /// read through the db rather than the iterator, which doesn't decrypt the values
+        std::string value;
+        auto s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(key), &value);
+        if (!s.ok())
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Query leveldb exception:" + s.ToString()));
+        }
+        if (value.empty() || value[0] != '{')
+        {
+            continue;
+        }
+
+        Entries::Ptr entries = decodeJsonEntries(value);
+        if (entries->size() == 0u)
+        {
+            continue;
+        }
+        /// every entry of a row is written with the same _hash_ and _num_
+        Entry::Ptr first = entries->get(0);
+        h256 hash(first->getField("_hash_"));
+        int64_t num = boost::lexical_cast<int64_t>(first->getField("_num_"));
+
+        std::string binary = encodeEntries(entries, hash, num);
+        batch->insertSlice(leveldb::Slice(key), leveldb::Slice(binary));
+        ++total;
+        if (++batchRows >= c_migrateBatchRows)
+        {
+            writeBatch();
+        }
+    }
+    if (batchRows > 0)
+    {
+        writeBatch();
+    }
+
+    STORAGE_LEVELDB_LOG(INFO) << "leveldb migrate json rows to binary, total:" << total;
+    return total;
+}
+
+std::string LevelDBStorage::encodeEntries(Entries::Ptr entries, h256 const& hash, int64_t num)
+{
+    RLPStream s;
+    s.appendList(3);
+    s << hash << u256(num);
+    s.appendList(entries->size());
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        auto fields = entries->get(i)->fields();
+        size_t count = fields->size() - fields->count("_hash_") - fields->count("_num_");
+        s.appendList(count * 2);
+        for (auto& fieldIt : *fields)
+        {
+            if (fieldIt.first == "_hash_" || fieldIt.first == "_num_")
+            {
+                continue;
+            }
+            s << fieldIt.first << fieldIt.second;
+        }
+    }
+
+    std::string value(1, char(c_binaryRowVersion));
+    value.append((char const*)s.out().data(), s.out().size());
+    return value;
+}
+
+Entries::Ptr LevelDBStorage::decodeEntries(const std::string& value)
+{
+    if (value.empty())
+    {
+        return std::make_shared<Entries>();
+    }
+    if (value[0] == '{')
+    {
+        return decodeJsonEntries(value);
+    }
+    if (uint8_t(value[0]) == c_binaryRowVersion)
+    {
+        return decodeBinaryEntries(value);
+    }
+
+    BOOST_THROW_EXCEPTION(StorageException(
+        -1, "Unknown row version:" + boost::lexical_cast<std::string>(int(uint8_t(value[0])))));
+}
+
+Entries::Ptr LevelDBStorage::decodeJsonEntries(const std::string& value)
+{
+    Entries::Ptr entries = std::make_shared<Entries>();
+
+    std::stringstream ssIn;
+    ssIn << value;
+
+    Json::Value valueJson;
+    ssIn >> valueJson;
+
+    Json::Value values = valueJson["values"];
+    for (auto it = values.begin(); it != values.end(); ++it)
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+
+        for (auto valueIt = it->begin(); valueIt != it->end(); ++valueIt)
+        {
+            entry->setField(valueIt.key().asString(), valueIt->asString());
+        }
+        entries->addEntry(entry);
+    }
+
+    return entries;
+}
+
+Entries::Ptr LevelDBStorage::decodeBinaryEntries(const std::string& value)
+{
+    Entries::Ptr entries = std::make_shared<Entries>();
+
+    RLP row(bytesConstRef((byte const*)value.data() + 1, value.size() - 1));
+    std::string hash = row[0].toHash<h256>().hex();
+    std::string num = boost::lexical_cast<std::string>(row[1].toInt<uint64_t>());
+
+    for (auto const& item : row[2])
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        for (size_t i = 0; i + 1 < item.itemCount(); i += 2)
+        {
+            entry->setField(item[i].toString(), item[i + 1].toString());
+        }
+        entry->setField("_hash_", hash);
+        entry->setField("_num_", num);
+        entries->addEntry(entry);
+    }
+
+    return entries;
+}
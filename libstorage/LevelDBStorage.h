@@ -48,7 +48,24 @@ public:
 
     void setDB(std::shared_ptr<dev::db::BasicLevelDB> db);
 
+    /// rewrite every legacy json row in the db with the binary codec, return rows converted
+    size_t migrate();
+
+    /// encode all entries of one key, _hash_ and _num_ are stored once per row
+    static std::string encodeEntries(Entries::Ptr entries, h256 const& hash, int64_t num);
+    /// decode a row written by encodeEntries or by the legacy json format
+    static Entries::Ptr decodeEntries(const std::string& value);
+
+    /// leading byte of a binary row, legacy json rows always start with '{'
+    static const uint8_t c_binaryRowVersion = 1;
+
 private:
+    static Entries::Ptr decodeJsonEntries(const std::string& value);
+    static Entries::Ptr decodeBinaryEntries(const std::string& value);
+
+    /// rows converted by migrate per write, bounding the memory taken by a large db
+    static const size_t c_migrateBatchRows = 10000;
+
     std::shared_ptr<dev::db::BasicLevelDB> m_db;
     dev::SharedMutex m_remoteDBMutex;
 };
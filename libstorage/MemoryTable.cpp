@@ -30,6 +30,9 @@
 using namespace dev;
 using namespace dev::storage;
 
+/// keys with fewer entries are scanned, building an index for them isn't worth it
+static const size_t c_minIndexedEntries = 16;
+
 void dev::storage::MemoryTable::init(const std::string& tableName)
 {
     /// STORAGE_LOG(DEBUG) << "Init MemoryTable:" << tableName;
@@ -52,6 +55,12 @@ Entries::Ptr dev::storage::MemoryTable::select(const std::string& key, Condition
                 // << m_tableInfo->name << " selects:" << entries->size() << " record(s)";
 
                 m_cache.insert(std::make_pair(key, entries));
+
+                if (m_recorder)
+                {
+                    std::vector<Change::Record> records;
+                    m_recorder(shared_from_this(), Change::Select, key, records);
+                }
             }
         }
         else
@@ -64,11 +73,19 @@ Entries::Ptr dev::storage::MemoryTable::select(const std::string& key, Condition
             STORAGE_LOG(DEBUG) << "Can't find data";
             return std::make_shared<Entries>();
         }
-        auto indexes = processEntries(entries, condition);
+        expose(key, entries);
+        size_t offset = 0;
+        size_t limit = 0;
+        if (m_conditionVersion >= BIGINT_CONDITION)
+        {
+            offset = condition->getOffset();
+            limit = condition->getCount() == 0 ? 0 : offset + condition->getCount();
+        }
+        auto indexes = processEntries(key, entries, condition, limit);
         Entries::Ptr resultEntries = std::make_shared<Entries>();
-        for (auto i : indexes)
+        for (size_t i = offset; i < indexes.size(); ++i)
         {
-            resultEntries->addEntry(entries->get(i));
+            resultEntries->addEntry(entries->get(indexes[i]));
         }
         return resultEntries;
     }
@@ -119,7 +136,7 @@ int dev::storage::MemoryTable::update(
             return 0;
         }
         checkFiled(entry);
-        auto indexes = processEntries(entries, condition);
+        auto indexes = processEntries(key, entries, condition);
         std::vector<Change::Record> records;
 
         for (auto i : indexes)
@@ -132,6 +149,8 @@ int dev::storage::MemoryTable::update(
             }
         }
         m_recorder(shared_from_this(), Change::Update, key, records);
+        invalidateIndex(key);
+        acceptWrites(key);
 
         entries->setDirty(true);
 
@@ -181,17 +200,18 @@ int dev::storage::MemoryTable::insert(
         Change::Record record(entries->size() + 1u);
         std::vector<Change::Record> value{record};
         m_recorder(shared_from_this(), Change::Insert, key, value);
+        invalidateIndex(key);
         if (entries->size() == 0)
         {
             entries->addEntry(entry);
             m_cache.insert(std::make_pair(key, entries));
-            return 1;
         }
         else
         {
             entries->addEntry(entry);
-            return 1;
         }
+        expose(key, entries);
+        return 1;
     }
     catch (std::exception& e)
     {
@@ -231,8 +251,9 @@ int dev::storage::MemoryTable::remove(
         entries = it->second;
     }
 
-    auto indexes = processEntries(entries, condition);
+    auto indexes = processEntries(key, entries, condition);
 
+    /// removed entries stay in the index, they are filtered out by their status
     std::vector<Change::Record> records;
     for (auto i : indexes)
     {
@@ -242,6 +263,7 @@ int dev::storage::MemoryTable::remove(
         records.emplace_back(i);
     }
     m_recorder(shared_from_this(), Change::Remove, key, records);
+    acceptWrites(key);
 
     entries->setDirty(true);
 
@@ -251,25 +273,11 @@ int dev::storage::MemoryTable::remove(
 h256 dev::storage::MemoryTable::hash()
 {
     bytes data;
-    for (auto it : m_cache)
+    for (auto& it : m_cache)
     {
         if (it.second->dirty())
         {
-            data.insert(data.end(), it.first.begin(), it.first.end());
-            for (size_t i = 0; i < it.second->size(); ++i)
-            {
-                if (it.second->get(i)->dirty())
-                {
-                    for (auto fieldIt : *(it.second->get(i)->fields()))
-                    {
-                        if (isHashField(fieldIt.first))
-                        {
-                            data.insert(data.end(), fieldIt.first.begin(), fieldIt.first.end());
-                            data.insert(data.end(), fieldIt.second.begin(), fieldIt.second.end());
-                        }
-                    }
-                }
-            }
+            appendHashData(data, it.first, it.second);
         }
     }
 
@@ -278,17 +286,93 @@ h256 dev::storage::MemoryTable::hash()
         return h256();
     }
 
-    std::string str(data.begin(), data.end());
-
     bytesConstRef bR(data.data(), data.size());
     h256 hash = dev::sha256(bR);
 
     return hash;
 }
 
+void dev::storage::MemoryTable::appendHashData(
+    bytes& data, const std::string& key, Entries::Ptr entries)
+{
+    data.insert(data.end(), key.begin(), key.end());
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        if (entries->get(i)->dirty())
+        {
+            for (auto& fieldIt : *(entries->get(i)->fields()))
+            {
+                if (isHashField(fieldIt.first))
+                {
+                    data.insert(data.end(), fieldIt.first.begin(), fieldIt.first.end());
+                    data.insert(data.end(), fieldIt.second.begin(), fieldIt.second.end());
+                }
+            }
+        }
+    }
+}
+
 void dev::storage::MemoryTable::clear()
 {
     m_cache.clear();
+    m_indexes.clear();
+    m_exposedVersions.clear();
+}
+
+void dev::storage::MemoryTable::expose(const std::string& key, Entries::Ptr entries)
+{
+    uint64_t& version = m_exposedVersions[key];
+    version = std::max(version, entriesVersion(entries));
+}
+
+uint64_t dev::storage::MemoryTable::entriesVersion(Entries::Ptr entries)
+{
+    uint64_t version = 0;
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        version = std::max(version, entries->get(i)->version());
+    }
+    return version;
+}
+
+std::vector<std::string> dev::storage::MemoryTable::takeModifiedKeys()
+{
+    std::vector<std::string> keys;
+    for (auto it = m_exposedVersions.begin(); it != m_exposedVersions.end();)
+    {
+        auto cacheIt = m_cache.find(it->first);
+        if (cacheIt == m_cache.end() || !cacheIt->second)
+        {
+            it = m_exposedVersions.erase(it);
+            continue;
+        }
+        uint64_t version = entriesVersion(cacheIt->second);
+        if (version > it->second)
+        {
+            it->second = version;
+            invalidateIndex(it->first);
+            keys.push_back(it->first);
+        }
+        ++it;
+    }
+    return keys;
+}
+
+void dev::storage::MemoryTable::acceptWrites(const std::string& key)
+{
+    auto it = m_exposedVersions.find(key);
+    if (it == m_exposedVersions.end())
+    {
+        return;
+    }
+    auto cacheIt = m_cache.find(key);
+    if (cacheIt == m_cache.end() || !cacheIt->second)
+    {
+        m_exposedVersions.erase(it);
+        return;
+    }
+    /// the entries may have been replaced or removed, the version can go down
+    it->second = entriesVersion(cacheIt->second);
 }
 
 std::map<std::string, Entries::Ptr>* dev::storage::MemoryTable::data()
@@ -296,24 +380,79 @@ std::map<std::string, Entries::Ptr>* dev::storage::MemoryTable::data()
     return &m_cache;
 }
 
+bool dev::storage::MemoryTable::empty()
+{
+    if (!m_cache.empty())
+    {
+        return false;
+    }
+
+    /// an empty cache depends on every key of the table, record it as a whole table select
+    if (m_recorder)
+    {
+        std::vector<Change::Record> records;
+        m_recorder(shared_from_this(), Change::Select, "", records);
+    }
+    return true;
+}
+
 void dev::storage::MemoryTable::setStateStorage(Storage::Ptr amopDB)
 {
     m_remoteDB = amopDB;
 }
 
-std::vector<size_t> MemoryTable::processEntries(Entries::Ptr entries, Condition::Ptr condition)
+void dev::storage::MemoryTable::invalidateIndex(const std::string& key)
+{
+    m_indexes.erase(key);
+}
+
+std::vector<size_t> MemoryTable::processEntries(
+    const std::string& key, Entries::Ptr entries, Condition::Ptr condition, size_t limit)
 {
     std::vector<size_t> indexes;
-    indexes.reserve(entries->size());
+    indexes.reserve(limit == 0 ? entries->size() : std::min(limit, entries->size()));
     if (condition->getConditions()->empty())
     {
         for (size_t i = 0; i < entries->size(); ++i)
-            indexes.emplace_back(i);
+        {
+            if (limit != 0 && indexes.size() >= limit)
+            {
+                break;
+            }
+            if (m_conditionVersion < BIGINT_CONDITION ||
+                entries->get(i)->getStatus() != Entry::Status::DELETED)
+            {
+                indexes.emplace_back(i);
+            }
+        }
+        return indexes;
+    }
+
+    std::vector<size_t> candidates;
+    if (entries->size() >= c_minIndexedEntries &&
+        indexCandidates(key, entries, condition, candidates))
+    {
+        /// candidates are checked against all the conditions, in the order of a scan
+        for (auto i : candidates)
+        {
+            if (limit != 0 && indexes.size() >= limit)
+            {
+                break;
+            }
+            if (processCondition(entries->get(i), condition))
+            {
+                indexes.push_back(i);
+            }
+        }
         return indexes;
     }
 
     for (size_t i = 0; i < entries->size(); ++i)
     {
+        if (limit != 0 && indexes.size() >= limit)
+        {
+            break;
+        }
         Entry::Ptr entry = entries->get(i);
         if (processCondition(entry, condition))
         {
@@ -324,6 +463,123 @@ std::vector<size_t> MemoryTable::processEntries(Entries::Ptr entries, Condition:
     return indexes;
 }
 
+bool MemoryTable::indexCandidates(const std::string& key, Entries::Ptr entries,
+    Condition::Ptr condition, std::vector<size_t>& candidates)
+{
+    if (!m_tableInfo || m_tableInfo->indices.empty())
+    {
+        return false;
+    }
+
+    /// an equal condition selects fewer entries than a range, use it if there is one
+    auto conditions = condition->getConditions();
+    auto selected = conditions->end();
+    for (auto it = conditions->begin(); it != conditions->end(); ++it)
+    {
+        if (it->second.first == Condition::Op::ne ||
+            m_tableInfo->indices.end() == std::find(m_tableInfo->indices.begin(),
+                                              m_tableInfo->indices.end(), it->first))
+        {
+            continue;
+        }
+        if (selected == conditions->end() || it->second.first == Condition::Op::eq)
+        {
+            selected = it;
+        }
+        if (it->second.first == Condition::Op::eq)
+        {
+            break;
+        }
+    }
+    if (selected == conditions->end())
+    {
+        return false;
+    }
+
+    auto& fields = keyIndex(key, entries).fields;
+    auto indexIt = fields.find(selected->first);
+    if (indexIt == fields.end())
+    {
+        FieldIndex index;
+        for (size_t i = 0; i < entries->size(); ++i)
+        {
+            const std::string& value = entries->get(i)->getField(selected->first);
+            index.values.emplace(value, i);
+            bigint num;
+            if (parseNumber(value, num))
+            {
+                index.numbers.emplace_back(num, i);
+            }
+        }
+        std::sort(index.numbers.begin(), index.numbers.end());
+        indexIt = fields.emplace(selected->first, std::move(index)).first;
+    }
+    auto& fieldIndex = indexIt->second;
+    Condition::Op op = selected->second.first;
+    const std::string& rhs = selected->second.second;
+    if (op == Condition::Op::eq)
+    {
+        auto range = fieldIndex.values.equal_range(rhs);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            candidates.push_back(it->second);
+        }
+    }
+    else
+    {
+        /// no entry matches a bound which isn't a number
+        bigint bound;
+        if (!parseNumber(rhs, bound))
+        {
+            return true;
+        }
+        auto lower = [](const std::pair<bigint, size_t>& lhs, const bigint& rhs) {
+            return lhs.first < rhs;
+        };
+        auto upper = [](const bigint& lhs, const std::pair<bigint, size_t>& rhs) {
+            return lhs < rhs.first;
+        };
+        auto begin = fieldIndex.numbers.begin();
+        auto end = fieldIndex.numbers.end();
+        switch (op)
+        {
+        case Condition::Op::gt:
+            begin = std::upper_bound(begin, end, bound, upper);
+            break;
+        case Condition::Op::ge:
+            begin = std::lower_bound(begin, end, bound, lower);
+            break;
+        case Condition::Op::lt:
+            end = std::lower_bound(begin, end, bound, lower);
+            break;
+        case Condition::Op::le:
+            end = std::upper_bound(begin, end, bound, upper);
+            break;
+        default:
+            break;
+        }
+        for (auto it = begin; it != end; ++it)
+        {
+            candidates.push_back(it->second);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    return true;
+}
+
+MemoryTable::KeyIndex& MemoryTable::keyIndex(const std::string& key, Entries::Ptr entries)
+{
+    auto& index = m_indexes[key];
+    /// entries replaced or resized without going through this table
+    if (index.entries != entries.get() || index.size != entries->size())
+    {
+        index.entries = entries.get();
+        index.size = entries->size();
+        index.fields.clear();
+    }
+    return index;
+}
+
 bool dev::storage::MemoryTable::processCondition(Entry::Ptr entry, Condition::Ptr condition)
 {
     try
@@ -354,18 +610,21 @@ bool dev::storage::MemoryTable::processCondition(Entry::Ptr entry, Condition::Pt
             }
             else
             {
-                if (lhs.empty())
+                /// values are compared as integers of any size, an entry whose value isn't a
+                /// number doesn't match
+                bigint lhsNum;
+                bigint rhsNum;
+                if (m_conditionVersion < BIGINT_CONDITION)
                 {
-                    lhs = "0";
+                    /// throws for values which aren't an int, the entry doesn't match
+                    lhsNum = boost::lexical_cast<int>(lhs.empty() ? "0" : lhs);
+                    rhsNum = boost::lexical_cast<int>(rhs.empty() ? "0" : rhs);
                 }
-                if (rhs.empty())
+                else if (!parseNumber(lhs, lhsNum) || !parseNumber(rhs, rhsNum))
                 {
-                    rhs = "0";
+                    return false;
                 }
 
-                int lhsNum = boost::lexical_cast<int>(lhs);
-                int rhsNum = boost::lexical_cast<int>(rhs);
-
                 switch (it.second.first)
                 {
                 case Condition::Op::eq:
@@ -419,6 +678,48 @@ bool dev::storage::MemoryTable::processCondition(Entry::Ptr entry, Condition::Pt
     return true;
 }
 
+bool MemoryTable::parseNumber(const std::string& str, bigint& num)
+{
+    if (str.empty())
+    {
+        num = 0;
+        return true;
+    }
+    bool negative = str[0] == '-';
+    size_t begin = (negative || str[0] == '+') ? 1 : 0;
+    if (begin == str.size())
+    {
+        return false;
+    }
+
+    /// accumulate up to 18 digits at a time in 64 bits
+    num = 0;
+    uint64_t chunk = 0;
+    uint64_t scale = 1;
+    for (size_t i = begin; i < str.size(); ++i)
+    {
+        char c = str[i];
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        chunk = chunk * 10 + (c - '0');
+        scale *= 10;
+        if (scale == 1000000000000000000ULL)
+        {
+            num = num * scale + chunk;
+            chunk = 0;
+            scale = 1;
+        }
+    }
+    num = num * scale + chunk;
+    if (negative)
+    {
+        num = -num;
+    }
+    return true;
+}
+
 void MemoryTable::setBlockHash(h256 blockHash)
 {
     m_blockHash = blockHash;
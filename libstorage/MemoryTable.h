@@ -46,24 +46,63 @@ public:
     virtual h256 hash();
     virtual void clear();
     virtual std::map<std::string, Entries::Ptr>* data() override;
+    virtual bool empty() override;
 
     void setStateStorage(Storage::Ptr amopDB);
     void setBlockHash(h256 blockHash);
     void setBlockNum(int blockNum);
     void setTableInfo(TableInfo::Ptr tableInfo);
+    void setConditionVersion(unsigned conditionVersion) { m_conditionVersion = conditionVersion; }
 
     bool checkAuthority(Address const& _origin) const override;
+    void invalidateIndex(const std::string& key) override;
+    std::vector<std::string> takeModifiedKeys() override;
+    void acceptWrites(const std::string& key) override;
+
+    /// append the key and the hashed fields of its dirty entries, which hash() is computed over
+    static void appendHashData(bytes& data, const std::string& key, Entries::Ptr entries);
+
+    /// parse a decimal integer of any size with an optional sign, an empty string is 0
+    static bool parseNumber(const std::string& str, bigint& num);
 
 private:
-    std::vector<size_t> processEntries(Entries::Ptr entries, Condition::Ptr condition);
+    /// positions of the entries of a key ordered by the values of an indexed field
+    struct FieldIndex
+    {
+        std::multimap<std::string, size_t> values;
+        /// sorted by number, values which aren't numbers are left out
+        std::vector<std::pair<bigint, size_t> > numbers;
+    };
+    struct KeyIndex
+    {
+        Entries* entries = nullptr;
+        size_t size = 0;
+        std::map<std::string, FieldIndex> fields;
+    };
+
+    /// limit: stop after that many matched entries, 0 for all
+    std::vector<size_t> processEntries(
+        const std::string& key, Entries::Ptr entries, Condition::Ptr condition, size_t limit = 0);
     bool processCondition(Entry::Ptr entry, Condition::Ptr condition);
-    bool isHashField(const std::string& _key);
+    /// candidate positions found through an index, false if no condition can use an index
+    bool indexCandidates(const std::string& key, Entries::Ptr entries, Condition::Ptr condition,
+        std::vector<size_t>& candidates);
+    KeyIndex& keyIndex(const std::string& key, Entries::Ptr entries);
+    static bool isHashField(const std::string& _key);
     void checkFiled(Entry::Ptr entry);
+    /// the entries of key are held by the caller, record their version to find their changes
+    void expose(const std::string& key, Entries::Ptr entries);
+    static uint64_t entriesVersion(Entries::Ptr entries);
     Storage::Ptr m_remoteDB;
     TableInfo::Ptr m_tableInfo;
     std::map<std::string, Entries::Ptr> m_cache;
+    /// built for keys having enough entries and queried by indexed fields
+    std::map<std::string, KeyIndex> m_indexes;
+    /// the greatest version of the entries of the keys exposed to the callers
+    std::map<std::string, uint64_t> m_exposedVersions;
     h256 m_blockHash;
     int m_blockNum = 0;
+    unsigned m_conditionVersion = INT_CONDITION;
 };
 
 }  // namespace storage
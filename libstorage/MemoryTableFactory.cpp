@@ -20,6 +20,7 @@
  */
 #include "MemoryTableFactory.h"
 #include "CNSPrecompiled.h"
+#include "ChainedStorage.h"
 #include "Common.h"
 #include "MemoryTable.h"
 #include "SystemConfigPrecompiled.h"
@@ -28,11 +29,26 @@
 #include <libdevcore/easylog.h>
 #include <libdevcrypto/Hash.h>
 #include <boost/algorithm/string.hpp>
+#include <atomic>
 
 using namespace dev;
 using namespace dev::storage;
 using namespace std;
 
+/// modified tables fewer than it are hashed by the calling thread
+static const size_t c_minParallelHashTables = 4;
+
+/// bucket of a key in BUCKET_STATE_HASH, FNV-1a so that it is the same on every platform
+static uint8_t keyBucket(const std::string& _key)
+{
+    uint32_t hash = 2166136261u;
+    for (auto c : _key)
+    {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash & 0xff;
+}
+
 MemoryTableFactory::MemoryTableFactory() : m_blockHash(h256(0)), m_blockNum(0)
 {
     m_sysTables.push_back(SYS_MINERS);
@@ -74,6 +90,12 @@ Table::Ptr MemoryTableFactory::openTable(const string& tableName, bool authority
         tableInfo->key = entry->getField("key_field");
         string valueFields = entry->getField("value_field");
         boost::split(tableInfo->fields, valueFields, boost::is_any_of(","));
+        /// tables created before secondary indexes have no index_field
+        auto indexField = entry->fields()->find("index_field");
+        if (indexField != entry->fields()->end() && !indexField->second.empty())
+        {
+            boost::split(tableInfo->indices, indexField->second, boost::is_any_of(","));
+        }
     }
     tableInfo->fields.emplace_back(STATUS);
     tableInfo->fields.emplace_back(tableInfo->key);
@@ -84,6 +106,7 @@ Table::Ptr MemoryTableFactory::openTable(const string& tableName, bool authority
     memoryTable->setStateStorage(m_stateStorage);
     memoryTable->setBlockHash(m_blockHash);
     memoryTable->setBlockNum(m_blockNum);
+    memoryTable->setConditionVersion(m_conditionVersion);
 
     // authority flag
     if (authorityFlag)
@@ -109,10 +132,7 @@ Table::Ptr MemoryTableFactory::openTable(const string& tableName, bool authority
     }
 
     memoryTable->setTableInfo(tableInfo);
-    memoryTable->setRecorder([&](Table::Ptr _table, Change::Kind _kind, string const& _key,
-                                 vector<Change::Record>& _records) {
-        m_changeLog.emplace_back(_table, _kind, _key, _records);
-    });
+    bindRecorder(memoryTable, tableName);
 
     memoryTable->init(tableName);
     m_name2Table.insert({tableName, memoryTable});
@@ -120,11 +140,30 @@ Table::Ptr MemoryTableFactory::openTable(const string& tableName, bool authority
 }
 
 Table::Ptr MemoryTableFactory::createTable(const string& tableName, const string& keyField,
-    const std::string& valueField, bool authorigytFlag, Address const& _origin)
+    const std::string& valueField, bool authorigytFlag, Address const& _origin,
+    const std::string& indexField)
 {
     STORAGE_LOG(DEBUG) << "Create Table:" << m_blockHash << " num:" << m_blockNum
                        << " table:" << tableName;
 
+    if (!indexField.empty())
+    {
+        vector<string> valueFields;
+        vector<string> indexFields;
+        boost::split(valueFields, valueField, boost::is_any_of(","));
+        boost::split(indexFields, indexField, boost::is_any_of(","));
+        for (auto& field : indexFields)
+        {
+            if (valueFields.end() == find(valueFields.begin(), valueFields.end(), field))
+            {
+                STORAGE_LOG(ERROR) << "table:" << tableName << " index field:" << field
+                                   << " isn't a value field";
+                createTableCode = 0;
+                return nullptr;
+            }
+        }
+    }
+
     auto sysTable = openTable(SYS_TABLES, authorigytFlag);
 
     // To make sure the table exists
@@ -139,6 +178,10 @@ Table::Ptr MemoryTableFactory::createTable(const string& tableName, const string
     tableEntry->setField("table_name", tableName);
     tableEntry->setField("key_field", keyField);
     tableEntry->setField("value_field", valueField);
+    if (!indexField.empty())
+    {
+        tableEntry->setField("index_field", indexField);
+    }
     createTableCode =
         sysTable->insert(tableName, tableEntry, std::make_shared<AccessOptions>(_origin));
     if (createTableCode == -1)
@@ -161,20 +204,53 @@ void MemoryTableFactory::setBlockNum(int64_t blockNum)
 
 h256 MemoryTableFactory::hash()
 {
+    /// only the tables modified since the last hash are hashed again
+    vector<pair<Table::Ptr, TableHash*>> modified;
+    for (auto& it : m_name2Table)
+    {
+        /// the entries held by the callers may have been set without the table
+        auto keys = it.second->takeModifiedKeys();
+        for (auto& key : keys)
+        {
+            invalidateHash(it.second, key);
+        }
+        m_modifications += keys.size();
+        auto& tableHash = m_tableHashes[it.second.get()];
+        if (!tableHash.valid)
+        {
+            modified.emplace_back(it.second, &tableHash);
+        }
+    }
+
+    if (m_hashThreadPool && m_hashThreadNum > 1 && modified.size() >= c_minParallelHashTables)
+    {
+        /// tables are independent, each one is hashed by a single thread
+        std::atomic<size_t> next(0);
+        m_hashThreadPool->runAndWait(std::min(m_hashThreadNum, modified.size()), [&](size_t) {
+            for (size_t i = next++; i < modified.size(); i = next++)
+            {
+                updateTableHash(modified[i].first, *modified[i].second);
+            }
+        });
+    }
+    else
+    {
+        for (auto& it : modified)
+        {
+            updateTableHash(it.first, *it.second);
+        }
+    }
+
     bytes data;
-    /// STORAGE_LOG(DEBUG) << "this: " << this << " total table number:" << m_name2Table.size();
     for (auto& it : m_name2Table)
     {
-        auto table = it.second;
-        h256 hash = table->hash();
+        h256 const& hash = m_tableHashes[it.second.get()].hash;
         /// STORAGE_LOG(DEBUG) << "table:" << it.first << " hash:" << hash;
         if (hash == h256())
         {
             continue;
         }
-
-        bytes tableHash = table->hash().asBytes();
-        data.insert(data.end(), tableHash.begin(), tableHash.end());
+        data.insert(data.end(), hash.begin(), hash.end());
     }
     if (data.empty())
     {
@@ -192,6 +268,8 @@ void MemoryTableFactory::rollback(size_t _savepoint)
 
         // Public MemoryTable API cannot be used here because it will add another
         // change log entry.
+        invalidateHash(change.table, change.key);
+        change.table->invalidateIndex(change.key);
         switch (change.kind)
         {
         case Change::Insert:
@@ -230,7 +308,32 @@ void MemoryTableFactory::rollback(size_t _savepoint)
         default:
             break;
         }
+        change.table->acceptWrites(change.key);
         m_changeLog.pop_back();
+        ++m_modifications;
+    }
+}
+
+void MemoryTableFactory::closeCreatedTables(size_t _savepoint)
+{
+    auto sysTable = m_name2Table.find(SYS_TABLES);
+    if (sysTable == m_name2Table.end())
+    {
+        return;
+    }
+    for (size_t i = _savepoint; i < m_changeLog.size(); ++i)
+    {
+        auto& change = m_changeLog[i];
+        if (change.kind == Change::Insert && change.table == sysTable->second)
+        {
+            auto it = m_name2Table.find(change.key);
+            if (it != m_name2Table.end())
+            {
+                /// the hash is keyed by the address of the table, which may be reused
+                m_tableHashes.erase(it->second.get());
+                m_name2Table.erase(it);
+            }
+        }
     }
 }
 
@@ -279,6 +382,208 @@ void MemoryTableFactory::commitDB(h256 const& _blockHash, int64_t _blockNumber)
 
     m_name2Table.clear();
     m_changeLog.clear();
+    ++m_modifications;
+    m_tableHashes.clear();
+    m_selectedKeys.clear();
+    m_writtenKeys.clear();
+}
+
+ChainedStorage::Ptr MemoryTableFactory::chainedStorage(h256 const& _blockHash, int64_t _blockNumber)
+{
+    vector<TableData::Ptr> datas;
+    for (auto& dbIt : m_name2Table)
+    {
+        TableData::Ptr tableData = make_shared<TableData>();
+        tableData->tableName = dbIt.first;
+        /// the rows only selected are the same in the storage
+        for (auto& it : *(dbIt.second->data()))
+        {
+            for (size_t i = 0; i < it.second->size(); ++i)
+            {
+                auto entry = it.second->get(i);
+                if (entry->dirty() || entry->getStatus() != Entry::Status::NORMAL)
+                {
+                    tableData->data.insert(make_pair(it.first, it.second));
+                    break;
+                }
+            }
+        }
+        if (!tableData->data.empty())
+        {
+            datas.push_back(tableData);
+        }
+    }
+    return make_shared<ChainedStorage>(m_stateStorage, _blockHash, _blockNumber, datas);
+}
+
+bool MemoryTableFactory::conflictWith(MemoryTableFactory::Ptr _other) const
+{
+    for (auto& key : _other->m_selectedKeys)
+    {
+        /// an empty key stands for the whole table
+        if (key.second.empty() ? touched(key.first) : m_writtenKeys.count(key) != 0u)
+        {
+            return true;
+        }
+    }
+    for (auto& key : _other->m_writtenKeys)
+    {
+        if (m_writtenKeys.count(key) != 0u)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryTableFactory::merge(MemoryTableFactory::Ptr _other)
+{
+    for (auto& tableIt : _other->m_name2Table)
+    {
+        auto it = m_name2Table.find(tableIt.first);
+        if (it == m_name2Table.end())
+        {
+            bindRecorder(tableIt.second, tableIt.first);
+            m_name2Table.insert(tableIt);
+            continue;
+        }
+
+        auto data = it->second->data();
+        for (auto& dataIt : *(tableIt.second->data()))
+        {
+            invalidateHash(it->second, dataIt.first);
+            it->second->invalidateIndex(dataIt.first);
+            if (_other->m_writtenKeys.count(make_pair(tableIt.first, dataIt.first)) != 0u)
+            {
+                (*data)[dataIt.first] = dataIt.second;
+            }
+            else
+            {
+                /// only selected, the cached value is the same as the one of this factory
+                data->insert(dataIt);
+            }
+            it->second->acceptWrites(dataIt.first);
+        }
+    }
+    m_selectedKeys.insert(_other->m_selectedKeys.begin(), _other->m_selectedKeys.end());
+    m_writtenKeys.insert(_other->m_writtenKeys.begin(), _other->m_writtenKeys.end());
+    ++m_modifications;
+}
+
+void MemoryTableFactory::bindRecorder(Table::Ptr _table, const std::string& _tableName)
+{
+    _table->setRecorder([&, _tableName](Table::Ptr _table, Change::Kind _kind, string const& _key,
+                            vector<Change::Record>& _records) {
+        if (_kind == Change::Select)
+        {
+            if (m_trackAccess)
+            {
+                m_selectedKeys.emplace(_tableName, _key);
+            }
+            /// selected rows don't have dirty entries, but CONCAT_STATE_HASH hashes their keys
+            if (m_hashVersion == CONCAT_STATE_HASH)
+            {
+                invalidateHash(_table, _key);
+            }
+            return;
+        }
+        invalidateHash(_table, _key);
+        if (m_trackAccess)
+        {
+            /// rollback doesn't restore the cache exactly, so written keys are never removed
+            m_writtenKeys.emplace(_tableName, _key);
+        }
+        m_changeLog.emplace_back(_table, _kind, _key, _records);
+        ++m_modifications;
+    });
+}
+
+void MemoryTableFactory::invalidateHash(Table::Ptr const& _table, const std::string& _key)
+{
+    auto& tableHash = m_tableHashes[_table.get()];
+    tableHash.valid = false;
+    if (m_hashVersion == BUCKET_STATE_HASH && !tableHash.allDirty)
+    {
+        tableHash.dirtyKeys.insert(_key);
+    }
+}
+
+void MemoryTableFactory::updateTableHash(Table::Ptr const& _table, TableHash& _tableHash)
+{
+    if (m_hashVersion != BUCKET_STATE_HASH)
+    {
+        _tableHash.hash = _table->hash();
+        _tableHash.valid = true;
+        return;
+    }
+
+    auto data = _table->data();
+    if (_tableHash.allDirty)
+    {
+        _tableHash.buckets.clear();
+        for (auto& it : *data)
+        {
+            _tableHash.dirtyKeys.insert(it.first);
+        }
+        _tableHash.allDirty = false;
+    }
+
+    /// digest of a key is the sha256 over its dirty entries, keys without them are skipped
+    for (auto& key : _tableHash.dirtyKeys)
+    {
+        auto& bucket = _tableHash.buckets[keyBucket(key)];
+        bucket.valid = false;
+        bucket.keys.erase(key);
+        auto it = data->find(key);
+        if (it == data->end())
+        {
+            continue;
+        }
+        bytes keyData;
+        MemoryTable::appendHashData(keyData, key, it->second);
+        if (keyData.size() > key.size())
+        {
+            bucket.keys[key] = dev::sha256(&keyData);
+        }
+    }
+    _tableHash.dirtyKeys.clear();
+
+    bytes tableData;
+    for (auto it = _tableHash.buckets.begin(); it != _tableHash.buckets.end();)
+    {
+        auto& bucket = it->second;
+        if (bucket.keys.empty())
+        {
+            it = _tableHash.buckets.erase(it);
+            continue;
+        }
+        if (!bucket.valid)
+        {
+            bytes bucketData;
+            for (auto& keyIt : bucket.keys)
+            {
+                bucketData.insert(bucketData.end(), keyIt.second.begin(), keyIt.second.end());
+            }
+            bucket.hash = dev::sha256(&bucketData);
+            bucket.valid = true;
+        }
+        tableData.push_back(it->first);
+        tableData.insert(tableData.end(), bucket.hash.begin(), bucket.hash.end());
+        ++it;
+    }
+    _tableHash.hash = tableData.empty() ? h256() : dev::sha256(&tableData);
+    _tableHash.valid = true;
+}
+
+bool MemoryTableFactory::touched(const std::string& _tableName) const
+{
+    auto selected = m_selectedKeys.lower_bound(make_pair(_tableName, string()));
+    if (selected != m_selectedKeys.end() && selected->first == _tableName)
+    {
+        return true;
+    }
+    auto written = m_writtenKeys.lower_bound(make_pair(_tableName, string()));
+    return written != m_writtenKeys.end() && written->first == _tableName;
 }
 
 storage::TableInfo::Ptr MemoryTableFactory::getSysTableInfo(const std::string& tableName)
@@ -293,7 +598,7 @@ storage::TableInfo::Ptr MemoryTableFactory::getSysTableInfo(const std::string& t
     else if (tableName == SYS_TABLES)
     {
         tableInfo->key = "table_name";
-        tableInfo->fields = vector<string>{"key_field", "value_field"};
+        tableInfo->fields = vector<string>{"key_field", "value_field", "index_field"};
     }
     else if (tableName == SYS_ACCESS_TABLE)
     {
@@ -22,6 +22,9 @@
 
 #include "Storage.h"
 #include "Table.h"
+#include <libdevcore/ThreadPool.h>
+#include <set>
+#include <unordered_map>
 
 namespace dev
 {
@@ -31,6 +34,18 @@ class ExecutiveContext;
 }
 namespace storage
 {
+class ChainedStorage;
+
+/// algorithms of the state root, which must be the same on all the nodes of a group
+enum StateHashVersion : unsigned
+{
+    /// sha256 over the written fields of all the tables
+    CONCAT_STATE_HASH = 1,
+    /// sha256 over the digests of the written keys grouped into buckets, so that only the keys
+    /// written since the last hash are hashed again
+    BUCKET_STATE_HASH = 2
+};
+
 class MemoryTableFactory : public StateDBFactory
 {
 public:
@@ -40,8 +55,8 @@ public:
 
     Table::Ptr openTable(const std::string& table, bool authorityFlag = true) override;
     Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
-        const std::string& valueField, bool authorigytFlag,
-        Address const& _origin = Address()) override;
+        const std::string& valueField, bool authorigytFlag, Address const& _origin = Address(),
+        const std::string& indexField = std::string()) override;
 
     virtual Storage::Ptr stateStorage() { return m_stateStorage; }
     virtual void setStateStorage(Storage::Ptr stateStorage) { m_stateStorage = stateStorage; }
@@ -52,12 +67,62 @@ public:
     h256 hash();
     size_t savepoint() const { return m_changeLog.size(); };
     void rollback(size_t _savepoint);
+    /// close the tables created after _savepoint, to be called before rolling back to it, so that
+    /// the factory doesn't keep tables which don't exist any more open
+    void closeCreatedTables(size_t _savepoint);
     void commit();
     void commitDB(h256 const& _blockHash, int64_t _blockNumber);
+    /// the state after the writes of this factory, which stays the same while they're committed
+    /// by commitDB(_blockHash, _blockNumber), to execute the next block on before that
+    std::shared_ptr<ChainedStorage> chainedStorage(h256 const& _blockHash, int64_t _blockNumber);
 
     int getCreateTableCode() { return createTableCode; }
+    /// increases with every write, rollback and merge of the tables, so that callers caching
+    /// rows can tell whether they were modified by others
+    uint64_t modifications() const { return m_modifications; }
+
+    void setHashVersion(unsigned hashVersion) { m_hashVersion = hashVersion; }
+    unsigned hashVersion() const { return m_hashVersion; }
+    /// ConditionVersion of the tables opened
+    void setConditionVersion(unsigned conditionVersion) { m_conditionVersion = conditionVersion; }
+    /// hash the modified tables on _threadPool, which has _threadNum threads
+    void setHashThreadPool(dev::ThreadPool::Ptr _threadPool, size_t _threadNum)
+    {
+        m_hashThreadPool = _threadPool;
+        m_hashThreadNum = _threadNum;
+    }
+
+    /// record the keys selected and written by every table, used by parallel execution
+    void setTrackAccess(bool trackAccess) { m_trackAccess = trackAccess; }
+    /// whether _other accessed any key written by this factory
+    bool conflictWith(MemoryTableFactory::Ptr _other) const;
+    /// take over the tables and accesses of _other, which must not conflict with this factory
+    void merge(MemoryTableFactory::Ptr _other);
 
 private:
+    struct KeyBucket
+    {
+        /// digests of the written keys
+        std::map<std::string, h256> keys;
+        h256 hash;
+        bool valid = false;
+    };
+    /// hash of a table, kept until the table is modified
+    struct TableHash
+    {
+        h256 hash;
+        bool valid = false;
+        /// BUCKET_STATE_HASH: the keys modified since the last hash, all the keys if allDirty
+        bool allDirty = true;
+        std::set<std::string> dirtyKeys;
+        std::map<uint8_t, KeyBucket> buckets;
+    };
+
+    void bindRecorder(Table::Ptr _table, const std::string& _tableName);
+    bool touched(const std::string& _tableName) const;
+    void invalidateHash(Table::Ptr const& _table, const std::string& _key);
+    void updateTableHash(Table::Ptr const& _table, TableHash& _tableHash);
+
     storage::TableInfo::Ptr getSysTableInfo(const std::string& tableName);
     void setAuthorizedAddress(storage::TableInfo::Ptr _tableInfo);
     Storage::Ptr m_stateStorage;
@@ -65,9 +130,19 @@ private:
     int m_blockNum;
     std::map<std::string, Table::Ptr> m_name2Table;
     std::vector<Change> m_changeLog;
+    uint64_t m_modifications = 0;
     h256 m_hash;
+    unsigned m_hashVersion = CONCAT_STATE_HASH;
+    unsigned m_conditionVersion = INT_CONDITION;
+    std::unordered_map<Table*, TableHash> m_tableHashes;
+    dev::ThreadPool::Ptr m_hashThreadPool;
+    size_t m_hashThreadNum = 0;
     std::vector<std::string> m_sysTables;
     int createTableCode;
+
+    bool m_trackAccess = false;
+    std::set<std::pair<std::string, std::string>> m_selectedKeys;
+    std::set<std::pair<std::string, std::string>> m_writtenKeys;
 };
 
 }  // namespace storage
@@ -47,6 +47,33 @@ public:
     virtual size_t commit(
         h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) = 0;
     virtual bool onlyDirty() = 0;
+
+    /// the entries select() returns for a row written by commit(hash, num, ...) of a storage
+    /// which commits whole rows: normal entries only, clean, with _hash_ and _num_ of the commit
+    static Entries::Ptr committedRow(Entries::Ptr row, h256 const& hash, int64_t num)
+    {
+        std::string rowHash = hash.hex();
+        std::string rowNum = std::to_string(num);
+        Entries::Ptr entries = std::make_shared<Entries>();
+        for (size_t i = 0; i < row->size(); ++i)
+        {
+            Entry::Ptr committed = row->get(i);
+            if (committed->getStatus() != Entry::Status::NORMAL)
+            {
+                continue;
+            }
+            Entry::Ptr entry = std::make_shared<Entry>();
+            for (auto& field : *(committed->fields()))
+            {
+                entry->setField(field.first, field.second);
+            }
+            entry->setField("_hash_", rowHash);
+            entry->setField("_num_", rowNum);
+            entry->setDirty(false);
+            entries->addEntry(entry);
+        }
+        return entries;
+    }
 };
 
 }  // namespace storage
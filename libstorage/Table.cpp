@@ -31,6 +31,7 @@
 #include "Table.h"
 #include <libdevcore/easylog.h>
 #include <boost/lexical_cast.hpp>
+#include <atomic>
 #include <map>
 
 using namespace dev::storage;
@@ -41,8 +42,9 @@ Entry::Entry()
     m_fields.insert(std::make_pair(STATUS, "0"));
 }
 
-std::string Entry::getField(const std::string& key) const
+const std::string& Entry::getField(const std::string& key) const
 {
+    static const std::string s_emptyField;
     auto it = m_fields.find(key);
 
     if (it != m_fields.end())
@@ -52,7 +54,7 @@ std::string Entry::getField(const std::string& key) const
 
     STORAGE_LOG(ERROR) << "Entry: " << this << " can't find key: " + key;
 
-    return "";
+    return s_emptyField;
 }
 
 void Entry::setField(const std::string& key, const std::string& value)
@@ -69,6 +71,7 @@ void Entry::setField(const std::string& key, const std::string& value)
     }
 
     m_dirty = true;
+    modified();
 }
 
 std::map<std::string, std::string>* Entry::fields()
@@ -102,6 +105,7 @@ void Entry::setStatus(int status)
     }
 
     m_dirty = true;
+    modified();
 }
 
 bool Entry::dirty() const
@@ -112,6 +116,13 @@ bool Entry::dirty() const
 void Entry::setDirty(bool dirty)
 {
     m_dirty = dirty;
+    modified();
+}
+
+void Entry::modified()
+{
+    static std::atomic<uint64_t> s_version(0);
+    m_version = s_version.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 Entry::Ptr Entries::get(size_t i)
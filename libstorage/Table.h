@@ -35,6 +35,8 @@ struct TableInfo : public std::enable_shared_from_this<TableInfo>
     std::string name;
     std::string key;
     std::vector<std::string> fields;
+    /// value fields with a secondary index, declared in _sys_tables_
+    std::vector<std::string> indices;
     std::vector<Address> authorizedAddress;
 };
 
@@ -60,7 +62,8 @@ public:
     Entry();
     virtual ~Entry() {}
 
-    virtual std::string getField(const std::string& key) const;
+    /// an empty string if the field doesn't exist, the reference is valid until the field is set
+    virtual const std::string& getField(const std::string& key) const;
     virtual void setField(const std::string& key, const std::string& value);
     virtual std::map<std::string, std::string>* fields();
 
@@ -70,9 +73,16 @@ public:
     bool dirty() const;
     void setDirty(bool dirty);
 
+    /// increases whenever a field, the status or the dirty flag is set, and is greater than the
+    /// versions of all the entries set before
+    uint64_t version() const { return m_version; }
+
 private:
+    void modified();
+
     std::map<std::string, std::string> m_fields;
     bool m_dirty = false;
+    uint64_t m_version = 0;
 };
 
 class Entries : public std::enable_shared_from_this<Entries>
@@ -97,6 +107,15 @@ private:
     bool m_dirty = false;
 };
 
+/// how the tables apply conditions, which must be the same on all the nodes of a group
+enum ConditionVersion : unsigned
+{
+    /// ranges compare values as int and don't match values beyond it, limit is ignored
+    INT_CONDITION = 1,
+    /// ranges compare integers of any size, limit and offset apply, deleted entries never match
+    BIGINT_CONDITION = 2
+};
+
 class Condition : public std::enable_shared_from_this<Condition>
 {
 public:
@@ -125,6 +144,9 @@ public:
 
     virtual void limit(size_t count);
     virtual void limit(size_t offset, size_t count);
+    size_t getOffset() const { return m_offset; }
+    /// 0 if there is no limit
+    size_t getCount() const { return m_count; }
 
     virtual std::map<std::string, std::pair<Op, std::string> >* getConditions();
 
@@ -193,7 +215,16 @@ public:
     virtual h256 hash() = 0;
     virtual void clear() = 0;
     virtual std::map<std::string, Entries::Ptr>* data() { return NULL; }
+    virtual bool empty() { return data()->empty(); }
     virtual bool checkAuthority(Address const& _origin) const = 0;
+    /// the entries of key were modified through data()
+    virtual void invalidateIndex(const std::string& key) {}
+    /// the keys of the rows modified directly through the entries returned by select or passed
+    /// to insert since the last call, which the recorder isn't told about
+    virtual std::vector<std::string> takeModifiedKeys() { return std::vector<std::string>(); }
+    /// the entries of key were written by the table or through data() by its factory, which
+    /// accounts for the writes itself, takeModifiedKeys doesn't report them
+    virtual void acceptWrites(const std::string& key) {}
 
 protected:
     std::function<void(Ptr, Change::Kind, std::string const&, std::vector<Change::Record>&)>
@@ -209,8 +240,10 @@ public:
     virtual ~StateDBFactory() {}
 
     virtual Table::Ptr openTable(const std::string& table, bool authorityFlag = true) = 0;
+    /// indexField: comma separated value fields to build secondary indexes on
     virtual Table::Ptr createTable(const std::string& tableName, const std::string& keyField,
-        const std::string& valueField, bool authorigytFlag, Address const& _origin = Address()) = 0;
+        const std::string& valueField, bool authorigytFlag, Address const& _origin = Address(),
+        const std::string& indexField = std::string()) = 0;
 };
 
 }  // namespace storage
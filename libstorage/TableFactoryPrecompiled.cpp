@@ -36,11 +36,13 @@ using namespace dev::storage;
 
 const char* const TABLE_METHOD_OPT_STR = "openTable(string)";
 const char* const TABLE_METHOD_CRT_STR_STR = "createTable(string,string,string)";
+const char* const TABLE_METHOD_CRT_STR_STR_IDX = "createTable(string,string,string,string)";
 
 TableFactoryPrecompiled::TableFactoryPrecompiled()
 {
     name2Selector[TABLE_METHOD_OPT_STR] = getFuncSelector(TABLE_METHOD_OPT_STR);
     name2Selector[TABLE_METHOD_CRT_STR_STR] = getFuncSelector(TABLE_METHOD_CRT_STR_STR);
+    name2Selector[TABLE_METHOD_CRT_STR_STR_IDX] = getFuncSelector(TABLE_METHOD_CRT_STR_STR_IDX);
 }
 
 std::string TableFactoryPrecompiled::toString(std::shared_ptr<ExecutiveContext>)
@@ -84,21 +86,38 @@ bytes TableFactoryPrecompiled::call(
 
         out = abi.abiIn("", address);
     }
-    else if (func == name2Selector[TABLE_METHOD_CRT_STR_STR])
-    {  // createTable(string,string,string)
+    else if (func == name2Selector[TABLE_METHOD_CRT_STR_STR] ||
+             func == name2Selector[TABLE_METHOD_CRT_STR_STR_IDX])
+    {  // createTable(string,string,string), createTable(string,string,string,string)
         string tableName;
         string keyField;
         string valueFiled;
+        string indexField;
 
-        abi.abiOut(data, tableName, keyField, valueFiled);
+        if (func == name2Selector[TABLE_METHOD_CRT_STR_STR])
+        {
+            abi.abiOut(data, tableName, keyField, valueFiled);
+        }
+        else
+        {
+            abi.abiOut(data, tableName, keyField, valueFiled, indexField);
+        }
         vector<string> fieldNameList;
         boost::split(fieldNameList, valueFiled, boost::is_any_of(","));
         for (auto& str : fieldNameList)
             boost::trim(str);
         valueFiled = boost::join(fieldNameList, ",");
+        if (!indexField.empty())
+        {
+            vector<string> indexFieldList;
+            boost::split(indexFieldList, indexField, boost::is_any_of(","));
+            for (auto& str : indexFieldList)
+                boost::trim(str);
+            indexField = boost::join(indexFieldList, ",");
+        }
         tableName = storage::USER_TABLE_PREFIX + tableName;
-        auto table =
-            m_memoryTableFactory->createTable(tableName, keyField, valueFiled, true, origin);
+        auto table = m_memoryTableFactory->createTable(
+            tableName, keyField, valueFiled, true, origin, indexField);
         // set createTableCode
         int errorCode = m_memoryTableFactory->getCreateTableCode();
         out = abi.abiIn("", u256(errorCode));
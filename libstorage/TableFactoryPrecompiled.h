@@ -33,6 +33,7 @@ namespace blockverifier
 #if 0
 {
     "56004b6a": "createTable(string,string,string)",
+    "0a531dfd": "createTable(string,string,string,string)",
     "c184e0ff": "openDB(string)",
     "f23f63c9": "openTable(string)"
 }
@@ -40,6 +41,8 @@ contract DBFactory {
     function openDB(string) public constant returns (DB);
     function openTable(string) public constant returns (DB);
     function createTable(string, string, string) public constant returns (int);
+    // the last parameter: value fields to index, separated by commas
+    function createTable(string, string, string, string) public constant returns (int);
 }
 #endif
 
@@ -0,0 +1,217 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file WriteBehindStorage.cpp
+ *  @date 20190322
+ */
+
+#include "WriteBehindStorage.h"
+#include "Common.h"
+#include "StorageException.h"
+#include <libdevcore/easylog.h>
+
+using namespace dev;
+using namespace dev::storage;
+
+/// interval to retry a block the backend failed to commit
+static const unsigned c_flushRetryIntervalMs = 1000;
+
+WriteBehindStorage::WriteBehindStorage(Storage::Ptr _backend, size_t _maxPendingBlocks)
+  : m_backend(_backend), m_maxPendingBlocks(std::max(_maxPendingBlocks, (size_t)1))
+{
+    m_flushThread = std::thread([this]() { flushLoop(); });
+}
+
+WriteBehindStorage::~WriteBehindStorage()
+{
+    stop();
+}
+
+Entries::Ptr WriteBehindStorage::select(
+    h256 hash, int num, const std::string& table, const std::string& key)
+{
+    {
+        ReadGuard l(x_pendingRows);
+        auto it = m_pendingRows.find(rowKey(table, key));
+        if (it != m_pendingRows.end())
+        {
+            /// return fresh entries, just like the backend decoding the row it would write
+            return committedRow(it->second.entries, it->second.hash, it->second.num);
+        }
+    }
+
+    return m_backend->select(hash, num, table, key);
+}
+
+size_t WriteBehindStorage::commit(
+    h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash)
+{
+    std::unique_lock<Mutex> l(x_pendingBlocks);
+    m_blockFlushed.wait(
+        l, [this]() { return m_stopped || m_pendingBlocks.size() < m_maxPendingBlocks; });
+    if (m_stopped)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Commit to stopped write-behind storage"));
+    }
+
+    size_t total = 0;
+    {
+        WriteGuard rowsLock(x_pendingRows);
+        for (auto& tableData : datas)
+        {
+            for (auto& it : tableData->data)
+            {
+                /// the backend doesn't write empty rows either
+                if (it.second->size() == 0u)
+                {
+                    continue;
+                }
+                m_pendingRows[rowKey(tableData->tableName, it.first)] =
+                    PendingRow{hash, num, it.second};
+                ++total;
+            }
+        }
+    }
+
+    /// the tables of the datas are dropped by MemoryTableFactory::commitDB, keep them as they are
+    auto block = std::make_shared<PendingBlock>();
+    block->hash = hash;
+    block->num = num;
+    block->datas = datas;
+    block->blockHash = blockHash;
+    m_pendingBlocks.push_back(block);
+    m_blockQueued.notify_one();
+
+    STORAGE_LOG(DEBUG) << "[#WriteBehindStorage] [#commit] [num/rows/pendingBlocks]: " << num
+                       << "/" << total << "/" << m_pendingBlocks.size();
+    return total;
+}
+
+bool WriteBehindStorage::onlyDirty()
+{
+    return false;
+}
+
+bool WriteBehindStorage::flush()
+{
+    std::unique_lock<Mutex> l(x_pendingBlocks);
+    m_blockFlushed.wait(l, [this]() { return m_failing || m_pendingBlocks.empty(); });
+    return m_pendingBlocks.empty();
+}
+
+void WriteBehindStorage::stop()
+{
+    {
+        Guard l(x_pendingBlocks);
+        if (m_stopped)
+        {
+            return;
+        }
+        m_stopped = true;
+    }
+    m_blockQueued.notify_all();
+    m_blockFlushed.notify_all();
+    if (m_flushThread.joinable())
+    {
+        m_flushThread.join();
+    }
+    STORAGE_LOG(INFO) << "[#WriteBehindStorage] [#stop] [flushedNumber]: " << m_flushedNumber;
+}
+
+size_t WriteBehindStorage::pendingBlocks() const
+{
+    Guard l(x_pendingBlocks);
+    return m_pendingBlocks.size();
+}
+
+void WriteBehindStorage::flushLoop()
+{
+    dev::pthread_setThreadName("WriteBehind");
+    while (true)
+    {
+        PendingBlock::Ptr block;
+        bool stopped = false;
+        {
+            std::unique_lock<Mutex> l(x_pendingBlocks);
+            m_blockQueued.wait(l, [this]() { return m_stopped || !m_pendingBlocks.empty(); });
+            /// stop only after the pending blocks have been written
+            if (m_pendingBlocks.empty())
+            {
+                return;
+            }
+            block = m_pendingBlocks.front();
+            stopped = m_stopped;
+        }
+
+        try
+        {
+            m_backend->commit(block->hash, block->num, block->datas, block->blockHash);
+        }
+        catch (std::exception& e)
+        {
+            STORAGE_LOG(ERROR)
+                << "[#WriteBehindStorage] [#flushLoop] Flush block failed [num/EINFO]: "
+                << block->num << "/" << boost::diagnostic_information(e);
+            if (!stopped)
+            {
+                {
+                    Guard l(x_pendingBlocks);
+                    m_failing = true;
+                }
+                m_blockFlushed.notify_all();
+                std::this_thread::sleep_for(std::chrono::milliseconds(c_flushRetryIntervalMs));
+                continue;
+            }
+            /// the backend stays at the last flushed block, blocks after it will be synced again
+            STORAGE_LOG(ERROR) << "[#WriteBehindStorage] [#flushLoop] Drop unflushed blocks "
+                                  "[flushedNumber/pendingBlocks]: "
+                               << m_flushedNumber << "/" << pendingBlocks();
+            {
+                WriteGuard rowsLock(x_pendingRows);
+                m_pendingRows.clear();
+            }
+            {
+                Guard l(x_pendingBlocks);
+                m_pendingBlocks.clear();
+            }
+            m_blockFlushed.notify_all();
+            return;
+        }
+
+        {
+            /// rows overwritten by a later block stay until that block is written
+            WriteGuard rowsLock(x_pendingRows);
+            for (auto& tableData : block->datas)
+            {
+                for (auto& it : tableData->data)
+                {
+                    auto row = m_pendingRows.find(rowKey(tableData->tableName, it.first));
+                    if (row != m_pendingRows.end() && row->second.entries == it.second)
+                    {
+                        m_pendingRows.erase(row);
+                    }
+                }
+            }
+        }
+        m_flushedNumber = block->num;
+        {
+            Guard l(x_pendingBlocks);
+            m_pendingBlocks.pop_front();
+            m_failing = false;
+        }
+        m_blockFlushed.notify_all();
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file WriteBehindStorage.h
+ *  @date 20190322
+ */
+#pragma once
+
+#include "Storage.h"
+#include <libdevcore/Guards.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <unordered_map>
+
+namespace dev
+{
+namespace storage
+{
+/// Write-behind layer over a storage which commits whole rows (onlyDirty() == false).
+/// commit() only queues the data of a block, a background thread writes the blocks to the
+/// backend in commit order, and select() serves the rows which haven't been written yet.
+/// Each block goes to the backend in one commit, so after a crash the backend holds the state
+/// of the last flushed block and the blocks after it are fetched again by sync.
+class WriteBehindStorage : public Storage
+{
+public:
+    typedef std::shared_ptr<WriteBehindStorage> Ptr;
+
+    WriteBehindStorage(Storage::Ptr _backend, size_t _maxPendingBlocks);
+    virtual ~WriteBehindStorage();
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override;
+    /// blocks only when _maxPendingBlocks blocks are waiting to be flushed
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override;
+    virtual bool onlyDirty() override;
+
+    /// wait until every committed block has been written to the backend,
+    /// return false at once if the backend is failing
+    bool flush();
+    /// flush the pending blocks and stop the background thread
+    void stop();
+
+    int64_t flushedNumber() const { return m_flushedNumber; }
+    size_t pendingBlocks() const;
+
+private:
+    struct PendingBlock
+    {
+        typedef std::shared_ptr<PendingBlock> Ptr;
+        h256 hash;
+        int64_t num;
+        std::vector<TableData::Ptr> datas;
+        h256 blockHash;
+    };
+    struct PendingRow
+    {
+        h256 hash;
+        int64_t num;
+        Entries::Ptr entries;
+    };
+
+    void flushLoop();
+    static std::string rowKey(const std::string& table, const std::string& key)
+    {
+        return table + "_" + key;
+    }
+
+    Storage::Ptr m_backend;
+    size_t m_maxPendingBlocks;
+
+    /// blocks waiting for the backend, in commit order
+    std::deque<PendingBlock::Ptr> m_pendingBlocks;
+    mutable Mutex x_pendingBlocks;
+    std::condition_variable m_blockQueued;
+    std::condition_variable m_blockFlushed;
+
+    /// newest unflushed version of every row
+    std::unordered_map<std::string, PendingRow> m_pendingRows;
+    mutable SharedMutex x_pendingRows;
+
+    std::atomic<int64_t> m_flushedNumber = {-1};
+    bool m_stopped = false;
+    /// the backend failed to commit the front block, which is being retried
+    bool m_failing = false;
+    std::thread m_flushThread;
+};
+
+}  // namespace storage
+
+}  // namespace dev
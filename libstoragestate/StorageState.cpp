@@ -35,8 +35,8 @@ using namespace dev::executive;
 
 bool StorageState::addressInUse(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table && !table->data()->empty())
+    auto account = getAccount(_address);
+    if (account && !account->table->empty())
     {
         return true;
     }
@@ -45,8 +45,8 @@ bool StorageState::addressInUse(Address const& _address) const
 
 bool StorageState::accountNonemptyAndExisting(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
         if (balance(_address) > u256(0) || codeHash(_address) != EmptySHA3 ||
             getNonce(_address) != m_accountStartNonce)
@@ -57,48 +57,33 @@ bool StorageState::accountNonemptyAndExisting(Address const& _address) const
 
 bool StorageState::addressHasCode(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_CODE_HASH, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto codeHash = h256(fromHex(entries->get(0)->getField(STORAGE_VALUE)));
-            return codeHash != EmptySHA3;
-        }
+        return loadCodeHash(*account) != EmptySHA3;
     }
     return false;
 }
 
 u256 StorageState::balance(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return u256(entries->get(0)->getField(STORAGE_VALUE));
-        }
+        return loadU256(*account, ACCOUNT_BALANCE, account->balance, u256());
     }
     return 0;
 }
 
 void StorageState::addBalance(Address const& _address, u256 const& _amount)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
-            balance += _amount;
-            entry = table->newEntry();
-            entry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, entry, table->newCondition());
-        }
+        account->balance.value = loadU256(*account, ACCOUNT_BALANCE, account->balance, u256()) +
+                                 _amount;
+        account->balance.dirty = true;
+        setDirty(_address, *account);
     }
     else
     {
@@ -108,21 +93,15 @@ void StorageState::addBalance(Address const& _address, u256 const& _amount)
 
 void StorageState::subBalance(Address const& _address, u256 const& _amount)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
-            if (balance < _amount)
-                BOOST_THROW_EXCEPTION(NotEnoughCash());
-            balance -= _amount;
-            entry = table->newEntry();
-            entry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, entry, table->newCondition());
-        }
+        auto balance = loadU256(*account, ACCOUNT_BALANCE, account->balance, u256());
+        if (balance < _amount)
+            BOOST_THROW_EXCEPTION(NotEnoughCash());
+        account->balance.value = balance - _amount;
+        account->balance.dirty = true;
+        setDirty(_address, *account);
     }
     else
     {
@@ -132,19 +111,13 @@ void StorageState::subBalance(Address const& _address, u256 const& _amount)
 
 void StorageState::setBalance(Address const& _address, u256 const& _amount)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_BALANCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            auto balance = u256(entry->getField(STORAGE_VALUE));
-            balance = _amount;
-            entry = table->newEntry();
-            entry->setField(STORAGE_VALUE, balance.str());
-            table->update(ACCOUNT_BALANCE, entry, table->newCondition());
-        }
+        account->balance.value = _amount;
+        account->balance.loaded = true;
+        account->balance.dirty = true;
+        setDirty(_address, *account);
     }
     else
     {
@@ -160,48 +133,49 @@ void StorageState::transferBalance(Address const& _from, Address const& _to, u25
 
 h256 StorageState::storageRoot(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        return table->hash();
+        writeBack();
+        return account->table->hash();
     }
     return h256();
 }
 
 u256 StorageState::storage(Address const& _address, u256 const& _key) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(_key.str(), table->newCondition());
-        if (entries->size() != 0u)
+        auto& slot = account->slots[_key];
+        if (!slot.loaded)
         {
-            return u256(entries->get(0)->getField(STORAGE_VALUE));
+            auto entries = account->table->select(encodeU256(_key), account->table->newCondition());
+            if (entries->size() != 0u)
+            {
+                slot.value = decodeU256(entries->get(0)->getField(STORAGE_VALUE));
+            }
+            slot.loaded = true;
         }
+        return slot.value;
     }
     return u256();
 }
 
 void StorageState::setStorage(Address const& _address, u256 const& _location, u256 const& _value)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(_location.str(), table->newCondition());
-        if (entries->size() == 0u)
+        auto& slot = account->slots[_location];
+        slot.value = _value;
+        slot.loaded = true;
+        if (!slot.dirty)
         {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
-            entry->setField(STORAGE_VALUE, _value.str());
-            table->insert(_location.str(), entry);
-        }
-        else
-        {
-            auto entry = table->newEntry();
-            entry->setField(STORAGE_KEY, _location.str());
-            entry->setField(STORAGE_VALUE, _value.str());
-            table->update(_location.str(), entry, table->newCondition());
+            slot.dirty = true;
+            account->dirtySlots.push_back(_location);
         }
+        setDirty(_address, *account);
     }
 }
 
@@ -209,41 +183,38 @@ void StorageState::clearStorage(Address const& _address) {}
 
 void StorageState::setCode(Address const& _address, bytes&& _code)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, toHex(_code));
-        table->update(ACCOUNT_CODE, entry, table->newCondition());
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, toHex(sha3(_code)));
-        table->update(ACCOUNT_CODE_HASH, entry, table->newCondition());
+        account->codeHash.value = sha3(_code);
+        account->codeHash.loaded = true;
+        account->codeHash.dirty = true;
+        account->code.value = _code;
+        account->code.loaded = true;
+        account->code.dirty = true;
+        setDirty(_address, *account);
     }
     m_cache[_address] = _code;
 }
 
 void StorageState::kill(Address _address)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, m_accountStartNonce.str());
-        table->update(ACCOUNT_NONCE, entry, table->newCondition());
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, u256(0).str());
-        table->update(ACCOUNT_BALANCE, entry, table->newCondition());
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, "");
-        table->update(ACCOUNT_CODE, entry, table->newCondition());
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, toHex(EmptySHA3));
-        table->update(ACCOUNT_CODE_HASH, entry, table->newCondition());
-        entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, "false");
-        table->update(ACCOUNT_ALIVE, entry, table->newCondition());
+        account->nonce.value = m_accountStartNonce;
+        account->nonce.loaded = account->nonce.dirty = true;
+        account->balance.value = 0;
+        account->balance.loaded = account->balance.dirty = true;
+        account->code.value.clear();
+        account->code.loaded = account->code.dirty = true;
+        account->codeHash.value = EmptySHA3;
+        account->codeHash.loaded = account->codeHash.dirty = true;
+        account->alive.value = false;
+        account->alive.loaded = account->alive.dirty = true;
+        setDirty(_address, *account);
     }
-    clear();
+    m_cache.erase(_address);
 }
 
 bytes const& StorageState::code(Address const& _address) const
@@ -251,15 +222,34 @@ bytes const& StorageState::code(Address const& _address) const
     auto it = m_cache.find(_address);
     if (it != m_cache.end())
         return it->second;
-    if (codeHash(_address) == EmptySHA3)
-        return NullBytes;
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_CODE, table->newCondition());
+        if (loadCodeHash(*account) == EmptySHA3)
+        {
+            return NullBytes;
+        }
+        if (account->code.loaded)
+        {
+            m_cache[_address] = account->code.value;
+            return m_cache[_address];
+        }
+        auto entries = account->table->select(ACCOUNT_CODE, account->table->newCondition());
         if (entries->size() != 0u)
         {
-            m_cache[_address] = fromHex(entries->get(0)->getField(STORAGE_VALUE));
+            auto const& codeField = entries->get(0)->getField(STORAGE_VALUE);
+            auto hashEntries =
+                account->table->select(ACCOUNT_CODE_HASH, account->table->newCondition());
+            /// code and its hash are always written together, in the same encoding
+            if (hashEntries->size() != 0u &&
+                hashEntries->get(0)->getField(STORAGE_VALUE).size() == h256::size)
+            {
+                m_cache[_address] = bytes(codeField.begin(), codeField.end());
+            }
+            else
+            {
+                m_cache[_address] = fromHex(codeField);
+            }
             return m_cache[_address];
         }
     }
@@ -268,14 +258,10 @@ bytes const& StorageState::code(Address const& _address) const
 
 h256 StorageState::codeHash(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_CODE_HASH, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            return h256(fromHex(entries->get(0)->getField(STORAGE_VALUE)));
-        }
+        return loadCodeHash(*account);
     }
     return EmptySHA3;
 }
@@ -292,19 +278,13 @@ void StorageState::createContract(Address const& _address)
 
 void StorageState::incNonce(Address const& _address)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_NONCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            auto nonce = u256(entry->getField(STORAGE_VALUE));
-            ++nonce;
-            entry = table->newEntry();
-            entry->setField(STORAGE_VALUE, nonce.str());
-            table->update(ACCOUNT_NONCE, entry, table->newCondition());
-        }
+        account->nonce.value =
+            loadU256(*account, ACCOUNT_NONCE, account->nonce, m_accountStartNonce) + 1;
+        account->nonce.dirty = true;
+        setDirty(_address, *account);
     }
     else
         createAccount(_address, requireAccountStartNonce() + 1);
@@ -312,12 +292,13 @@ void StorageState::incNonce(Address const& _address)
 
 void StorageState::setNonce(Address const& _address, u256 const& _newNonce)
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entry = table->newEntry();
-        entry->setField(STORAGE_VALUE, _newNonce.str());
-        table->update(ACCOUNT_NONCE, entry, table->newCondition());
+        account->nonce.value = _newNonce;
+        account->nonce.loaded = true;
+        account->nonce.dirty = true;
+        setDirty(_address, *account);
     }
     else
         createAccount(_address, _newNonce);
@@ -325,31 +306,29 @@ void StorageState::setNonce(Address const& _address, u256 const& _newNonce)
 
 u256 StorageState::getNonce(Address const& _address) const
 {
-    auto table = getTable(_address);
-    if (table)
+    auto account = getAccount(_address);
+    if (account)
     {
-        auto entries = table->select(ACCOUNT_NONCE, table->newCondition());
-        if (entries->size() != 0u)
-        {
-            auto entry = entries->get(0);
-            return u256(entry->getField(STORAGE_VALUE));
-        }
+        return loadU256(*account, ACCOUNT_NONCE, account->nonce, m_accountStartNonce);
     }
     return m_accountStartNonce;
 }
 
 h256 StorageState::rootHash() const
 {
+    writeBack();
     return m_memoryTableFactory->hash();
 }
 
 void StorageState::commit()
 {
+    writeBack();
     m_memoryTableFactory->commit();
 }
 
 void StorageState::dbCommit(h256 const& _blockHash, int64_t _blockNumber)
 {
+    writeBack();
     // ExecutiveContext will commit
     // m_memoryTableFactory->commitDB(_blockHash, _blockNumber);
 }
@@ -378,30 +357,49 @@ void StorageState::noteAccountStartNonce(u256 const& _actual)
 
 size_t StorageState::savepoint() const
 {
+    /// the changes before the savepoint are all in the change log of the tables
+    writeBack();
     return m_memoryTableFactory->savepoint();
 }
 
 void StorageState::rollback(size_t _savepoint)
 {
+    /// the fields and the code set after the savepoint are dropped, the others are loaded again
+    m_accounts.clear();
+    m_dirtyAccounts.clear();
+    m_cache.clear();
     m_memoryTableFactory->rollback(_savepoint);
+    m_modifications = m_memoryTableFactory->modifications();
 }
 
 void StorageState::clear()
 {
+    writeBack();
+    m_accounts.clear();
     m_cache.clear();
 }
 
 bool StorageState::checkAuthority(Address const& _origin, Address const& _contract) const
 {
-    auto table = getTable(_contract);
-    if (table)
-        return table->checkAuthority(_origin);
+    auto account = getAccount(_contract);
+    if (account)
+        return account->table->checkAuthority(_origin);
     else
         return true;
 }
 
+void StorageState::setMemoryTableFactory(
+    std::shared_ptr<dev::storage::MemoryTableFactory> _memoryTableFactory)
+{
+    m_memoryTableFactory = _memoryTableFactory;
+    m_accounts.clear();
+    m_dirtyAccounts.clear();
+    m_modifications = m_memoryTableFactory ? m_memoryTableFactory->modifications() : 0;
+}
+
 void StorageState::createAccount(Address const& _address, u256 const& _nonce, u256 const& _amount)
 {
+    checkModifications();
     std::string tableName("_contract_data_" + _address.hex() + "_");
     auto table = m_memoryTableFactory->createTable(tableName, STORAGE_KEY, STORAGE_VALUE, false);
     if (!table)
@@ -410,11 +408,11 @@ void StorageState::createAccount(Address const& _address, u256 const& _nonce, u2
     }
     auto entry = table->newEntry();
     entry->setField(STORAGE_KEY, ACCOUNT_BALANCE);
-    entry->setField(STORAGE_VALUE, _amount.str());
+    entry->setField(STORAGE_VALUE, encodeU256(_amount));
     table->insert(ACCOUNT_BALANCE, entry);
     entry = table->newEntry();
     entry->setField(STORAGE_KEY, ACCOUNT_CODE_HASH);
-    entry->setField(STORAGE_VALUE, toHex(EmptySHA3));
+    entry->setField(STORAGE_VALUE, encodeCodeHash(EmptySHA3));
     table->insert(ACCOUNT_CODE_HASH, entry);
     entry = table->newEntry();
     entry->setField(STORAGE_KEY, ACCOUNT_CODE);
@@ -422,16 +420,203 @@ void StorageState::createAccount(Address const& _address, u256 const& _nonce, u2
     table->insert(ACCOUNT_CODE, entry);
     entry = table->newEntry();
     entry->setField(STORAGE_KEY, ACCOUNT_NONCE);
-    entry->setField(STORAGE_VALUE, _nonce.str());
+    entry->setField(STORAGE_VALUE, encodeU256(_nonce));
     table->insert(ACCOUNT_NONCE, entry);
     entry = table->newEntry();
     entry->setField(STORAGE_KEY, ACCOUNT_ALIVE);
     entry->setField(STORAGE_VALUE, "true");
     table->insert(ACCOUNT_ALIVE, entry);
+
+    /// the rows written are known, no need to read them again
+    Account account;
+    account.table = table;
+    account.balance.value = _amount;
+    account.balance.loaded = true;
+    account.nonce.value = _nonce;
+    account.nonce.loaded = true;
+    account.codeHash.value = EmptySHA3;
+    account.codeHash.loaded = true;
+    m_accounts[_address] = std::move(account);
+    m_modifications = m_memoryTableFactory->modifications();
 }
 
-inline storage::Table::Ptr StorageState::getTable(Address const& _address) const
+StorageState::Account* StorageState::getAccount(Address const& _address) const
 {
-    std::string tableName("_contract_data_" + _address.hex() + "_");
-    return m_memoryTableFactory->openTable(tableName);
+    checkModifications();
+    auto it = m_accounts.find(_address);
+    if (it == m_accounts.end())
+    {
+        /// accounts that don't exist are kept as well, opening them selects _sys_tables_
+        it = m_accounts.emplace(_address, Account()).first;
+        it->second.table =
+            m_memoryTableFactory->openTable("_contract_data_" + _address.hex() + "_");
+    }
+    return it->second.table ? &it->second : nullptr;
+}
+
+u256 const& StorageState::loadU256(
+    Account& _account, const char* _key, CachedField<u256>& _field, u256 const& _default) const
+{
+    if (!_field.loaded)
+    {
+        auto entries = _account.table->select(_key, _account.table->newCondition());
+        if (entries->size() != 0u)
+        {
+            _field.value = decodeU256(entries->get(0)->getField(STORAGE_VALUE));
+        }
+        else
+        {
+            _field.value = _default;
+        }
+        _field.loaded = true;
+    }
+    return _field.value;
+}
+
+h256 const& StorageState::loadCodeHash(Account& _account) const
+{
+    if (!_account.codeHash.loaded)
+    {
+        auto entries = _account.table->select(ACCOUNT_CODE_HASH, _account.table->newCondition());
+        if (entries->size() != 0u)
+        {
+            _account.codeHash.value = decodeCodeHash(entries->get(0)->getField(STORAGE_VALUE));
+        }
+        else
+        {
+            _account.codeHash.value = EmptySHA3;
+        }
+        _account.codeHash.loaded = true;
+    }
+    return _account.codeHash.value;
+}
+
+void StorageState::setDirty(Address const& _address, Account& _account)
+{
+    if (!_account.dirty)
+    {
+        _account.dirty = true;
+        m_dirtyAccounts.push_back(_address);
+    }
+}
+
+void StorageState::writeBack() const
+{
+    if (m_dirtyAccounts.empty())
+    {
+        return;
+    }
+    auto update = [](Table::Ptr const& _table, const char* _key, std::string const& _value) {
+        auto entry = _table->newEntry();
+        entry->setField(STORAGE_VALUE, _value);
+        _table->update(_key, entry, _table->newCondition());
+    };
+    for (auto const& address : m_dirtyAccounts)
+    {
+        auto& account = m_accounts[address];
+        auto const& table = account.table;
+        if (account.nonce.dirty)
+        {
+            update(table, ACCOUNT_NONCE, encodeU256(account.nonce.value));
+            account.nonce.dirty = false;
+        }
+        if (account.balance.dirty)
+        {
+            update(table, ACCOUNT_BALANCE, encodeU256(account.balance.value));
+            account.balance.dirty = false;
+        }
+        if (account.code.dirty)
+        {
+            if (m_encoding == BINARY_STORAGE_ENCODING)
+            {
+                update(table, ACCOUNT_CODE,
+                    std::string(account.code.value.begin(), account.code.value.end()));
+            }
+            else
+            {
+                update(table, ACCOUNT_CODE, toHex(account.code.value));
+            }
+            account.code.dirty = false;
+        }
+        if (account.codeHash.dirty)
+        {
+            update(table, ACCOUNT_CODE_HASH, encodeCodeHash(account.codeHash.value));
+            account.codeHash.dirty = false;
+        }
+        if (account.alive.dirty)
+        {
+            update(table, ACCOUNT_ALIVE, account.alive.value ? "true" : "false");
+            account.alive.dirty = false;
+        }
+        for (auto const& location : account.dirtySlots)
+        {
+            auto& slot = account.slots[location];
+            auto key = encodeU256(location);
+            auto entries = table->select(key, table->newCondition());
+            auto entry = table->newEntry();
+            entry->setField(STORAGE_KEY, key);
+            entry->setField(STORAGE_VALUE, encodeU256(slot.value));
+            if (entries->size() == 0u)
+            {
+                table->insert(key, entry);
+            }
+            else
+            {
+                table->update(key, entry, table->newCondition());
+            }
+            slot.dirty = false;
+        }
+        account.dirtySlots.clear();
+        account.dirty = false;
+    }
+    m_dirtyAccounts.clear();
+    m_modifications = m_memoryTableFactory->modifications();
+}
+
+void StorageState::checkModifications() const
+{
+    if (m_memoryTableFactory->modifications() != m_modifications)
+    {
+        writeBack();
+        m_accounts.clear();
+        m_modifications = m_memoryTableFactory->modifications();
+    }
+}
+
+std::string StorageState::encodeU256(u256 const& _value) const
+{
+    if (m_encoding == BINARY_STORAGE_ENCODING)
+    {
+        return toBigEndianString(_value);
+    }
+    return _value.str();
+}
+
+u256 StorageState::decodeU256(std::string const& _value) const
+{
+    /// decimal text is read as well, a binary value is always 32 bytes
+    if (m_encoding == BINARY_STORAGE_ENCODING && _value.size() == h256::size)
+    {
+        return fromBigEndian<u256>(_value);
+    }
+    return u256(_value);
+}
+
+std::string StorageState::encodeCodeHash(h256 const& _codeHash) const
+{
+    if (m_encoding == BINARY_STORAGE_ENCODING)
+    {
+        return std::string((char const*)_codeHash.data(), h256::size);
+    }
+    return toHex(_codeHash);
+}
+
+h256 StorageState::decodeCodeHash(std::string const& _codeHash)
+{
+    /// 64 hex digits in text, 32 bytes in binary
+    if (_codeHash.size() == h256::size)
+    {
+        return h256(bytesConstRef((byte const*)_codeHash.data(), h256::size));
+    }
+    return h256(fromHex(_codeHash));
 }
@@ -24,6 +24,7 @@
 
 #pragma once
 #include "libexecutive/StateFace.h"
+#include <map>
 
 namespace dev
 {
@@ -41,11 +42,25 @@ const char* const ACCOUNT_CODE_HASH = "codeHash";
 const char* const ACCOUNT_CODE = "code";
 const char* const ACCOUNT_NONCE = "nonce";
 const char* const ACCOUNT_ALIVE = "alive";
+
+/// formats of the keys and values of the account tables, which must be the same on all the nodes
+/// of a group since the written fields are hashed into the state root
+enum StorageEncoding : unsigned
+{
+    /// u256 as decimal strings, code and code hash as hex strings
+    TEXT_STORAGE_ENCODING = 1,
+    /// u256 as 32 bytes big endian, code and code hash as raw bytes
+    BINARY_STORAGE_ENCODING = 2
+};
+
 class StorageState : public dev::executive::StateFace
 {
 public:
-    explicit StorageState(u256 const& _accountStartNonce)
-      : m_accountStartNonce(_accountStartNonce), m_memoryTableFactory(nullptr){};
+    explicit StorageState(
+        u256 const& _accountStartNonce, unsigned _encoding = TEXT_STORAGE_ENCODING)
+      : m_accountStartNonce(_accountStartNonce),
+        m_memoryTableFactory(nullptr),
+        m_encoding(_encoding){};
 
     /// Check if the address is in use.
     virtual bool addressInUse(Address const& _address) const override;
@@ -170,18 +185,65 @@ public:
     virtual bool checkAuthority(Address const& _origin, Address const& _contract) const override;
 
     void setMemoryTableFactory(
-        std::shared_ptr<dev::storage::MemoryTableFactory> _memoryTableFactory)
-    {
-        m_memoryTableFactory = _memoryTableFactory;
-    }
+        std::shared_ptr<dev::storage::MemoryTableFactory> _memoryTableFactory);
+
+    unsigned encoding() const { return m_encoding; }
 
 private:
+    template <typename T>
+    struct CachedField
+    {
+        T value;
+        bool loaded = false;
+        /// set since the last write back, written even if unchanged as the state root hashes
+        /// the written rows
+        bool dirty = false;
+    };
+    /// an account used by the current block, its fields are decoded from its table on first use
+    /// and the ones set are written back on savepoint, commit and rootHash
+    struct Account
+    {
+        /// nullptr if the account doesn't exist
+        std::shared_ptr<dev::storage::Table> table;
+        CachedField<u256> balance;
+        CachedField<u256> nonce;
+        CachedField<h256> codeHash;
+        CachedField<bytes> code;
+        CachedField<bool> alive;
+        std::map<u256, CachedField<u256>> slots;
+        std::vector<u256> dirtySlots;
+        bool dirty = false;
+    };
+
     mutable std::unordered_map<Address, bytes> m_cache;
     void createAccount(Address const& _address, u256 const& _nonce, u256 const& _amount = u256());
-    std::shared_ptr<dev::storage::Table> getTable(Address const& _address) const;
+    /// nullptr if the account doesn't exist
+    Account* getAccount(Address const& _address) const;
+    u256 const& loadU256(Account& _account, const char* _key, CachedField<u256>& _field,
+        u256 const& _default) const;
+    h256 const& loadCodeHash(Account& _account) const;
+    void setDirty(Address const& _address, Account& _account);
+    /// write the fields set since the last write back to the tables
+    void writeBack() const;
+    /// drop the accounts if the tables were modified by others, like precompileds or merge
+    void checkModifications() const;
+
+    /// encode with m_encoding, decoding accepts the text rows in binary encoding as well
+    std::string encodeU256(u256 const& _value) const;
+    u256 decodeU256(std::string const& _value) const;
+    std::string encodeCodeHash(h256 const& _codeHash) const;
+    static h256 decodeCodeHash(std::string const& _codeHash);
+
     /// check authority by caller
     u256 m_accountStartNonce;
     std::shared_ptr<dev::storage::MemoryTableFactory> m_memoryTableFactory;
+    unsigned m_encoding;
+
+    mutable std::unordered_map<Address, Account> m_accounts;
+    /// in the order they were first set, so that they are written back the same way on all nodes
+    mutable std::vector<Address> m_dirtyAccounts;
+    /// modifications of m_memoryTableFactory known to m_accounts
+    mutable uint64_t m_modifications = 0;
 };
 }  // namespace storagestate
 }  // namespace dev
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "StorageState.h"
 #include <libexecutive/StateFactoryInterface.h>
 
 namespace dev
@@ -33,13 +34,17 @@ namespace storagestate
 class StorageStateFactory : public dev::executive::StateFactoryInterface
 {
 public:
-    StorageStateFactory(u256 const& _accountStartNonce) : m_accountStartNonce(_accountStartNonce) {}
+    StorageStateFactory(
+        u256 const& _accountStartNonce, unsigned _encoding = TEXT_STORAGE_ENCODING)
+      : m_accountStartNonce(_accountStartNonce), m_encoding(_encoding)
+    {}
     virtual ~StorageStateFactory() {}
     std::shared_ptr<dev::executive::StateFace> getState(
         h256 const& _root, std::shared_ptr<dev::storage::MemoryTableFactory> _factory) override;
 
 private:
     u256 m_accountStartNonce;
+    unsigned m_encoding;
 };
 }  // namespace storagestate
 }  // namespace dev
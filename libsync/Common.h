@@ -55,6 +55,8 @@ static uint64_t const c_downloadingRequestTimeout =
 static size_t const c_maxDownloadingBlockQueueSize =
     c_maxRequestBlocks * 128;  // maybe less than 128 is ok
 static size_t const c_maxDownloadingBlockQueueBufferSize = c_maxRequestShards * 8;
+// shards decoded concurrently ahead of block execution
+static size_t const c_maxPreparingShards = c_maxRequestShards * 2;
 
 static size_t const c_maxReceivedDownloadRequestPerPeer = 8;
 static uint64_t const c_respondDownloadRequestTimeout = 200;  // ms
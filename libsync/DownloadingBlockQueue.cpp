@@ -68,7 +68,7 @@ bool DownloadingBlockQueue::empty()
     {
         ReadGuard l1(x_buffer);
         ReadGuard l2(x_blocks);
-        res = m_blocks.empty() && (!m_buffer || m_buffer->empty());
+        res = m_blocks.empty() && (!m_buffer || m_buffer->empty()) && m_preparingShards == 0;
     }
     return res;
 }
@@ -77,7 +77,7 @@ size_t DownloadingBlockQueue::size()
 {
     ReadGuard l1(x_buffer);
     ReadGuard l2(x_blocks);
-    size_t s = (!m_buffer ? 0 : m_buffer->size()) + m_blocks.size();
+    size_t s = (!m_buffer ? 0 : m_buffer->size()) + m_blocks.size() + m_preparingShards;
     return s;
 }
 
@@ -105,6 +105,7 @@ void DownloadingBlockQueue::clear()
 {
     WriteGuard l(x_buffer);
     m_buffer->clear();
+    m_clearedTimes++;
 
     clearQueue();
 }
@@ -116,59 +117,124 @@ void DownloadingBlockQueue::clearQueue()
     swap(m_blocks, emptyQueue);  // Does memory leak here ?
 }
 
+void DownloadingBlockQueue::setPrepareThreadNum(size_t _threadNum)
+{
+    if (_threadNum > 0)
+        m_preparePool = make_shared<dev::ThreadPool>("SyncPrepare", _threadNum);
+    else
+        m_preparePool = nullptr;
+}
+
 void DownloadingBlockQueue::flushBufferToQueue()
 {
     shared_ptr<ShardPtrVec> localBuffer;
     {
         WriteGuard l(x_buffer);
-        localBuffer = m_buffer;                 //
-        m_buffer = make_shared<ShardPtrVec>();  // m_buffer point to a new vector
+        if (!m_preparePool)
+        {
+            localBuffer = m_buffer;                 //
+            m_buffer = make_shared<ShardPtrVec>();  // m_buffer point to a new vector
+        }
+        else
+        {
+            // only take the shards the prepare workers have room for, the rest wait in buffer
+            size_t preparing = m_preparingShards;
+            size_t room = preparing < c_maxPreparingShards ? c_maxPreparingShards - preparing : 0;
+            size_t takeNum = std::min(room, m_buffer->size());
+            localBuffer = make_shared<ShardPtrVec>(m_buffer->begin(), m_buffer->begin() + takeNum);
+            m_buffer->erase(m_buffer->begin(), m_buffer->begin() + takeNum);
+        }
     }
 
-    // pop buffer into queue
-    WriteGuard l(x_blocks);
-
     for (ShardPtr blocksShard : *localBuffer)
     {
-        if (m_blocks.size() >= c_maxDownloadingBlockQueueSize)  // TODO not to use size to control
-                                                                // insert
         {
-            SYNCLOG(TRACE)
-                << "[Download] [BlockSync] DownloadingBlockQueueBuffer is full with size "
-                << m_blocks.size();
-            break;
+            ReadGuard l(x_blocks);
+            if (m_blocks.size() >= c_maxDownloadingBlockQueueSize)  // TODO not to use size to
+                                                                    // control insert
+            {
+                SYNCLOG(TRACE)
+                    << "[Download] [BlockSync] DownloadingBlockQueueBuffer is full with size "
+                    << m_blocks.size();
+                break;
+            }
         }
 
         SYNCLOG(TRACE) << "[Download] [BlockSync] Decoding block buffer [size]: "
                        << blocksShard->blocksBytes.size() << endl;
 
-        RLP const& rlps = RLP(ref(blocksShard->blocksBytes));
-        unsigned itemCount = rlps.itemCount();
-        size_t successCnt = 0;
-        for (unsigned i = 0; i < itemCount; ++i)
+        if (!m_preparePool)
         {
+            unsigned itemCount = 0;
+            BlockPtrVec blocks = decodeShard(blocksShard, false, itemCount);
+            pushBlocks(blocks, itemCount);
+            continue;
+        }
+
+        // decode and recover senders while the sync thread executes the former blocks
+        m_preparingShards++;
+        uint64_t clearedTimes = m_clearedTimes;
+        m_preparePool->enqueue([this, blocksShard, clearedTimes]() {
             try
             {
-                shared_ptr<Block> block = make_shared<Block>(rlps[i].toBytes());
-                if (isNewerBlock(block))
-                {
-                    successCnt++;
-                    m_blocks.push(block);
-                }
+                unsigned itemCount = 0;
+                BlockPtrVec blocks = decodeShard(blocksShard, true, itemCount);
+                // the queue has been cleared since this shard was taken, drop it
+                if (clearedTimes == m_clearedTimes)
+                    pushBlocks(blocks, itemCount);
             }
             catch (std::exception& e)
             {
-                SYNCLOG(WARNING)
-                    << "[Download] [BlockSync] Invalid block RLP [reason/RLPDataSize]: " << e.what()
-                    << "/" << rlps.data().size() << endl;
+                SYNCLOG(WARNING) << "[Download] [BlockSync] Prepare block shard failed [reason]: "
+                                 << e.what() << endl;
+            }
+            m_preparingShards--;
+        });
+    }
+}
+
+BlockPtrVec DownloadingBlockQueue::decodeShard(
+    ShardPtr _shard, bool _prepare, unsigned& _itemCount)
+{
+    BlockPtrVec blocks;
+    RLP const& rlps = RLP(ref(_shard->blocksBytes));
+    _itemCount = rlps.itemCount();
+    for (unsigned i = 0; i < _itemCount; ++i)
+    {
+        try
+        {
+            shared_ptr<Block> block = make_shared<Block>(rlps[i].toBytes());
+            if (!isNewerBlock(block))
                 continue;
+            if (_prepare)
+            {
+                // memoise the header hash and the senders before the block is executed,
+                // invalid signatures are left to executeBlock to report
+                block->header().hash();
+                for (auto const& tx : block->transactions())
+                    tx.safeSender();
             }
+            blocks.emplace_back(block);
+        }
+        catch (std::exception& e)
+        {
+            SYNCLOG(WARNING) << "[Download] [BlockSync] Invalid block RLP [reason/RLPDataSize]: "
+                             << e.what() << "/" << rlps.data().size() << endl;
+            continue;
         }
-
-        SYNCLOG(TRACE) << "[Download] [BlockSync] Flush buffer to block queue "
-                          "[import/rcv/downloadBlockQueue]: "
-                       << successCnt << "/" << itemCount << "/" << m_blocks.size() << endl;
     }
+    return blocks;
+}
+
+void DownloadingBlockQueue::pushBlocks(BlockPtrVec const& _blocks, size_t _itemCount)
+{
+    WriteGuard l(x_blocks);
+    for (auto const& block : _blocks)
+        m_blocks.push(block);
+
+    SYNCLOG(TRACE) << "[Download] [BlockSync] Flush buffer to block queue "
+                      "[import/rcv/downloadBlockQueue]: "
+                   << _blocks.size() << "/" << _itemCount << "/" << m_blocks.size() << endl;
 }
 
 void DownloadingBlockQueue::clearFullQueueIfNotHas(int64_t _blockNumber)
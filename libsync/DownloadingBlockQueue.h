@@ -24,7 +24,9 @@
 #include "Common.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
 #include <libethcore/Block.h>
+#include <atomic>
 #include <climits>
 #include <queue>
 #include <set>
@@ -105,6 +107,13 @@ public:
 
     void clearFullQueueIfNotHas(int64_t _blockNumber);
 
+    /// decode buffered shards and recover transaction senders on _threadNum worker threads,
+    /// 0 decodes synchronously inside flushBufferToQueue
+    void setPrepareThreadNum(size_t _threadNum);
+
+    /// number of shards being decoded by the prepare workers
+    size_t preparingShards() const { return m_preparingShards; }
+
 private:
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
     PROTOCOL_ID m_protocolId;
@@ -116,8 +125,17 @@ private:
     mutable SharedMutex x_blocks;
     mutable SharedMutex x_buffer;
 
+    std::atomic<size_t> m_preparingShards = {0};
+    /// increased by clear() to discard shards which are still being prepared
+    std::atomic<uint64_t> m_clearedTimes = {0};
+    /// declared last: stopped before the queue it writes into is destroyed
+    std::shared_ptr<dev::ThreadPool> m_preparePool;
+
 private:
     bool isNewerBlock(std::shared_ptr<dev::eth::Block> _block);
+    /// decode a shard into blocks newer than the chain, optionally warming the caches
+    BlockPtrVec decodeShard(ShardPtr _shard, bool _prepare, unsigned& _itemCount);
+    void pushBlocks(BlockPtrVec const& _blocks, size_t _itemCount);
 };
 
 }  // namespace sync
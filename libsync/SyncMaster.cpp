@@ -382,12 +382,16 @@ void SyncMaster::maintainPeersStatus()
 bool SyncMaster::maintainDownloadingQueue()
 {
     int64_t currentNumber = m_blockChain->number();
+    m_blocksBehind->set(std::max(m_syncStatus->knownHighestNumber - currentNumber, (int64_t)0));
     if (currentNumber >= m_syncStatus->knownHighestNumber)
         return true;
 
     DownloadingBlockQueue& bq = m_syncStatus->bq();
 
     // pop block in sequence and ignore block which number is lower than currentNumber +1
+    // blocks of the queue have been decoded (and their senders recovered) by the prepare workers,
+    // which keep decoding the following shards while the blocks here are executed and committed
+    BlockInfo parentBlockInfo{h256(), -1, h256()};
     BlockPtr topBlock = bq.top();
     while (topBlock != nullptr && topBlock->header().number() <= (m_blockChain->number() + 1))
     {
@@ -395,16 +399,23 @@ bool SyncMaster::maintainDownloadingQueue()
         {
             if (isNewBlock(topBlock))
             {
-                auto parentBlock =
-                    m_blockChain->getBlockByNumber(topBlock->blockHeader().number() - 1);
-                BlockInfo parentBlockInfo{parentBlock->header().hash(),
-                    parentBlock->header().number(), parentBlock->header().stateRoot()};
+                // the parent is the block committed in the former round, only load it once
+                if (parentBlockInfo.number != topBlock->blockHeader().number() - 1)
+                {
+                    auto parentBlock =
+                        m_blockChain->getBlockByNumber(topBlock->blockHeader().number() - 1);
+                    parentBlockInfo = BlockInfo{parentBlock->header().hash(),
+                        parentBlock->header().number(), parentBlock->header().stateRoot()};
+                }
                 ExecutiveContext::Ptr exeCtx =
                     m_blockVerifier->executeBlock(*topBlock, parentBlockInfo);
                 CommitResult ret = m_blockChain->commitBlock(*topBlock, exeCtx);
                 if (ret == CommitResult::OK)
                 {
+                    parentBlockInfo = BlockInfo{topBlock->header().hash(),
+                        topBlock->header().number(), topBlock->header().stateRoot()};
                     m_txPool->dropBlockTrans(*topBlock);
+                    m_downloadedBlocks->add();
                     SYNCLOG(DEBUG)
                         << "[Download] [BlockSync] Download block commit [number/txs/hash]: "
                         << topBlock->header().number() << "/" << topBlock->transactions().size()
@@ -30,6 +30,7 @@
 #include <libblockchain/BlockChainInterface.h>
 #include <libblockverifier/BlockVerifierInterface.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/Metrics.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/Common.h>
 #include <libethcore/Exceptions.h>
@@ -52,7 +53,7 @@ public:
         std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
         std::shared_ptr<dev::blockverifier::BlockVerifierInterface> _blockVerifier,
         PROTOCOL_ID const& _protocolId, NodeID const& _nodeId, h256 const& _genesisHash,
-        unsigned _idleWaitMs = 200)
+        unsigned _idleWaitMs = 200, unsigned _prepareThreadNum = 0)
       : SyncInterface(),
         Worker("SyncMaster-" + std::to_string(_protocolId), _idleWaitMs),
         m_service(_service),
@@ -64,6 +65,7 @@ public:
         m_genesisHash(_genesisHash)
     {
         m_syncStatus = std::make_shared<SyncMasterStatus>(_blockChain, _protocolId, _genesisHash);
+        m_syncStatus->bq().setPrepareThreadNum(_prepareThreadNum);
         m_msgEngine = std::make_shared<SyncMsgEngine>(
             _service, _txPool, _blockChain, m_syncStatus, _protocolId, _nodeId, _genesisHash);
 
@@ -71,6 +73,13 @@ public:
         m_tqReady = m_txPool->onReady([&]() { this->noteNewTransactions(); });
         m_blockSubmitted = m_blockChain->onReady([&]() { this->noteNewBlocks(); });
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
+
+        std::string groupLabel = "group=\"" + std::to_string(m_groupId) + "\"";
+        m_blocksBehind = MetricsRegistry::instance().gauge("fisco_sync_blocks_behind",
+            "blocks between the local chain and the highest block known of the peers",
+            groupLabel);
+        m_downloadedBlocks = MetricsRegistry::instance().counter(
+            "fisco_sync_downloaded_blocks_total", "downloaded blocks committed", groupLabel);
     }
 
     virtual ~SyncMaster() { stop(); };
@@ -181,6 +190,9 @@ private:
     // verify handler to check downloading block
     std::function<bool(dev::eth::Block const&)> fp_isConsensusOk = nullptr;
 
+    MetricGauge::Ptr m_blocksBehind;
+    MetricCounter::Ptr m_downloadedBlocks;
+
 public:
     void maintainTransactions();
     void maintainBlocks();
@@ -173,32 +173,16 @@ void SyncMsgEngine::onPeerTransactions(SyncMsgPacket const& _packet)
 
     size_t successCnt = 0;
 
+    /// only check the signature format here, the senders are recovered by the txPool in batch
+    Transactions txs;
+    txs.reserve(itemCount);
     for (unsigned i = 0; i < itemCount; ++i)
     {
         try
         {
             Transaction tx;
-            tx.decode(rlps[i]);
-
-            auto importResult = m_txPool->import(tx);
-            if (ImportResult::Success == importResult)
-                successCnt++;
-            else if (ImportResult::AlreadyKnown == importResult)
-            {
-                SYNCLOG(TRACE) << "[Tx] Import peer transaction into txPool DUPLICATED from peer "
-                                  "[reason/txHash/peer]: "
-                               << int(importResult) << "/" << _packet.nodeId.abridged() << "/"
-                               << move(tx.sha3()) << endl;
-            }
-            else
-            {
-                SYNCLOG(TRACE) << "[Tx] Import peer transaction into txPool FAILED from peer "
-                                  "[reason/txHash/peer]: "
-                               << int(importResult) << "/" << _packet.nodeId.abridged() << "/"
-                               << move(tx.sha3()) << endl;
-            }
-
-            m_txPool->transactionIsKnownBy(tx.sha3(), _packet.nodeId);
+            tx.decode(rlps[i], CheckTransaction::Cheap);
+            txs.push_back(tx);
         }
         catch (std::exception& e)
         {
@@ -208,6 +192,31 @@ void SyncMsgEngine::onPeerTransactions(SyncMsgPacket const& _packet)
         }
     }
 
+    auto importResults = m_txPool->batchImport(txs);
+    for (size_t i = 0; i < txs.size(); ++i)
+    {
+        auto importResult = importResults[i];
+        if (ImportResult::Success == importResult)
+            successCnt++;
+        else if (ImportResult::AlreadyKnown == importResult)
+        {
+            SYNCLOG(TRACE) << "[Tx] Import peer transaction into txPool DUPLICATED from peer "
+                              "[reason/txHash/peer]: "
+                           << int(importResult) << "/" << _packet.nodeId.abridged() << "/"
+                           << move(txs[i].sha3()) << endl;
+        }
+        else
+        {
+            SYNCLOG(TRACE) << "[Tx] Import peer transaction into txPool FAILED from peer "
+                              "[reason/txHash/peer]: "
+                           << int(importResult) << "/" << _packet.nodeId.abridged() << "/"
+                           << move(txs[i].sha3()) << endl;
+        }
+
+        if (ImportResult::Malformed != importResult)
+            m_txPool->transactionIsKnownBy(txs[i].sha3(), _packet.nodeId);
+    }
+
     auto pengdingSize = m_txPool->pendingSize();
     SYNCLOG(DEBUG) << "[Tx] Import peer transactions [import/rcv/txPool]: " << successCnt << "/"
                    << itemCount << "/" << pengdingSize << " from " << _packet.nodeId.abridged()
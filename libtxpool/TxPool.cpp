@@ -23,6 +23,7 @@
  */
 #include "TxPool.h"
 #include <libethcore/Exceptions.h>
+#include <chrono>
 using namespace std;
 using namespace dev::p2p;
 using namespace dev::eth;
@@ -30,6 +31,28 @@ namespace dev
 {
 namespace txpool
 {
+namespace
+{
+/// adds _count to a size for the scope, unless kept when the reserved items have been added
+class SizeReservation
+{
+public:
+    SizeReservation(std::atomic<size_t>& _size, size_t _count)
+      : m_size(_size), m_count(_count), m_previous(_size.fetch_add(_count))
+    {}
+    ~SizeReservation() { m_size -= m_count; }
+
+    /// the size before the reservation
+    size_t previous() const { return m_previous; }
+    void keep() { m_count = 0; }
+
+private:
+    std::atomic<size_t>& m_size;
+    size_t m_count;
+    size_t m_previous;
+};
+}  // namespace
+
 /**
  * @brief submit a transaction through RPC/web3sdk
  *
@@ -115,24 +138,112 @@ ImportResult TxPool::import(bytesConstRef _txBytes, IfDropped _ik)
 ImportResult TxPool::import(Transaction& _tx, IfDropped _ik)
 {
     _tx.setImportTime(u256(utcTime()));
-    UpgradableGuard l(m_lock);
-    /// check the txpool size
-    if (m_txsQueue.size() >= m_limit)
+    /// check the txpool size, reserving the slot so that concurrent imports can't exceed it
+    SizeReservation pending(m_pendingSize, 1);
+    if (pending.previous() >= m_limit)
         return ImportResult::TransactionPoolIsFull;
     /// check the verify result(nonce && signature check)
     ImportResult verify_ret = verify(_tx);
     if (verify_ret == ImportResult::Success)
     {
-        UpgradeGuard ul(l);
-        if (insert(_tx))
+        verify_ret = insert(_tx);
+        if (verify_ret == ImportResult::Success)
         {
-            m_commonNonceCheck->insertCache(_tx);
+            pending.keep();
             m_onReady();
         }
     }
     return verify_ret;
 }
 
+void TxPool::setVerifyThreadNum(size_t _threadNum)
+{
+    m_verifyThreadNum = _threadNum;
+    if (_threadNum > 0)
+        m_verifyPool = std::make_shared<dev::ThreadPool>("txVerify", _threadNum);
+    else
+        m_verifyPool = nullptr;
+}
+
+bool TxPool::isKnown(h256 const& _txHash)
+{
+    auto& txShard = shard(_txHash);
+    ReadGuard l(txShard.lock);
+    return txShard.known.count(_txHash);
+}
+
+std::vector<ImportResult> TxPool::batchImport(Transactions& _txs, IfDropped _ik)
+{
+    std::vector<ImportResult> results(_txs.size(), ImportResult::TransactionPoolIsFull);
+    Transaction::calculateHashes(_txs);
+    /// already known transactions don't need to be verified again
+    std::vector<size_t> unknownTxs;
+    for (size_t i = 0; i < _txs.size(); i++)
+    {
+        if (isKnown(_txs[i].sha3()))
+            results[i] = ImportResult::AlreadyKnown;
+        else
+            unknownTxs.push_back(i);
+    }
+    /// backpressure: only verify the transactions that still fit into the pool
+    size_t busy = m_pendingSize + m_verifyingSize;
+    size_t verifyNum = busy < m_limit ? std::min(m_limit - busy, unknownTxs.size()) : 0;
+    if (verifyNum == 0)
+        return results;
+    SizeReservation verifying(m_verifyingSize, verifyNum);
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<char> valid(verifyNum, 0);
+    auto verify = [&](size_t _worker, size_t _workerNum) {
+        for (size_t i = _worker; i < verifyNum; i += _workerNum)
+        {
+            try
+            {
+                _txs[unknownTxs[i]].sender();
+                valid[i] = 1;
+            }
+            catch (...)
+            {
+                valid[i] = 0;
+            }
+        }
+    };
+    auto verifyPool = m_verifyPool;
+    if (verifyPool && verifyNum > 1)
+    {
+        size_t workerNum = std::min(m_verifyThreadNum, verifyNum);
+        verifyPool->runAndWait(workerNum, [&](size_t _worker) { verify(_worker, workerNum); });
+    }
+    else
+    {
+        verify(0, 1);
+    }
+    auto verifyTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime)
+                          .count();
+    m_verifyTimeUs += verifyTime;
+    m_verifiedCount += verifyNum;
+
+    for (size_t i = 0; i < verifyNum; i++)
+    {
+        auto& tx = _txs[unknownTxs[i]];
+        if (valid[i])
+        {
+            results[unknownTxs[i]] = import(tx, _ik);
+        }
+        else
+        {
+            TXPOOL_LOG(WARNING) << "[#batchImport] invalid signature, tx: " << tx.sha3().abridged()
+                                << std::endl;
+            results[unknownTxs[i]] = ImportResult::Malformed;
+        }
+    }
+    TXPOOL_LOG(DEBUG) << "[#batchImport] [txs/verified/verifyTimeUs/pending]:  " << _txs.size()
+                      << "/" << verifyNum << "/" << verifyTime << "/" << m_pendingSize
+                      << std::endl;
+    return results;
+}
+
 /**
  * @brief : verify specified transaction, including:
  *  1. whether the transaction is known (refuse repeated transaction)
@@ -148,16 +259,22 @@ ImportResult TxPool::verify(Transaction const& trans, IfDropped _drop_policy, bo
 {
     /// check whether this transaction has been existed
     h256 tx_hash = trans.sha3();
-    if (m_known.count(tx_hash))
-    {
-        TXPOOL_LOG(WARNING) << "[#Verify] already known tx: " << tx_hash.abridged() << std::endl;
-        return ImportResult::AlreadyKnown;
-    }
-    /// the transaction has been dropped before
-    if (m_dropped.count(tx_hash) && _drop_policy == IfDropped::Ignore)
     {
-        TXPOOL_LOG(WARNING) << "[#Verify] already dropped tx: " << tx_hash.abridged() << std::endl;
-        return ImportResult::AlreadyInChain;
+        auto& txShard = shard(tx_hash);
+        ReadGuard l(txShard.lock);
+        if (txShard.known.count(tx_hash))
+        {
+            TXPOOL_LOG(WARNING) << "[#Verify] already known tx: " << tx_hash.abridged()
+                                << std::endl;
+            return ImportResult::AlreadyKnown;
+        }
+        /// the transaction has been dropped before
+        if (txShard.dropped.count(tx_hash) && _drop_policy == IfDropped::Ignore)
+        {
+            TXPOOL_LOG(WARNING) << "[#Verify] already dropped tx: " << tx_hash.abridged()
+                                << std::endl;
+            return ImportResult::AlreadyInChain;
+        }
     }
     /// check nonce
     if (false == isBlockLimitOrNonceOk(trans, _needinsert))
@@ -187,13 +304,14 @@ bool TxPool::isBlockLimitOrNonceOk(Transaction const& _tx, bool _needInsert) con
 }
 
 /**
- * @brief : remove latest transactions from queue after the transaction queue overloaded
+ * @brief : remove the transaction from the queue and the indexes of its shard,
+ *          the caller must hold the write lock of the shard
  */
-bool TxPool::removeTrans(h256 const& _txHash, bool needTriggerCallback,
+bool TxPool::removeTrans(TxPoolShard& _shard, h256 const& _txHash, bool needTriggerCallback,
     dev::eth::LocalisedTransactionReceipt::Ptr pReceipt)
 {
-    auto p_tx = m_txsHash.find(_txHash);
-    if (p_tx == m_txsHash.end())
+    auto p_tx = _shard.txsHash.find(_txHash);
+    if (p_tx == _shard.txsHash.end())
     {
         return false;
     }
@@ -202,11 +320,16 @@ bool TxPool::removeTrans(h256 const& _txHash, bool needTriggerCallback,
     {
         p_tx->second->tiggerRpcCallback(pReceipt);
     }
-    m_txsQueue.erase(p_tx->second);
-    m_txsHash.erase(p_tx);
-    if (m_known.count(_txHash))
-        m_known.erase(_txHash);
-    removeTransactionKnowBy(_txHash);  // Remove the record of transaction know by some peers
+    {
+        WriteGuard l(x_txsQueue);
+        m_txsQueue.erase(p_tx->second);
+        m_pendingSize--;
+        m_pendingGauge->set(m_pendingSize);
+    }
+    _shard.txsHash.erase(p_tx);
+    _shard.known.erase(_txHash);
+    /// Remove the record of transaction know by some peers
+    _shard.transactionKnownBy.erase(_txHash);
     return true;
 }
 
@@ -214,18 +337,36 @@ bool TxPool::removeTrans(h256 const& _txHash, bool needTriggerCallback,
  * @brief : insert the newest transaction into the transaction queue
  * @param _tx: the give transaction queue can be inserted to the transaction queue
  */
-bool TxPool::insert(Transaction const& _tx)
+ImportResult TxPool::insert(Transaction const& _tx)
 {
     h256 tx_hash = _tx.sha3();
-    if (m_txsHash.count(tx_hash))
+    auto& txShard = shard(tx_hash);
+    WriteGuard l(txShard.lock);
+    /// the same transaction may have been imported concurrently since verify
+    if (txShard.known.count(tx_hash))
     {
         TXPOOL_LOG(WARNING) << "[#Insert] Already known tx:  " << tx_hash.abridged() << std::endl;
-        return false;
+        return ImportResult::AlreadyKnown;
     }
-    m_known.insert(tx_hash);
-    TransactionQueue::iterator p_tx = m_txsQueue.emplace(_tx).first;
-    m_txsHash[tx_hash] = p_tx;
-    return true;
+    /// check and occupy the nonce in one step, so that two transactions with the same nonce
+    /// can't both pass
+    if (!m_commonNonceCheck->isNonceOk(_tx, true))
+    {
+        TXPOOL_LOG(WARNING) << "[#Insert] check TxPool Nonce Failed, tx:  " << tx_hash.abridged()
+                            << std::endl;
+        return ImportResult::TxPoolNonceCheckFail;
+    }
+    txShard.known.insert(tx_hash);
+    TransactionQueue::iterator p_tx;
+    {
+        WriteGuard ql(x_txsQueue);
+        /// the slot has been reserved in m_pendingSize by import
+        p_tx = m_txsQueue.emplace(_tx).first;
+        m_pendingGauge->set(m_pendingSize);
+    }
+    txShard.txsHash[tx_hash] = p_tx;
+    m_importedCounter->add();
+    return ImportResult::Success;
 }
 
 /**
@@ -234,15 +375,21 @@ bool TxPool::insert(Transaction const& _tx)
  */
 bool TxPool::drop(h256 const& _txHash)
 {
-    UpgradableGuard l(m_lock);
-    if (!m_known.count(_txHash))
+    auto& txShard = shard(_txHash);
+    WriteGuard l(txShard.lock);
+    if (!txShard.known.count(_txHash))
         return false;
-    UpgradeGuard ul(l);
-    if (m_dropped.size() < m_limit)
-        m_dropped.insert(_txHash);
+    insertDropped(txShard, _txHash);
+    return removeTrans(txShard, _txHash);
+}
+
+/// record a dropped transaction, the caller must hold the write lock of the shard
+void TxPool::insertDropped(TxPoolShard& _shard, h256 const& _txHash)
+{
+    if (_shard.dropped.size() < std::max(m_limit / c_shardNum, (uint64_t)1))
+        _shard.dropped.insert(_txHash);
     else
-        m_dropped.clear();
-    return removeTrans(_txHash);
+        _shard.dropped.clear();
 }
 
 dev::eth::LocalisedTransactionReceipt::Ptr TxPool::constructTransactionReceipt(
@@ -255,22 +402,56 @@ dev::eth::LocalisedTransactionReceipt::Ptr TxPool::constructTransactionReceipt(
     return pTxReceipt;
 }
 
+/**
+ * @brief : remove the transactions of a block, the transactions are grouped by shard so that
+ *          every shard and the queue are only locked once per shard
+ */
 bool TxPool::dropTransactions(Block const& block, bool needNotify)
 {
     if (block.getTransactionSize() == 0)
         return true;
-    WriteGuard l(m_lock);
-    bool succ = true;
+    std::vector<std::vector<size_t>> shardTxs(c_shardNum);
+    Transaction::calculateHashes(block.transactions());
     for (size_t i = 0; i < block.transactions().size(); i++)
     {
-        LocalisedTransactionReceipt::Ptr pReceipt = nullptr;
-        if (block.transactionReceipts().size() > i)
+        shardTxs[shardIndex(block.transactions()[i].sha3())].push_back(i);
+    }
+    bool succ = true;
+    for (size_t s = 0; s < c_shardNum; s++)
+    {
+        if (shardTxs[s].empty())
+            continue;
+        auto& txShard = m_shards[s];
+        WriteGuard l(txShard.lock);
+        std::vector<TransactionQueue::iterator> removed;
+        removed.reserve(shardTxs[s].size());
+        for (auto i : shardTxs[s])
         {
-            pReceipt = constructTransactionReceipt(
-                block.transactions()[i], block.transactionReceipts()[i], block, i);
+            h256 txHash = block.transactions()[i].sha3();
+            auto p_tx = txShard.txsHash.find(txHash);
+            if (p_tx == txShard.txsHash.end())
+            {
+                succ = false;
+                continue;
+            }
+            /// trigger callback from RPC
+            if (block.transactionReceipts().size() > i)
+            {
+                p_tx->second->tiggerRpcCallback(constructTransactionReceipt(
+                    block.transactions()[i], block.transactionReceipts()[i], block, i));
+            }
+            removed.push_back(p_tx->second);
+            txShard.txsHash.erase(p_tx);
+            txShard.known.erase(txHash);
+            txShard.transactionKnownBy.erase(txHash);
         }
-        if (removeTrans(block.transactions()[i].sha3(), true, pReceipt) == false)
-            succ = false;
+        WriteGuard ql(x_txsQueue);
+        for (auto const& p_tx : removed)
+        {
+            m_txsQueue.erase(p_tx);
+        }
+        m_pendingSize -= removed.size();
+        m_pendingGauge->set(m_pendingSize);
     }
     return succ;
 }
@@ -310,36 +491,39 @@ dev::eth::Transactions TxPool::topTransactions(uint64_t const& _limit)
 
 Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, bool _updateAvoid)
 {
-    UpgradableGuard l(m_lock);
     uint64_t limit = min(m_limit, _limit);
     uint64_t txCnt = 0;
     Transactions ret;
     std::set<dev::h256> invalidBlockLimitTxs;
     std::set<std::string> nonceKeyCache;
-    for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
     {
-        /// check block limit and nonce again when obtain transactions
-        if (false == isBlockLimitOrNonceOk(*it, false))
-        {
-            invalidBlockLimitTxs.insert(it->sha3());
-            nonceKeyCache.insert(m_commonNonceCheck->generateKey(*it));
-            continue;
-        }
-        if (!_avoid.count(it->sha3()))
+        ReadGuard l(x_txsQueue);
+        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
         {
-            ret.push_back(*it);
-            txCnt++;
-            if (_updateAvoid)
-                _avoid.insert(it->sha3());
+            /// check block limit and nonce again when obtain transactions
+            if (false == isBlockLimitOrNonceOk(*it, false))
+            {
+                invalidBlockLimitTxs.insert(it->sha3());
+                nonceKeyCache.insert(m_commonNonceCheck->generateKey(*it));
+                continue;
+            }
+            if (!_avoid.count(it->sha3()))
+            {
+                ret.push_back(*it);
+                txCnt++;
+                if (_updateAvoid)
+                    _avoid.insert(it->sha3());
+            }
         }
     }
     if (invalidBlockLimitTxs.size() > 0)
     {
-        UpgradeGuard ul(l);
         for (auto txHash : invalidBlockLimitTxs)
         {
-            removeTrans(txHash);
-            m_dropped.insert(txHash);
+            auto& txShard = shard(txHash);
+            WriteGuard l(txShard.lock);
+            removeTrans(txShard, txHash);
+            txShard.dropped.insert(txHash);
         }
     }
     /// delete cached invalid nonce
@@ -354,7 +538,7 @@ Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, b
 Transactions TxPool::topTransactionsCondition(
     uint64_t const& _limit, std::function<bool(Transaction const&)> const& _condition)
 {
-    ReadGuard l(m_lock);
+    ReadGuard l(x_txsQueue);
     Transactions ret;
     uint64_t limit = min(m_limit, _limit);
     uint64_t txCnt = 0;
@@ -372,7 +556,7 @@ Transactions TxPool::topTransactionsCondition(
 /// get all transactions(maybe blocksync module need this interface)
 Transactions TxPool::pendingList() const
 {
-    ReadGuard l(m_lock);
+    ReadGuard l(x_txsQueue);
     Transactions ret;
     for (auto t = m_txsQueue.begin(); t != m_txsQueue.end(); ++t)
     {
@@ -381,48 +565,74 @@ Transactions TxPool::pendingList() const
     return ret;
 }
 
+std::shared_ptr<Transaction> TxPool::transactionInPool(h256 const& _txHash)
+{
+    auto& txShard = shard(_txHash);
+    ReadGuard l(txShard.lock);
+    auto p_tx = txShard.txsHash.find(_txHash);
+    if (p_tx == txShard.txsHash.end())
+    {
+        return nullptr;
+    }
+    return std::make_shared<Transaction>(*p_tx->second);
+}
+
 /// get current transaction num
 size_t TxPool::pendingSize()
 {
-    ReadGuard l(m_lock);
-    return m_txsQueue.size();
+    return m_pendingSize;
 }
 
 /// @returns the status of the transaction queue.
 TxPoolStatus TxPool::status() const
 {
     TxPoolStatus status;
-    ReadGuard l(m_lock);
-    status.current = m_txsQueue.size();
-    status.dropped = m_dropped.size();
+    status.current = m_pendingSize;
+    status.dropped = 0;
+    status.verifying = m_verifyingSize;
+    status.verified = m_verifiedCount;
+    status.verifyTimeUs = m_verifyTimeUs;
+    for (auto const& txShard : m_shards)
+    {
+        ReadGuard l(txShard.lock);
+        status.dropped += txShard.dropped.size();
+    }
     return status;
 }
 
 /// Clear the queue
 void TxPool::clear()
 {
-    WriteGuard l(m_lock);
-    m_known.clear();
+    for (auto& txShard : m_shards)
+    {
+        WriteGuard l(txShard.lock);
+        txShard.known.clear();
+        txShard.txsHash.clear();
+        txShard.dropped.clear();
+        txShard.transactionKnownBy.clear();
+    }
+    WriteGuard l(x_txsQueue);
+    /// keep the slots reserved by the imports in progress
+    m_pendingSize -= m_txsQueue.size();
     m_txsQueue.clear();
-    m_txsHash.clear();
-    m_dropped.clear();
-    WriteGuard l_trans(x_transactionKnownBy);
-    m_transactionKnownBy.clear();
+    m_pendingGauge->set(m_pendingSize);
 }
 
 /// Set transaction is known by a node
 void TxPool::transactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId)
 {
-    WriteGuard l(x_transactionKnownBy);
-    m_transactionKnownBy[_txHash].insert(_nodeId);
+    auto& txShard = shard(_txHash);
+    WriteGuard l(txShard.lock);
+    txShard.transactionKnownBy[_txHash].insert(_nodeId);
 }
 
 /// Is the transaction is known by the node ?
 bool TxPool::isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId)
 {
-    ReadGuard l(x_transactionKnownBy);
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p == m_transactionKnownBy.end())
+    auto& txShard = shard(_txHash);
+    ReadGuard l(txShard.lock);
+    auto p = txShard.transactionKnownBy.find(_txHash);
+    if (p == txShard.transactionKnownBy.end())
         return false;
     return p->second.find(_nodeId) != p->second.end();
 }
@@ -430,20 +640,13 @@ bool TxPool::isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId)
 /// Is the transaction is known by someone
 bool TxPool::isTransactionKnownBySomeone(h256 const& _txHash)
 {
-    ReadGuard l(x_transactionKnownBy);
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p == m_transactionKnownBy.end())
+    auto& txShard = shard(_txHash);
+    ReadGuard l(txShard.lock);
+    auto p = txShard.transactionKnownBy.find(_txHash);
+    if (p == txShard.transactionKnownBy.end())
         return false;
     return !p->second.empty();
 }
 
-void TxPool::removeTransactionKnowBy(h256 const& _txHash)
-{
-    WriteGuard l(x_transactionKnownBy);
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p != m_transactionKnownBy.end())
-        m_transactionKnownBy.erase(p);
-}
-
 }  // namespace txpool
 }  // namespace dev
@@ -25,6 +25,8 @@
 #include "TransactionNonceCheck.h"
 #include "TxPoolInterface.h"
 #include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/Metrics.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
 #include <libethcore/Common.h>
@@ -32,6 +34,8 @@
 #include <libethcore/Transaction.h>
 #include <libp2p/P2PInterface.h>
 #include <libp2p/Service.h>
+#include <array>
+#include <atomic>
 using namespace dev::eth;
 using namespace dev::p2p;
 
@@ -49,6 +53,11 @@ struct TxPoolStatus
 {
     size_t current;
     size_t dropped;
+    /// transactions of batchImport waiting for or under signature verification
+    size_t verifying = 0;
+    /// transactions verified by batchImport and the total time spent on them
+    uint64_t verified = 0;
+    uint64_t verifyTimeUs = 0;
 };
 
 class TxPoolNonceManager
@@ -71,7 +80,11 @@ public:
       : m_service(_p2pService),
         m_blockChain(_blockChain),
         m_limit(_limit),
-        m_protocolId(_protocolId)
+        m_protocolId(_protocolId),
+        m_pendingSize(0),
+        m_verifyingSize(0),
+        m_verifiedCount(0),
+        m_verifyTimeUs(0)
     {
         assert(m_service && m_blockChain);
         if (m_protocolId == 0)
@@ -79,6 +92,12 @@ public:
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
         m_txNonceCheck = std::make_shared<TransactionNonceCheck>(m_blockChain, m_protocolId);
         m_commonNonceCheck = std::make_shared<CommonTransactionNonceCheck>(m_protocolId);
+        std::string groupLabel = "group=\"" + std::to_string(m_groupId) + "\"";
+        m_pendingGauge = MetricsRegistry::instance().gauge("fisco_txpool_pending_transactions",
+            "transactions waiting in the txpool", groupLabel);
+        m_importedCounter = MetricsRegistry::instance().counter(
+            "fisco_txpool_imported_transactions_total", "transactions imported into the txpool",
+            groupLabel);
     }
     void setMaxBlockLimit(unsigned const& limit) { m_txNonceCheck->setBlockLimit(limit); }
     unsigned const& maxBlockLimit() { return m_txNonceCheck->maxBlockLimit(); }
@@ -97,6 +116,17 @@ public:
      * @param _txHash: Remove bad transaction from the queue
      */
     bool drop(h256 const& _txHash) override;
+
+    /// recover the senders of batchImport on _threadNum threads, 0 verifies on the caller thread
+    void setVerifyThreadNum(size_t _threadNum) override;
+    /**
+     * @brief : import a batch of transactions received from peers, the senders are recovered
+     *          in parallel before the transactions enter the pool. Transactions that are already
+     *          known are not verified again, and transactions that can't fit into the pool are
+     *          refused before verification
+     */
+    std::vector<ImportResult> batchImport(
+        Transactions& _txs, IfDropped _ik = IfDropped::Ignore) override;
     bool dropBlockTrans(dev::eth::Block const& block) override;
     bool handleBadBlock(dev::eth::Block const& block) override;
     /**
@@ -115,6 +145,7 @@ public:
 
     /// get all transactions(maybe blocksync module need this interface)
     Transactions pendingList() const override;
+    std::shared_ptr<Transaction> transactionInPool(h256 const& _txHash) override;
     /// get current transaction num
     size_t pendingSize() override;
 
@@ -156,13 +187,34 @@ protected:
     bool dropTransactions(Block const& block, bool needNotify = false);
 
 private:
+    /// transaction queue
+    using TransactionQueue = std::set<dev::eth::Transaction, transactionCompare>;
+    /// indexes of the transactions whose hash falls into the shard, protected by the lock of
+    /// the shard, so that transactions with different hashes seldom contend on the same lock
+    struct TxPoolShard
+    {
+        mutable SharedMutex lock;
+        std::unordered_map<h256, TransactionQueue::iterator> txsHash;
+        /// hash of imported transactions
+        h256Hash known;
+        /// hash of dropped transactions
+        h256Hash dropped;
+        /// Transaction is known by some peers
+        std::unordered_map<h256, std::set<h512>> transactionKnownBy;
+    };
+    static const size_t c_shardNum = 16;
+    static size_t shardIndex(h256 const& _txHash) { return _txHash[0] % c_shardNum; }
+    TxPoolShard& shard(h256 const& _txHash) { return m_shards[shardIndex(_txHash)]; }
+
     dev::eth::LocalisedTransactionReceipt::Ptr constructTransactionReceipt(Transaction const& tx,
         dev::eth::TransactionReceipt const& receipt, Block const& block, unsigned index);
 
-    bool removeTrans(h256 const& _txHash, bool needTriggerCallback = false,
+    bool removeTrans(TxPoolShard& _shard, h256 const& _txHash, bool needTriggerCallback = false,
         dev::eth::LocalisedTransactionReceipt::Ptr pReceipt = nullptr);
-    bool insert(Transaction const& _tx);
-    void removeTransactionKnowBy(h256 const& _txHash);
+    /// the caller must have reserved the slot of the transaction in m_pendingSize
+    ImportResult insert(Transaction const& _tx);
+    bool isKnown(h256 const& _txHash);
+    void insertDropped(TxPoolShard& _shard, h256 const& _txHash);
     bool inline txPoolNonceCheck(dev::eth::Transaction const& tx)
     {
         if (!m_commonNonceCheck->isNonceOk(tx))
@@ -182,22 +234,25 @@ private:
     std::shared_ptr<CommonTransactionNonceCheck> m_commonNonceCheck;
     /// Max number of pending transactions
     uint64_t m_limit;
-    mutable SharedMutex m_lock;
     /// protocolId
     PROTOCOL_ID m_protocolId;
     GROUP_ID m_groupId;
-    /// transaction queue
-    using TransactionQueue = std::set<dev::eth::Transaction, transactionCompare>;
+    /// transactions ordered by import time, used to select transactions when sealing
+    mutable SharedMutex x_txsQueue;
     TransactionQueue m_txsQueue;
-    std::unordered_map<h256, TransactionQueue::iterator> m_txsHash;
-    /// hash of imported transactions
-    h256Hash m_known;
-    /// hash of dropped transactions
-    h256Hash m_dropped;
-
-    /// Transaction is known by some peers
-    mutable SharedMutex x_transactionKnownBy;
-    std::unordered_map<h256, std::set<h512>> m_transactionKnownBy;
+    std::atomic<size_t> m_pendingSize;
+    /// hash indexes, always locked before x_txsQueue
+    std::array<TxPoolShard, c_shardNum> m_shards;
+
+    /// workers recovering the senders of batchImport
+    std::shared_ptr<dev::ThreadPool> m_verifyPool;
+    size_t m_verifyThreadNum = 0;
+    std::atomic<size_t> m_verifyingSize;
+    std::atomic<uint64_t> m_verifiedCount;
+    std::atomic<uint64_t> m_verifyTimeUs;
+
+    MetricGauge::Ptr m_pendingGauge;
+    MetricCounter::Ptr m_importedCounter;
 };
 }  // namespace txpool
 }  // namespace dev
@@ -37,6 +37,8 @@ public:
     TxPoolInterface() = default;
     virtual ~TxPoolInterface(){};
     void setMaxBlockLimit(unsigned const& limit) {}
+    /// set the number of threads verifying the transactions of batchImport
+    virtual void setVerifyThreadNum(size_t _threadNum) {}
     /**
      * @brief Remove transaction from the queue
      * @param _txHash: transaction hash
@@ -63,6 +65,11 @@ public:
 
     /// get all current transactions(maybe blocksync module need this interface)
     virtual dev::eth::Transactions pendingList() const = 0;
+    /// the pending transaction of the given hash, nullptr if it's not in the pool
+    virtual std::shared_ptr<dev::eth::Transaction> transactionInPool(h256 const& _txHash)
+    {
+        return nullptr;
+    }
     /// get current transaction num
     virtual size_t pendingSize() = 0;
 
@@ -84,6 +91,29 @@ public:
         dev::eth::Transaction& _tx, dev::eth::IfDropped _ik = dev::eth::IfDropped::Ignore) = 0;
     virtual dev::eth::ImportResult import(
         bytesConstRef _txBytes, dev::eth::IfDropped _ik = dev::eth::IfDropped::Ignore) = 0;
+    /**
+     * @brief : import a batch of transactions received from peers
+     * @param _txs : decoded transactions whose sender may not have been recovered yet
+     * @return std::vector<ImportResult> : import result of each transaction, in order of _txs
+     */
+    virtual std::vector<dev::eth::ImportResult> batchImport(
+        dev::eth::Transactions& _txs, dev::eth::IfDropped _ik = dev::eth::IfDropped::Ignore)
+    {
+        std::vector<dev::eth::ImportResult> results;
+        for (auto& tx : _txs)
+        {
+            try
+            {
+                tx.sender();
+                results.push_back(import(tx, _ik));
+            }
+            catch (std::exception const&)
+            {
+                results.push_back(dev::eth::ImportResult::Malformed);
+            }
+        }
+        return results;
+    }
     /// @returns the status of the transaction queue.
     virtual TxPoolStatus status() const = 0;
 
@@ -259,6 +259,21 @@ BOOST_AUTO_TEST_CASE(getBlockByHash)
     BOOST_CHECK_EQUAL(bptr->getTransactionSize(), 5);
 }
 
+BOOST_AUTO_TEST_CASE(getBlockByHashBinary)
+{
+    FakeBlock fakeBlock(3);
+    auto blockHash = fakeBlock.getBlock().blockHeader().hash();
+    Entry::Ptr entry = std::make_shared<Entry>();
+    entry->setField("value", BlockChainImp::encodeBlockValue(fakeBlock.getBlock()));
+    m_mockTable->m_fakeStorage[SYS_HASH_2_BLOCK][blockHash.hex()] = entry;
+    BOOST_CHECK_EQUAL(entry->getField("value").size(), fakeBlock.getBlockData().size());
+
+    std::shared_ptr<dev::eth::Block> bptr = m_blockChainImp->getBlockByHash(blockHash);
+    BOOST_CHECK(bptr != nullptr);
+    BOOST_CHECK_EQUAL(bptr->getTransactionSize(), 3);
+    BOOST_CHECK_EQUAL(bptr->blockHeader().hash(), blockHash);
+}
+
 BOOST_AUTO_TEST_CASE(getLocalisedTxByHash)
 {
     Transaction tx = m_blockChainImp->getLocalisedTxByHash(h256(c_commonHashPrefix));
@@ -286,6 +301,32 @@ BOOST_AUTO_TEST_CASE(getLocalisedTxReceiptByHash)
     BOOST_CHECK_EQUAL(localisedTxReceipt.hash(), h256(c_commonHashPrefix));
 }
 
+BOOST_AUTO_TEST_CASE(getTxByIndex)
+{
+    Entry::Ptr entry = std::make_shared<Entry>();
+    entry->setField("value", BlockChainImp::encodeBlockValue(m_fakeBlock->getBlock()));
+    m_mockTable->m_fakeStorage[SYS_HASH_2_BLOCK][c_commonHash] = entry;
+    entry = std::make_shared<Entry>();
+    entry->setField("value", "0");
+    entry->setField("index", "2");
+    m_mockTable->m_fakeStorage[SYS_TX_HASH_2_BLOCK][h256(2).hex()] = entry;
+    entry = std::make_shared<Entry>();
+    entry->setField("value", "0");
+    entry->setField("index", "5");
+    m_mockTable->m_fakeStorage[SYS_TX_HASH_2_BLOCK][h256(5).hex()] = entry;
+
+    Transaction tx = m_blockChainImp->getTxByHash(h256(2));
+    BOOST_CHECK_EQUAL(tx.sha3(), m_fakeBlock->m_transaction[2].sha3());
+    auto localisedTx = m_blockChainImp->getLocalisedTxByHash(h256(2));
+    BOOST_CHECK_EQUAL(localisedTx.transactionIndex(), 2);
+    BOOST_CHECK_EQUAL(localisedTx.blockHash(), h256(c_commonHashPrefix));
+    auto txReceipt = m_blockChainImp->getTransactionReceiptByHash(h256(2));
+    BOOST_CHECK_EQUAL(sha3(txReceipt.rlp()), sha3(m_fakeBlock->m_transactionReceipt[2].rlp()));
+
+    BOOST_CHECK_EQUAL(m_blockChainImp->getTxByHash(h256(5)), Transaction());
+    BOOST_CHECK_EQUAL(m_blockChainImp->getLocalisedTxReceiptByHash(h256(5)).hash(), h256(0));
+}
+
 BOOST_AUTO_TEST_CASE(commitBlock)
 {
     auto fakeBlock2 = std::make_shared<FakeBlock>(10);
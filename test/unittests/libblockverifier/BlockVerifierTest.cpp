@@ -25,7 +25,9 @@
 #include <libblockverifier/BlockVerifier.h>
 #include <libethcore/PrecompiledContract.h>
 #include <libmptstate/MPTStateFactory.h>
+#include <libstorage/ChainedStorage.h>
 #include <libstorage/LevelDBStorage.h>
+#include <libstoragestate/StorageStateFactory.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <test/unittests/libethcore/FakeBlock.h>
 #include <boost/test/unit_test.hpp>
@@ -35,6 +37,7 @@ using namespace dev::storage;
 using namespace dev::blockverifier;
 using namespace dev::mptstate;
 using namespace dev::executive;
+using namespace dev::storagestate;
 
 namespace dev
 {
@@ -108,6 +111,52 @@ struct BlockVerifierFixture
     std::unordered_map<Address, dev::eth::PrecompiledContract> m_precompiledContract;
 };
 
+/// executes blocks on storage state, serially or in parallel
+struct StorageStateVerifierFixture : public BlockVerifierFixture
+{
+    StorageStateVerifierFixture()
+    {
+        auto executiveContextFactory = std::make_shared<ExecutiveContextFactory>();
+        executiveContextFactory->setStateStorage(m_levelDBStorage);
+        executiveContextFactory->setStateFactory(std::make_shared<StorageStateFactory>(u256(0)));
+        m_serialVerifier = std::make_shared<BlockVerifier>();
+        m_serialVerifier->setExecutiveContextFactory(executiveContextFactory);
+        m_parallelVerifier = std::make_shared<BlockVerifier>();
+        m_parallelVerifier->setExecutiveContextFactory(executiveContextFactory);
+        m_parallelVerifier->setParallelExecution(true, 4);
+        for (auto verifier : {m_serialVerifier, m_parallelVerifier})
+        {
+            verifier->setNumberHash([](int64_t) { return h256(); });
+        }
+    }
+
+    Block newBlock(Transactions const& _transactions)
+    {
+        BlockHeader header;
+        header.setNumber(1);
+        header.setParentHash(h256(0));
+        header.setGasLimit(u256(1024 * 1024 * 1024));
+        header.setTimestamp(utcTime());
+        Block block;
+        block.setBlockHeader(header);
+        block.appendTransactions(_transactions);
+        return block;
+    }
+
+    Transaction transaction(Address const& _sender, Address const& _to, bytes const& _data)
+    {
+        u256 gas(30000000);
+        Transaction tx = _to == Address() ? Transaction(u256(0), u256(0), gas, _data) :
+                                            Transaction(u256(0), u256(0), gas, _to, _data);
+        tx.forceSender(_sender);
+        return tx;
+    }
+
+    BlockInfo m_parentBlockInfo{h256(0), 0, h256()};
+    BlockVerifier::Ptr m_serialVerifier;
+    BlockVerifier::Ptr m_parallelVerifier;
+};
+
 BOOST_FIXTURE_TEST_SUITE(BlockVerifierTest, BlockVerifierFixture);
 
 
@@ -147,5 +196,87 @@ BOOST_AUTO_TEST_CASE(executeBlock)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE(ParallelExecutionTest, StorageStateVerifierFixture)
+
+BOOST_AUTO_TEST_CASE(parallelSameAsSerial)
+{
+    /*
+    contract HelloWorld{
+        uint256 x;
+        function HelloWorld(){ x = 123; }
+        function get()constant returns(uint256){ return x; }
+        function set(uint256 n){ x = n; }
+    }
+    */
+    bytes code = fromHex(
+        "608060405234801561001057600080fd5b50607b60008190555060df806100276000396000f30060"
+        "80604052600436106049576000357c01000000000000000000000000000000000000000000000000"
+        "00000000900463ffffffff16806360fe47b114604e5780636d4ce63c146078575b600080fd5b3480"
+        "15605957600080fd5b5060766004803603810190808035906020019092919050505060a0565b005b"
+        "348015608357600080fd5b50608a60aa565b6040518082815260200191505060405180910390f35b"
+        "8060008190555050565b600080549050905600a165627a7a7230582093ef3ef61e120625973ff74d"
+        "aef914bf89008283e9c9937238f291c672adeb0d0029");
+    auto setX = [](std::string const& _x) {
+        return fromHex("60fe47b1" + std::string(64 - _x.size(), '0') + _x);
+    };
+    Address deployer("1000000000000000000000000000000000000000");
+
+    /// the parent state is empty, the contract is created at the same address in every block
+    Block deployBlock = newBlock(Transactions{transaction(deployer, Address(), code)});
+    m_serialVerifier->executeBlock(deployBlock, m_parentBlockInfo);
+    Address contract = deployBlock.transactionReceipts()[0].contractAddress();
+    BOOST_CHECK(contract != Address());
+
+    /// the calls conflict with the creation of the contract and with each other, the other
+    /// creations are independent
+    Transactions transactions{transaction(deployer, Address(), code),
+        transaction(Address(0x2001), contract, setX("aa")),
+        transaction(Address(0x2002), Address(), code),
+        transaction(Address(0x2003), contract, setX("bb")),
+        transaction(Address(0x2004), Address(), code),
+        transaction(Address(0x2005), Address(), code)};
+    Block serialBlock = newBlock(transactions);
+    Block parallelBlock = newBlock(transactions);
+    auto serialContext = m_serialVerifier->executeBlock(serialBlock, m_parentBlockInfo);
+    auto parallelContext = m_parallelVerifier->executeBlock(parallelBlock, m_parentBlockInfo);
+
+    BOOST_CHECK(serialBlock.header().stateRoot() != h256());
+    BOOST_CHECK(parallelBlock.header().stateRoot() == serialBlock.header().stateRoot());
+    BOOST_CHECK(parallelBlock.header().receiptsRoot() == serialBlock.header().receiptsRoot());
+    BOOST_CHECK_EQUAL(parallelBlock.transactionReceipts().size(), transactions.size());
+    for (size_t i = 0; i < transactions.size(); ++i)
+    {
+        BOOST_CHECK(parallelBlock.transactionReceipts()[i].rlp() ==
+                    serialBlock.transactionReceipts()[i].rlp());
+    }
+    BOOST_CHECK(serialContext->getState()->storage(contract, u256(0)) == u256(0xbb));
+    BOOST_CHECK(parallelContext->getState()->storage(contract, u256(0)) == u256(0xbb));
+}
+
+BOOST_AUTO_TEST_CASE(blockHashOfCommittingBlocks)
+{
+    /// PUSH1 1 BLOCKHASH PUSH1 0 SSTORE PUSH1 2 BLOCKHASH PUSH1 1 SSTORE STOP
+    bytes code = fromHex("60014060005560024060015500");
+    h256 hash1(0x01);
+    h256 hash2(0x02);
+    /// blocks 1 and 2 are being committed, the chain doesn't know their hashes yet
+    auto state1 = std::make_shared<ChainedStorage>(
+        m_levelDBStorage, hash1, 1, std::vector<TableData::Ptr>());
+    auto state2 =
+        std::make_shared<ChainedStorage>(state1, hash2, 2, std::vector<TableData::Ptr>());
+
+    Block block = newBlock(Transactions{
+        transaction(Address("1000000000000000000000000000000000000000"), Address(), code)});
+    block.header().setNumber(3);
+    block.header().setParentHash(hash2);
+    auto context = m_serialVerifier->executeBlock(block, BlockInfo{hash2, 2, h256()}, state2);
+    Address contract = block.transactionReceipts()[0].contractAddress();
+    BOOST_CHECK(contract != Address());
+    BOOST_CHECK(context->getState()->storage(contract, u256(0)) == u256(hash1));
+    BOOST_CHECK(context->getState()->storage(contract, u256(1)) == u256(hash2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 }  // namespace test
 }  // namespace dev
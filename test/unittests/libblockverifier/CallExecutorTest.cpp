@@ -0,0 +1,221 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief unit tests of CallExecutor
+ *
+ * @file CallExecutorTest.cpp
+ * @date 2019-04-08
+ */
+#include <libblockverifier/CallExecutor.h>
+#include <libblockverifier/ExecutiveContextFactory.h>
+#include <libblockverifier/Precompiled.h>
+#include <libexecutive/StateFace.h>
+#include <libstorage/MemoryTableFactory.h>
+#include <libstorage/Storage.h>
+#include <libstoragestate/StorageStateFactory.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <thread>
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::storage;
+using namespace dev::blockverifier;
+using namespace dev::executive;
+using namespace dev::storagestate;
+
+namespace dev
+{
+namespace test
+{
+/// the empty state of the genesis block
+class MockCallStorage : public dev::storage::Storage
+{
+public:
+    Entries::Ptr select(h256, int, const std::string&, const std::string&) override
+    {
+        return std::make_shared<Entries>();
+    }
+    size_t commit(h256, int64_t, const std::vector<TableData::Ptr>&, h256) override { return 0; }
+    bool onlyDirty() override { return false; }
+};
+
+class MockCallPrecompiled : public Precompiled
+{
+public:
+    bytes call(ExecutiveContext::Ptr, bytesConstRef, Address const&) override { return bytes(); }
+};
+
+struct CallExecutorFixture
+{
+    typedef std::pair<ExecutionResult, TransactionReceipt> Result;
+
+    CallExecutorFixture()
+    {
+        m_executiveContextFactory = std::make_shared<ExecutiveContextFactory>();
+        m_executiveContextFactory->setStateStorage(std::make_shared<MockCallStorage>());
+        m_executiveContextFactory->setStateFactory(std::make_shared<StorageStateFactory>(u256(0)));
+
+        m_header.setNumber(1);
+        m_header.setParentHash(h256(0));
+        m_header.setGasLimit(u256(1024 * 1024 * 1024));
+        m_header.setTimestamp(utcTime());
+    }
+
+    /// the call executor running _execute on the context of each call
+    CallExecutor::Ptr callExecutor(
+        std::function<void(ExecutiveContext::Ptr)> const& _execute, size_t _threadNum = 1,
+        size_t _maxQueued = 10)
+    {
+        return std::make_shared<CallExecutor>(
+            m_executiveContextFactory, [](int64_t) { return h256(); },
+            [_execute](EnvInfo const&, Transaction const&, ExecutiveContext::Ptr _context) {
+                _execute(_context);
+                return Result();
+            },
+            _threadNum, _maxQueued);
+    }
+
+    ExecutiveContextFactory::Ptr m_executiveContextFactory;
+    BlockHeader m_header;
+    Transaction m_tx;
+    Address m_contract = Address(0x2001);
+};
+
+BOOST_FIXTURE_TEST_SUITE(CallExecutorTest, CallExecutorFixture)
+
+BOOST_AUTO_TEST_CASE(reuseContext)
+{
+    std::vector<ExecutiveContext::Ptr> contexts;
+    auto executor = callExecutor([&](ExecutiveContext::Ptr _context) {
+        contexts.push_back(_context);
+    });
+
+    executor->call(m_header, m_tx);
+    executor->call(m_header, m_tx);
+    BOOST_CHECK_EQUAL(contexts.size(), 2u);
+    BOOST_CHECK(contexts[0] == contexts[1]);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsCreated, 1u);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsReused, 1u);
+
+    /// the contexts of an older block aren't reused for a newer one
+    BlockHeader header = m_header;
+    header.setNumber(2);
+    executor->call(header, m_tx);
+    BOOST_CHECK(contexts[2] != contexts[1]);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsCreated, 2u);
+    BOOST_CHECK_EQUAL(executor->metrics().calls, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(rollbackChanges)
+{
+    std::vector<u256> storage;
+    std::vector<bool> tableFound;
+    auto executor = callExecutor([&](ExecutiveContext::Ptr _context) {
+        storage.push_back(_context->getState()->storage(m_contract, u256(0)));
+        auto memoryTableFactory = _context->getMemoryTableFactory();
+        tableFound.push_back(memoryTableFactory->openTable("t_call") != nullptr);
+        _context->getState()->setStorage(m_contract, u256(0), u256(0xaa));
+        memoryTableFactory->createTable("t_call", "key", "value", false);
+    });
+
+    executor->call(m_header, m_tx);
+    executor->call(m_header, m_tx);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsReused, 1u);
+    /// the second call on the reused context doesn't see the changes of the first one
+    BOOST_CHECK(storage == std::vector<u256>({u256(0), u256(0)}));
+    BOOST_CHECK(tableFound == std::vector<bool>({false, false}));
+}
+
+BOOST_AUTO_TEST_CASE(unregisterPrecompiled)
+{
+    std::vector<Address> registered;
+    std::vector<bool> found;
+    auto executor = callExecutor([&](ExecutiveContext::Ptr _context) {
+        for (auto const& address : registered)
+        {
+            found.push_back(_context->isPrecompiled(address));
+        }
+        registered.push_back(
+            _context->registerPrecompiled(std::make_shared<MockCallPrecompiled>()));
+    });
+
+    executor->call(m_header, m_tx);
+    executor->call(m_header, m_tx);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsReused, 1u);
+    /// the precompileds of a finished call are gone, their addresses are handed out again
+    BOOST_CHECK(found == std::vector<bool>({false}));
+    BOOST_CHECK(registered[0] == registered[1]);
+}
+
+BOOST_AUTO_TEST_CASE(failedCall)
+{
+    size_t calls = 0;
+    auto executor = callExecutor([&](ExecutiveContext::Ptr) {
+        if (calls++ == 0)
+        {
+            BOOST_THROW_EXCEPTION(std::runtime_error("call failed"));
+        }
+    });
+
+    BOOST_CHECK_THROW(executor->call(m_header, m_tx), std::runtime_error);
+    executor->call(m_header, m_tx);
+    /// a context left in an unknown state by an exception isn't reused
+    BOOST_CHECK_EQUAL(executor->metrics().failures, 1u);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsCreated, 2u);
+    BOOST_CHECK_EQUAL(executor->metrics().contextsReused, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(callQueueFull)
+{
+    std::promise<void> executing;
+    std::promise<void> finish;
+    auto finished = finish.get_future().share();
+    bool first = true;
+    auto executor = callExecutor(
+        [&](ExecutiveContext::Ptr) {
+            if (first)
+            {
+                first = false;
+                executing.set_value();
+                finished.wait();
+            }
+        },
+        1, 1);
+
+    /// the first call occupies the only thread, the second one waits for it
+    auto running = std::async(std::launch::async, [&]() { executor->call(m_header, m_tx); });
+    executing.get_future().wait();
+    auto waiting = std::async(std::launch::async, [&]() { executor->call(m_header, m_tx); });
+    while (executor->metrics().queued == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    BOOST_CHECK_THROW(executor->call(m_header, m_tx), CallQueueFull);
+    BOOST_CHECK_EQUAL(executor->metrics().rejected, 1u);
+
+    finish.set_value();
+    running.get();
+    waiting.get();
+    BOOST_CHECK_EQUAL(executor->metrics().queued, 0u);
+    BOOST_CHECK_EQUAL(executor->metrics().calls, 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,103 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief unit tests of the binary transactions frame of ChannelRPCServer
+ *
+ * @file ChannelRPCServerTest.cpp
+ * @date 2019-04-08
+ */
+#include <libchannelserver/ChannelRPCServer.h>
+#include <libdevcore/CommonJS.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+struct TransactionsFrameFixture
+{
+    /// groupID 1 with the transactions 0xaabb and 0xcc
+    bytes frame = fromHex("0001" "00000002" "00000002aabb" "00000001cc");
+    int groupID = 0;
+    std::vector<bytesConstRef> rlps;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ChannelRPCServerTest, TransactionsFrameFixture)
+
+BOOST_AUTO_TEST_CASE(decodeTransactionsRequest)
+{
+    BOOST_CHECK_EQUAL(ChannelRPCServer::decodeTransactionsRequest(ref(frame), groupID, rlps), 0);
+    BOOST_CHECK_EQUAL(groupID, 1);
+    BOOST_REQUIRE_EQUAL(rlps.size(), 2u);
+    BOOST_CHECK(rlps[0].toBytes() == fromHex("aabb"));
+    BOOST_CHECK(rlps[1].toBytes() == fromHex("cc"));
+
+    /// empty transactions and no transactions at all
+    bytes empty = fromHex("0002" "00000002" "00000000" "00000000");
+    BOOST_CHECK_EQUAL(ChannelRPCServer::decodeTransactionsRequest(ref(empty), groupID, rlps), 0);
+    BOOST_CHECK_EQUAL(groupID, 2);
+    BOOST_CHECK_EQUAL(rlps.size(), 2u);
+    BOOST_CHECK(rlps[0].empty() && rlps[1].empty());
+    bytes none = fromHex("0003" "00000000");
+    BOOST_CHECK_EQUAL(ChannelRPCServer::decodeTransactionsRequest(ref(none), groupID, rlps), 0);
+    BOOST_CHECK(rlps.empty());
+}
+
+BOOST_AUTO_TEST_CASE(invalidTransactionsRequest)
+{
+    int invalid = ChannelRPCServer::INVALID_TRANSACTIONS_FRAME;
+    /// every truncation of a valid frame is invalid
+    for (size_t size = 0; size < frame.size(); ++size)
+    {
+        BOOST_CHECK_EQUAL(ChannelRPCServer::decodeTransactionsRequest(
+                              bytesConstRef(frame.data(), size), groupID, rlps),
+            invalid);
+        BOOST_CHECK(rlps.empty());
+    }
+
+    /// bytes after the last transaction
+    bytes trailing = frame;
+    trailing.push_back(0);
+    BOOST_CHECK_EQUAL(
+        ChannelRPCServer::decodeTransactionsRequest(ref(trailing), groupID, rlps), invalid);
+
+    /// a count or length beyond the frame, which doesn't overflow the offsets
+    bytes count = fromHex("0001" "ffffffff" "00000001cc");
+    BOOST_CHECK_EQUAL(
+        ChannelRPCServer::decodeTransactionsRequest(ref(count), groupID, rlps), invalid);
+    bytes length = fromHex("0001" "00000001" "ffffffffcc");
+    BOOST_CHECK_EQUAL(
+        ChannelRPCServer::decodeTransactionsRequest(ref(length), groupID, rlps), invalid);
+    BOOST_CHECK(rlps.empty());
+}
+
+BOOST_AUTO_TEST_CASE(encodeTransactionsResponse)
+{
+    h256 hash(0x1234);
+    std::vector<std::pair<int32_t, h256>> statuses{{0, hash}, {-1, h256()}};
+    bytes expected = fromHex("00000002") + fromHex("00000000") + hash.asBytes() +
+                     fromHex("ffffffff") + h256().asBytes();
+    BOOST_CHECK(ChannelRPCServer::encodeTransactionsResponse(statuses) == expected);
+    BOOST_CHECK(ChannelRPCServer::encodeTransactionsResponse({}) == fromHex("00000000"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -142,6 +142,26 @@ BOOST_AUTO_TEST_CASE(testPrepareReq)
     BOOST_CHECK(new_req.block == encodedData);
 }
 
+/// test the block of a compact prepareReq
+BOOST_AUTO_TEST_CASE(testCompactBlock)
+{
+    FakeBlock fake_block(5);
+    CompactBlock compact(fake_block.m_block);
+    BOOST_CHECK(compact.txHashes.size() == 5);
+    bytes data;
+    compact.encode(data);
+    CompactBlock decoded;
+    BOOST_REQUIRE_NO_THROW(decoded.decode(ref(data)));
+    BOOST_CHECK(decoded.header.hash() == fake_block.m_block.header().hash());
+    BOOST_CHECK(decoded.txHashes == compact.txHashes);
+    for (size_t i = 0; i < decoded.txHashes.size(); i++)
+    {
+        BOOST_CHECK(decoded.txHashes[i] == fake_block.m_block.transactions()[i].sha3());
+    }
+    /// the compact block is much smaller than the block
+    BOOST_CHECK(data.size() < fake_block.m_blockData.size());
+}
+
 /// test SignReq and CommitReq
 BOOST_AUTO_TEST_CASE(testSignReqAndCommitReq)
 {
@@ -134,6 +134,11 @@ public:
 
     void initPBFTEnv(unsigned _view_timeout) { return PBFTEngine::initPBFTEnv(_view_timeout); }
     void checkAndCommit() { return PBFTEngine::checkAndCommit(); }
+    bool checkSigList(Block const& block)
+    {
+        ReadGuard l(m_minerListMutex);
+        return PBFTEngine::checkSigList(block);
+    }
     static std::string const& backupKeyCommitted() { return PBFTEngine::c_backupKeyCommitted; }
     bool broadcastCommitReq(PrepareReq const& req) { return PBFTEngine::broadcastCommitReq(req); }
     bool broadcastViewChangeReq() { return PBFTEngine::broadcastViewChangeReq(); }
@@ -171,8 +176,41 @@ public:
         return PBFTEngine::handleCommitMsg(commit_req, pbftMsg);
     }
 
+    bool handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg)
+    {
+        return PBFTEngine::handleCompactPrepareMsg(prepareReq, pbftMsg);
+    }
+    void handleGetMissingTxsMsg(PBFTMsgPacket const& pbftMsg)
+    {
+        return PBFTEngine::handleGetMissingTxsMsg(pbftMsg);
+    }
+    void handleMissingTxsMsg(PBFTMsgPacket const& pbftMsg)
+    {
+        return PBFTEngine::handleMissingTxsMsg(pbftMsg);
+    }
+    void checkPendingCompactPrepare() { return PBFTEngine::checkPendingCompactPrepare(); }
+    std::shared_ptr<PendingCompactPrepare> pendingCompactPrepare()
+    {
+        return m_pendingCompactPrepare;
+    }
+
     bool shouldSeal() { return PBFTEngine::shouldSeal(); }
 
+    using PBFTEngine::PipelineCommit;
+    PipelineCommit commitInBackground(Block const& block, ExecutiveContext::Ptr const& context)
+    {
+        Guard l(m_mutex);
+        return PBFTEngine::commitInBackground(block, context);
+    }
+    bool waitForCommitter() { return PBFTEngine::waitForCommitter(); }
+    void handlePipelineFailure() { return PBFTEngine::handlePipelineFailure(); }
+    bool deferredCommit() const { return m_deferredCommit; }
+    bool isValidViewChangeReq(ViewChangeReq const& req, IDXTYPE const& source)
+    {
+        std::ostringstream oss;
+        return PBFTEngine::isValidViewChangeReq(req, source, oss);
+    }
+
     void setNodeIdx(IDXTYPE const& _idx) { m_idx = _idx; }
     void collectGarbage() { return PBFTEngine::collectGarbage(); }
     void handleFutureBlock() { return PBFTEngine::handleFutureBlock(); }
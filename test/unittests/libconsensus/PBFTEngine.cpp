@@ -401,6 +401,50 @@ BOOST_AUTO_TEST_CASE(testCheckAndCommit)
     /// checkReportBlock(fake_pbft, highest, false);
     /// BOOST_CHECK(fake_pbft.consensus()->timeManager().m_lastSignTime <= utcTime());
 }
+/// test checkSigList
+BOOST_AUTO_TEST_CASE(testCheckSigList)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(4, ProtocolID::PBFT);
+    fake_pbft.consensus()->setNodeNum(4);
+    fake_pbft.consensus()->setF(1);
+    Block block;
+    BlockHeader header;
+    header.setNumber(1);
+    block.setBlockHeader(header);
+    h256 blockHash = block.blockHeader().hash();
+    std::vector<std::pair<u256, Signature>> sigList;
+    for (size_t i = 0; i < fake_pbft.m_secrets.size(); i++)
+        sigList.push_back(std::make_pair(u256(i), sign(fake_pbft.m_secrets[i], blockHash)));
+
+    /// enough valid signatures
+    block.setSigList(std::vector<std::pair<u256, Signature>>(sigList.begin(), sigList.end() - 1));
+    BOOST_CHECK(fake_pbft.consensus()->checkSigList(block));
+    /// checked again through the verified signature cache
+    BOOST_CHECK(fake_pbft.consensus()->checkSigList(block));
+    /// signatures of the same miner only count once
+    block.setSigList({sigList[0], sigList[0], sigList[0]});
+    BOOST_CHECK(!fake_pbft.consensus()->checkSigList(block));
+    /// and aren't accepted along with a quorum
+    auto duplicateSigList = sigList;
+    duplicateSigList.push_back(std::make_pair(u256(0), sign(fake_pbft.m_secrets[1], blockHash)));
+    block.setSigList(duplicateSigList);
+    BOOST_CHECK(!fake_pbft.consensus()->checkSigList(block));
+    /// one invalid signature rejects the block, even with a quorum of valid ones
+    auto invalidSigList = sigList;
+    invalidSigList[3].second = sign(fake_pbft.m_secrets[0], blockHash);
+    block.setSigList(invalidSigList);
+    BOOST_CHECK(!fake_pbft.consensus()->checkSigList(block));
+    /// also when the invalid signature is checked first
+    invalidSigList = sigList;
+    invalidSigList[0].second = sign(fake_pbft.m_secrets[1], blockHash);
+    block.setSigList(invalidSigList);
+    BOOST_CHECK(!fake_pbft.consensus()->checkSigList(block));
+    /// signature of a non-miner index
+    sigList.push_back(std::make_pair(u256(4), sign(fake_pbft.m_secrets[0], blockHash)));
+    block.setSigList(sigList);
+    BOOST_CHECK(!fake_pbft.consensus()->checkSigList(block));
+}
+
 /// test isValidPrepare
 BOOST_AUTO_TEST_CASE(testIsValidPrepare)
 {
@@ -453,6 +497,129 @@ BOOST_AUTO_TEST_CASE(testHandlePrepareReq)
     CheckBlockChain(fake_pbft, block_number + 1);
 }
 
+/// test handleCompactPrepareMsg, fetching the missing transactions and forwarding the rebuilt
+/// prepareReq
+BOOST_AUTO_TEST_CASE(testHandleCompactPrepareReq)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(3, ProtocolID::PBFT);
+    fake_pbft.consensus()->initPBFTEnv(
+        3 * (fake_pbft.consensus()->timeManager().m_intervalBlockTime));
+    PrepareReq req;
+    TestIsValidPrepare(fake_pbft, req, true);
+    for (size_t i = 0; i < fake_pbft.m_minerList.size(); i++)
+    {
+        appendSessionInfo(fake_pbft, fake_pbft.m_minerList[i]);
+    }
+    fake_pbft.consensus()->reqCache()->clearAll();
+    fake_pbft.consensus()->setOmitEmpty(false);
+    /// the block carries transactions missing from the txpool, the header is unchanged
+    Block block;
+    block.decode(ref(req.block));
+    block.setTransactions(FakeBlock(3).m_block.transactions());
+    req.block.clear();
+    block.encode(req.block);
+    PrepareReq compactReq = req;
+    compactReq.block.clear();
+    CompactBlock(block).encode(compactReq.block);
+    /// received from a forwarder, neither the leader nor the other miner
+    h512 leader = fake_pbft.m_minerList[req.idx];
+    std::vector<IDXTYPE> others;
+    for (IDXTYPE i = 0; i < fake_pbft.m_minerList.size(); i++)
+    {
+        if (i != req.idx && i != fake_pbft.consensus()->nodeIdx())
+            others.push_back(i);
+    }
+    BOOST_CHECK(others.size() == 2);
+    h512 sender = fake_pbft.m_minerList[others[0]];
+    h512 other = fake_pbft.m_minerList[others[1]];
+    PBFTMsgPacket packet;
+    FakePBFTMsgPacket(packet, compactReq, CompactPrepareReqPacket, others[0], sender);
+
+    /// case1: the missing transactions are requested from the sender
+    PrepareReq decoded;
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(decoded, packet) == false);
+    auto pending = fake_pbft.consensus()->pendingCompactPrepare();
+    BOOST_CHECK(pending);
+    BOOST_CHECK(pending->missing.size() == 3);
+    BOOST_CHECK(pending->sources == std::vector<h512>({sender, leader}));
+    compareAsyncSendTime(fake_pbft, sender, 1);
+    compareAsyncSendTime(fake_pbft, leader, 0);
+
+    /// case2: another forwarder of the same prepareReq is a source as well
+    PBFTMsgPacket otherPacket;
+    FakePBFTMsgPacket(otherPacket, compactReq, CompactPrepareReqPacket, others[1], other);
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(decoded, otherPacket) == false);
+    BOOST_CHECK(pending->sources == std::vector<h512>({sender, leader, other}));
+    compareAsyncSendTime(fake_pbft, other, 0);
+
+    /// case3: the leader is asked once the sender didn't answer in time
+    fake_pbft.consensus()->checkPendingCompactPrepare();
+    compareAsyncSendTime(fake_pbft, leader, 0);
+    pending->requestTime = 0;
+    fake_pbft.consensus()->checkPendingCompactPrepare();
+    compareAsyncSendTime(fake_pbft, leader, 1);
+    BOOST_CHECK(pending->requested == 2);
+
+    /// case4: a response with wrong transactions is ignored
+    auto missingTxs = [&](Transactions const& txs) {
+        RLPStream s;
+        s.appendList(2) << req.block_hash;
+        s.appendList(txs.size());
+        for (auto const& tx : txs)
+        {
+            s.appendRaw(tx.rlp());
+        }
+        PBFTMsgPacket response;
+        s.swapOut(response.data);
+        response.packet_id = MissingTxsPacket;
+        response.setOtherField(req.idx, leader, "");
+        return response;
+    };
+    fake_pbft.consensus()->handleMissingTxsMsg(missingTxs(FakeBlock(3).m_block.transactions()));
+    BOOST_CHECK(fake_pbft.consensus()->pendingCompactPrepare() == pending);
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->rawPrepareCache().block_hash == h256());
+
+    /// case5: the prepareReq is rebuilt, handled and forwarded to the nodes but the sender and
+    /// the leader
+    FakeService* service =
+        dynamic_cast<FakeService*>(fake_pbft.consensus()->mutableService().get());
+    size_t sentToSender = service->getAsyncSendSizeByNodeID(sender);
+    size_t sentToOther = service->getAsyncSendSizeByNodeID(other);
+    BOOST_CHECK(!fake_pbft.consensus()->broadcastFilter(
+        other, CompactPrepareReqPacket, req.uniqueKey()));
+    fake_pbft.consensus()->handleMissingTxsMsg(missingTxs(block.transactions()));
+    BOOST_CHECK(!fake_pbft.consensus()->pendingCompactPrepare());
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->rawPrepareCache().block_hash == req.block_hash);
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->rawPrepareCache().block == req.block);
+    BOOST_CHECK(fake_pbft.consensus()->broadcastFilter(
+        other, CompactPrepareReqPacket, req.uniqueKey()));
+    /// both got the signReq, only the other node the forwarded prepareReq
+    BOOST_CHECK(service->getAsyncSendSizeByNodeID(other) - sentToOther ==
+                service->getAsyncSendSizeByNodeID(sender) - sentToSender + 1);
+
+    /// case6: the transactions of the handled prepareReq are served to the other nodes
+    size_t sent = service->getAsyncSendSizeByNodeID(other);
+    RLPStream request;
+    request.appendList(2) << req.block_hash;
+    request.appendVector(std::vector<unsigned>({0, 2}));
+    PBFTMsgPacket requestPacket;
+    request.swapOut(requestPacket.data);
+    requestPacket.packet_id = GetMissingTxsPacket;
+    requestPacket.setOtherField(others[1], other, "");
+    fake_pbft.consensus()->handleGetMissingTxsMsg(requestPacket);
+    compareAsyncSendTime(fake_pbft, other, sent + 1);
+    /// unknown, repeated, unordered or too many indexes aren't answered
+    for (auto indexes : std::vector<std::vector<unsigned>>{{3}, {0, 0}, {2, 0}, {0, 1, 2, 2}})
+    {
+        request.clear();
+        request.appendList(2) << req.block_hash;
+        request.appendVector(indexes);
+        request.swapOut(requestPacket.data);
+        fake_pbft.consensus()->handleGetMissingTxsMsg(requestPacket);
+        compareAsyncSendTime(fake_pbft, other, sent + 1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testIsValidSignReq)
 {
     FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
@@ -645,6 +812,126 @@ BOOST_AUTO_TEST_CASE(testHandleFutureBlock)
     BOOST_CHECK(fake_pbft.consensus()->reqCache()->futurePrepareCache().block_hash == h256());
 }
 
+/// test the blocks reaching consensus are committed in background in order
+BOOST_AUTO_TEST_CASE(testPipelineCommitOrder)
+{
+    auto chain = std::make_shared<PipelineBlockChain>();
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT, std::make_shared<FakeBlockSync>(),
+        std::make_shared<FakeBlockverifier>(), pipelineTxPool(chain));
+    auto pbft = fake_pbft.consensus();
+    pbft->initPBFTEnv(3 * (pbft->timeManager().m_intervalBlockTime));
+    pbft->setPipelineDepth(2);
+    int64_t number = chain->number();
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 1),
+                    pipelineContext("t_test", "value")) ==
+                FakePBFTEngine::PipelineCommit::Background);
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 2),
+                    pipelineContext("t_test", "value")) ==
+                FakePBFTEngine::PipelineCommit::Background);
+    auto committing = pbft->committingBlocks();
+    BOOST_CHECK(committing.size() == 2);
+    BOOST_CHECK(committing[0]->blockHeader().number() == number + 1);
+    /// the messages wait while the committer is behind
+    BOOST_CHECK(pbft->waitForCommitter() == false);
+
+    chain->open();
+    waitCommitted(pbft);
+    BOOST_CHECK(chain->committed == std::vector<int64_t>({number + 1, number + 2}));
+    BOOST_CHECK(pbft->waitForCommitter() == true);
+}
+
+/// test the blocks behind a block failed to be committed are dropped, and the engine goes back
+/// to the chain
+BOOST_AUTO_TEST_CASE(testPipelineFailure)
+{
+    auto chain = std::make_shared<PipelineBlockChain>();
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT, std::make_shared<FakeBlockSync>(),
+        std::make_shared<FakeBlockverifier>(), pipelineTxPool(chain));
+    auto pbft = fake_pbft.consensus();
+    pbft->initPBFTEnv(3 * (pbft->timeManager().m_intervalBlockTime));
+    pbft->setPipelineDepth(2);
+    int64_t number = chain->number();
+    chain->failAt = number + 1;
+    Block block1 = pipelineBlock(number + 1);
+    Block block2 = pipelineBlock(number + 2);
+    pbft->commitInBackground(block1, pipelineContext("t_test", "value"));
+    pbft->commitInBackground(block2, pipelineContext("t_test", "value"));
+    pbft->setHighest(block2.header());
+    pbft->mutableConsensusNumber() = number + 3;
+
+    chain->open();
+    waitCommitted(pbft);
+    BOOST_CHECK(chain->committed.empty());
+    /// the blocks reaching consensus meanwhile are committed synchronously
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 3),
+                    pipelineContext("t_test", "value")) ==
+                FakePBFTEngine::PipelineCommit::Synchronous);
+
+    pbft->handlePipelineFailure();
+    BOOST_CHECK(pbft->mutableHighest().hash() == chain->numberHash(number));
+    BOOST_CHECK(pbft->consensusBlockNumber() == number + 1);
+    chain->failAt = -1;
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 1),
+                    pipelineContext("t_test", "value")) ==
+                FakePBFTEngine::PipelineCommit::Background);
+    waitCommitted(pbft);
+}
+
+/// test a block writing the system tables is committed synchronously once the blocks before it
+/// are committed
+BOOST_AUTO_TEST_CASE(testPipelineSystemTables)
+{
+    auto chain = std::make_shared<PipelineBlockChain>();
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT, std::make_shared<FakeBlockSync>(),
+        std::make_shared<FakeBlockverifier>(), pipelineTxPool(chain));
+    auto pbft = fake_pbft.consensus();
+    pbft->initPBFTEnv(3 * (pbft->timeManager().m_intervalBlockTime));
+    pbft->setPipelineDepth(2);
+    int64_t number = chain->number();
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 1),
+                    pipelineContext("t_test", "value")) ==
+                FakePBFTEngine::PipelineCommit::Background);
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 2),
+                    pipelineContext(dev::storage::SYS_MINERS, "type")) ==
+                FakePBFTEngine::PipelineCommit::Deferred);
+    BOOST_CHECK(pbft->deferredCommit() == true);
+    BOOST_CHECK(pbft->committingBlocks().size() == 1);
+    BOOST_CHECK(pbft->waitForCommitter() == false);
+
+    chain->open();
+    while (!pbft->waitForCommitter())
+    {
+    }
+    BOOST_CHECK(pbft->deferredCommit() == false);
+    BOOST_CHECK(chain->committed == std::vector<int64_t>({number + 1}));
+    BOOST_CHECK(pbft->commitInBackground(pipelineBlock(number + 2),
+                    pipelineContext(dev::storage::SYS_CONFIG, "value")) ==
+                FakePBFTEngine::PipelineCommit::Synchronous);
+    BOOST_CHECK(pbft->committingBlocks().empty());
+}
+
+/// test view changes carrying the highest block are accepted while it's being committed
+BOOST_AUTO_TEST_CASE(testPipelineViewChange)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(3, ProtocolID::PBFT);
+    auto pbft = fake_pbft.consensus();
+    pbft->initPBFTEnv(3 * (pbft->timeManager().m_intervalBlockTime));
+    FakeBlockChain* p_blockChain = dynamic_cast<FakeBlockChain*>(pbft->blockChain().get());
+    BlockHeader highest = p_blockChain->getBlockByNumber(p_blockChain->number())->header();
+    highest.setParentHash(highest.hash());
+    highest.setNumber(highest.number() + 1);
+    BOOST_CHECK(p_blockChain->getBlockByHash(highest.hash()) == nullptr);
+    pbft->setHighest(highest);
+
+    ViewChangeReq req(
+        KeyPair(fake_pbft.m_secrets[1]), highest.number(), pbft->view() + 1, 1, highest.hash());
+    BOOST_CHECK(pbft->isValidViewChangeReq(req, 1) == true);
+    /// but not another block of its number
+    ViewChangeReq invalid(
+        KeyPair(fake_pbft.m_secrets[1]), highest.number(), pbft->view() + 1, 1, sha3("invalid"));
+    BOOST_CHECK(pbft->isValidViewChangeReq(invalid, 1) == false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
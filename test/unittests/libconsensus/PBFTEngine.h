@@ -26,9 +26,12 @@
 #include "PBFTReqCache.h"
 #include <libconsensus/pbft/PBFTEngine.h>
 #include <libethcore/Protocol.h>
+#include <libstorage/MemoryTableFactory.h>
 #include <test/unittests/libsync/FakeSyncToolsSet.h>
 #include <boost/test/unit_test.hpp>
+#include <future>
 #include <memory>
+#include <thread>
 using namespace dev::eth;
 using namespace dev::blockverifier;
 using namespace dev::txpool;
@@ -569,5 +572,94 @@ static void testReHandleCommitPrepareCache(
     }
 }
 
+/// chain whose commits are held back until open() and fail from a given block, recording the
+/// numbers of the blocks committed
+class PipelineBlockChain : public FakeBlockChain
+{
+public:
+    PipelineBlockChain() : FakeBlockChain(5, 5) { m_gate = m_open.get_future().share(); }
+
+    CommitResult commitBlock(
+        dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext> context)
+    {
+        m_gate.wait();
+        if (block.blockHeader().number() == failAt)
+        {
+            return CommitResult::ERROR_PARENT_HASH;
+        }
+        committed.push_back(block.blockHeader().number());
+        return FakeBlockChain::commitBlock(block, context);
+    }
+    dev::h256 numberHash(int64_t _i)
+    {
+        return _i <= number() ? FakeBlockChain::numberHash(_i) : h256();
+    }
+    void open() { m_open.set_value(); }
+
+    int64_t failAt = -1;
+    std::vector<int64_t> committed;
+
+private:
+    std::promise<void> m_open;
+    std::shared_future<void> m_gate;
+};
+
+/// storage of an empty state
+class PipelineStorage : public dev::storage::Storage
+{
+public:
+    dev::storage::Entries::Ptr select(
+        h256, int, const std::string&, const std::string&) override
+    {
+        return std::make_shared<dev::storage::Entries>();
+    }
+    size_t commit(h256, int64_t, const std::vector<dev::storage::TableData::Ptr>&, h256) override
+    {
+        return 0;
+    }
+    bool onlyDirty() override { return false; }
+};
+
+static std::shared_ptr<TxPoolFixture> pipelineTxPool(std::shared_ptr<PipelineBlockChain> chain)
+{
+    auto txpool_creator = std::make_shared<TxPoolFixture>(5, 5);
+    txpool_creator->m_blockChain = chain;
+    return txpool_creator;
+}
+
+static Block pipelineBlock(int64_t number)
+{
+    Block block;
+    block.header().setNumber(number);
+    block.header().setTimestamp(utcTime());
+    return block;
+}
+
+/// the context of a block which wrote the field of a row of the table
+static ExecutiveContext::Ptr pipelineContext(std::string const& table, std::string const& field)
+{
+    auto memoryTableFactory = std::make_shared<dev::storage::MemoryTableFactory>();
+    memoryTableFactory->setStateStorage(std::make_shared<PipelineStorage>());
+    auto tableHandler = memoryTableFactory->openTable(table, false);
+    if (!tableHandler)
+    {
+        tableHandler = memoryTableFactory->createTable(table, "key", field, false);
+    }
+    auto entry = tableHandler->newEntry();
+    entry->setField(field, "1");
+    tableHandler->insert("key", entry);
+    auto context = std::make_shared<ExecutiveContext>();
+    context->setMemoryTableFactory(memoryTableFactory);
+    return context;
+}
+
+static void waitCommitted(std::shared_ptr<FakePBFTEngine> pbft)
+{
+    while (!pbft->committingBlocks().empty())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
 }  // namespace test
 }  // namespace dev
@@ -0,0 +1,98 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: unit test for Metrics.* of libdevcore
+ *
+ * @file Metrics.cpp
+ * @date 2019-04-03
+ */
+
+#include <libdevcore/Metrics.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(MetricsTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(testHistogramBuckets)
+{
+    /// the small values have buckets of their own
+    for (uint64_t value = 0; value < 8; ++value)
+    {
+        BOOST_CHECK_EQUAL(MetricHistogram::bucketBound(MetricHistogram::bucketIndex(value)), value);
+    }
+    /// every value is in the bucket bounded by the smallest bound not below it
+    for (uint64_t value : {9, 100, 1000, 4095, 4096, 123456789})
+    {
+        size_t index = MetricHistogram::bucketIndex(value);
+        BOOST_CHECK(MetricHistogram::bucketBound(index) >= value);
+        BOOST_CHECK(MetricHistogram::bucketBound(index - 1) < value);
+        /// the bound is 25% above the value at most
+        BOOST_CHECK(MetricHistogram::bucketBound(index) <= value + value / 4);
+    }
+    BOOST_CHECK_EQUAL(MetricHistogram::bucketIndex(UINT64_MAX), MetricHistogram::BUCKETS - 1);
+
+    MetricHistogram histogram;
+    histogram.observe(3);
+    histogram.observe(100);
+    histogram.observe(100);
+    BOOST_CHECK_EQUAL(histogram.count(), 3);
+    BOOST_CHECK_EQUAL(histogram.sum(), 203);
+    BOOST_CHECK_EQUAL(histogram.bucketCount(MetricHistogram::bucketIndex(100)), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testRegistry)
+{
+    auto& registry = MetricsRegistry::instance();
+    auto counter = registry.counter("test_metrics_counter_total", "a counter", "group=\"1\"");
+    /// registered once, the same metric is returned afterwards
+    BOOST_CHECK(registry.counter("test_metrics_counter_total", "", "group=\"1\"") == counter);
+    BOOST_CHECK(registry.counter("test_metrics_counter_total", "", "group=\"2\"") != counter);
+    BOOST_CHECK_THROW(registry.gauge("test_metrics_counter_total", ""), MetricTypeMismatch);
+
+    counter->add(5);
+    auto gauge = registry.gauge("test_metrics_gauge", "a gauge");
+    gauge->set(7);
+    gauge->sub(9);
+    auto histogram = registry.histogram("test_metrics_histogram", "a histogram");
+    histogram->observe(2);
+    histogram->observe(5);
+
+    std::string exposition = registry.exposition();
+    auto exposed = [&exposition](std::string const& _line) {
+        return exposition.find(_line) != std::string::npos;
+    };
+    BOOST_CHECK(exposed("# TYPE test_metrics_counter_total counter\n"));
+    BOOST_CHECK(exposed("test_metrics_counter_total{group=\"1\"} 5\n"));
+    BOOST_CHECK(exposed("test_metrics_counter_total{group=\"2\"} 0\n"));
+    BOOST_CHECK(exposed("test_metrics_gauge -2\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_bucket{le=\"1\"} 0\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_bucket{le=\"2\"} 1\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_bucket{le=\"5\"} 2\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_bucket{le=\"+Inf\"} 2\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_sum 7\n"));
+    BOOST_CHECK(exposed("test_metrics_histogram_count 2\n"));
+    /// the buckets above the largest value are left out
+    BOOST_CHECK(!exposed("test_metrics_histogram_bucket{le=\"6\"}"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
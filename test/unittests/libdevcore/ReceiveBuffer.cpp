@@ -0,0 +1,85 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: unit test for ReceiveBuffer.h of libdevcore
+ *
+ * @file ReceiveBuffer.cpp
+ * @date 2019-04-04
+ */
+
+#include <libdevcore/ReceiveBuffer.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(ReceiveBufferTest, TestOutputHelperFixture)
+
+/// write _size bytes counting from _from into the free space of _buffer
+static void receive(ReceiveBuffer& _buffer, size_t _size, byte _from)
+{
+    auto space = _buffer.prepare();
+    BOOST_REQUIRE(space.size() >= _size);
+    for (size_t i = 0; i < _size; ++i)
+    {
+        space[i] = _from + i;
+    }
+    _buffer.commit(_size);
+}
+
+BOOST_AUTO_TEST_CASE(testConsume)
+{
+    ReceiveBuffer buffer(8);
+    BOOST_CHECK(buffer.prepare().size() >= 8);
+    BOOST_CHECK_EQUAL(buffer.size(), 0);
+
+    receive(buffer, 6, 0);
+    BOOST_CHECK_EQUAL(buffer.size(), 6);
+    buffer.consume(4);
+    BOOST_CHECK(buffer.data().toBytes() == bytes({4, 5}));
+
+    /// the bytes left are kept across the reads, moved to the front when the space runs out
+    receive(buffer, 8, 6);
+    BOOST_CHECK_EQUAL(buffer.size(), 10);
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(buffer.data()[i], 4 + i);
+    }
+    buffer.consume(10);
+    BOOST_CHECK_EQUAL(buffer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testGrowAndShrink)
+{
+    ReceiveBuffer buffer(4);
+    /// a message larger than a read grows the buffer
+    for (byte i = 0; i < 100; ++i)
+    {
+        receive(buffer, 4, i * 4);
+    }
+    BOOST_CHECK_EQUAL(buffer.size(), 400);
+    BOOST_CHECK_EQUAL(buffer.data()[399], (byte)399);
+    buffer.consume(400);
+    /// and the memory is given back once it's consumed
+    BOOST_CHECK(buffer.prepare().size() < 400);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
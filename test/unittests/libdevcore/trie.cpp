@@ -19,6 +19,7 @@
 #include <json_spirit/JsonSpiritHeaders.h>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/MemoryDB.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/TrieDB.h>
 #include <libdevcore/TrieHash.h>
 #include <libdevcore/easylog.h>
@@ -712,5 +713,25 @@ BOOST_AUTO_TEST_CASE(triePerf)
         clog << "Skipping hive test Crypto/Trie/triePerf. Use --all to run it.\n";
 }
 
+BOOST_AUTO_TEST_CASE(parallelOrderedTrieRoot)
+{
+    ThreadPool pool("trieRoot", 4);
+    for (size_t size : {0, 1, 2, 17, 128, 129, 1000, 3000})
+    {
+        std::vector<bytes> data(size);
+        BytesMap m;
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = bytes(i % 3 == 0 ? i % 31 : 40 + i % 300, (byte)i);
+            m[rlp(i)] = data[i];
+        }
+        /// the same root however the subtries are spread over the workers
+        for (size_t threadNum : {1, 3, 4})
+        {
+            BOOST_CHECK_EQUAL(orderedTrieRoot(data, pool, threadNum), hash256(m));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 #include "libdevcrypto/Hash.h"
 #include <libdevcore/Assertions.h>
 #include <libdevcore/CommonJS.h>
+#include <test/tools/libbcos/Options.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 #include <string>
@@ -192,6 +193,81 @@ BOOST_AUTO_TEST_CASE(testRipemd160)
     BOOST_CHECK(toJS(ripemd160(bsConst)) == cipherText);
 }
 #endif
+
+BOOST_AUTO_TEST_CASE(testSha3Batch)
+{
+    /// inputs around the block boundaries, more of some sizes than the lanes
+    std::vector<bytes> inputs;
+    for (size_t size = 0; size < 300; ++size)
+    {
+        for (size_t i = 0; i < 1 + size % 6; ++i)
+        {
+            inputs.push_back(bytes(size, (byte)(size + i)));
+        }
+    }
+    std::vector<bytesConstRef> refs;
+    for (auto const& input : inputs)
+    {
+        refs.push_back(bytesConstRef(&input));
+    }
+    h256s hashes = sha3Batch(refs);
+    BOOST_REQUIRE_EQUAL(hashes.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(hashes[i], sha3(inputs[i]));
+    }
+    BOOST_CHECK(sha3Batch(std::vector<bytesConstRef>()).empty());
+}
+
+/// hash many messages of the sizes of transactions one by one and in batches
+BOOST_AUTO_TEST_CASE(benchSha3Batch, *boost::unit_test::label("bench"))
+{
+    if (!Options::get().all)
+    {
+        std::cout << "Skipping benchmark test because --all option is not specified.\n";
+        return;
+    }
+    const size_t messageNum = 4096;
+    const size_t rounds = 10;
+    for (size_t size : {100, 300, 1000})
+    {
+        std::vector<bytes> inputs;
+        std::vector<bytesConstRef> refs;
+        for (size_t i = 0; i < messageNum; ++i)
+        {
+            inputs.push_back(bytes(size, (byte)i));
+        }
+        for (auto const& input : inputs)
+        {
+            refs.push_back(bytesConstRef(&input));
+        }
+
+        h256s scalar(messageNum);
+        Timer timer;
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            for (size_t i = 0; i < messageNum; ++i)
+            {
+                scalar[i] = sha3(refs[i]);
+            }
+        }
+        double scalarTime = timer.elapsed();
+
+        h256s batch(messageNum);
+        timer.restart();
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            sha3Batch(refs, batch.data());
+        }
+        double batchTime = timer.elapsed();
+
+        BOOST_CHECK(scalar == batch);
+        std::cout << "benchSha3Batch: " << messageNum << " messages of " << size
+                  << " bytes, sha3 " << messageNum * rounds / scalarTime
+                  << " messages/s, sha3Batch " << messageNum * rounds / batchTime
+                  << " messages/s\n";
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
\ No newline at end of file
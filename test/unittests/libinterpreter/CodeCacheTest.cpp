@@ -0,0 +1,129 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief
+ *
+ * @file CodeCacheTest.cpp
+ * @date 2019-03-27
+ */
+
+#include <libdevcore/CommonData.h>
+#include <libdevcrypto/Hash.h>
+#include <libethcore/Instruction.h>
+#include <libinterpreter/CodeCache.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::test;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(CodeCacheTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(analyzeTest)
+{
+    bytes code = {(byte)Instruction::PUSH1, 0x10, (byte)Instruction::JUMP,
+        (byte)Instruction::PUSHC, (byte)Instruction::PUSH6, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+        (byte)Instruction::PUSH1, 0x10, (byte)Instruction::JUMPI, (byte)Instruction::STOP,
+        (byte)Instruction::STOP, (byte)Instruction::JUMPDEST, (byte)Instruction::STOP};
+
+    auto analyzed = AnalyzedCode::analyze(code.data(), code.size(), false);
+    BOOST_CHECK(analyzed->codeSize == code.size());
+    BOOST_CHECK(analyzed->code.size() == code.size() + 33);
+    BOOST_CHECK(analyzed->jumpDests == vector<uint64_t>({16}));
+    BOOST_CHECK(analyzed->findJumpDest(16) == 16);
+    BOOST_CHECK(analyzed->findJumpDest(17) == -1);
+    BOOST_CHECK(analyzed->findJumpDest(u256(1) << 64) == -1);
+    /// synthetic ops of user code can't be run
+    BOOST_CHECK(analyzed->code[3] == (byte)Instruction::INVALID);
+    BOOST_CHECK(analyzed->code[2] == (byte)Instruction::JUMP);
+    BOOST_CHECK(analyzed->pool.empty());
+
+    analyzed = AnalyzedCode::analyze(code.data(), code.size(), true);
+    BOOST_CHECK(analyzed->optimized);
+    BOOST_CHECK(analyzed->code[2] == (byte)Instruction::JUMPC);
+    BOOST_CHECK(analyzed->code[4] == (byte)Instruction::PUSHC);
+    BOOST_CHECK(analyzed->pool == vector<u256>({u256(0x010203040506)}));
+    BOOST_CHECK(analyzed->code[13] == (byte)Instruction::JUMPCI);
+}
+
+BOOST_AUTO_TEST_CASE(cacheTest)
+{
+    bytes code = fromHex("6001600101600055");
+    h256 codeHash = sha3(code);
+    CodeCache cache(1024 * 1024, true);
+
+    auto analyzed = cache.get(codeHash, code.data(), code.size());
+    BOOST_CHECK(cache.get(codeHash, code.data(), code.size()) == analyzed);
+    auto metrics = cache.metrics();
+    BOOST_CHECK(metrics.hits == 1u);
+    BOOST_CHECK(metrics.misses == 1u);
+    BOOST_CHECK(metrics.codes == 1u);
+    BOOST_CHECK(metrics.size == analyzed->size());
+
+    /// code without hash isn't cached
+    BOOST_CHECK(cache.get(h256(), code.data(), code.size()) != analyzed);
+    BOOST_CHECK(cache.metrics().codes == 1u);
+
+    /// analyzed again once the optimizations are switched
+    cache.setOptimize(false);
+    auto unoptimized = cache.get(codeHash, code.data(), code.size());
+    BOOST_CHECK(unoptimized != analyzed);
+    BOOST_CHECK(!unoptimized->optimized);
+    BOOST_CHECK(cache.metrics().misses == 2u);
+    BOOST_CHECK(cache.metrics().codes == 1u);
+
+    cache.clear();
+    BOOST_CHECK(cache.metrics().codes == 0u);
+    BOOST_CHECK(cache.metrics().size == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(evictTest)
+{
+    bytes code = fromHex("6001600101600055");
+    size_t codeSize = AnalyzedCode::analyze(code.data(), code.size(), true)->size();
+    CodeCache cache(codeSize * 3, true);
+
+    for (byte i = 0; i < 10; ++i)
+    {
+        code[1] = i;
+        cache.get(sha3(code), code.data(), code.size());
+    }
+    auto metrics = cache.metrics();
+    BOOST_CHECK(metrics.codes == 3u);
+    BOOST_CHECK(metrics.evictions == 7u);
+    BOOST_CHECK(metrics.size <= metrics.capacity);
+
+    /// the most recently used codes are kept
+    cache.get(sha3(code), code.data(), code.size());
+    BOOST_CHECK(cache.metrics().hits == 1u);
+
+    /// a cache without capacity caches nothing
+    cache.setCapacity(0);
+    BOOST_CHECK(cache.metrics().codes == 0u);
+    cache.get(sha3(code), code.data(), code.size());
+    BOOST_CHECK(cache.metrics().codes == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -24,8 +24,11 @@
 
 #include "libnetwork/Common.h"
 #include "libp2p/Common.h"
+#include "libp2p/P2PMessage.h"
 
 #include <libdevcore/Assertions.h>
+#include <libdevcore/ReceiveBuffer.h>
+#include <test/tools/libbcos/Options.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
@@ -188,6 +191,112 @@ BOOST_AUTO_TEST_CASE(testPeerSessionInfo)
 #endif
 }
 
+/// test the encoding shared by the sessions a message is multicasted to
+BOOST_AUTO_TEST_CASE(testEncodeOnce)
+{
+    auto message = std::make_shared<P2PMessage>();
+    message->setBuffer(std::make_shared<bytes>(bytes{1, 2, 3}));
+    message->setProtocolID(1);
+    message->setSeq(10);
+    BOOST_CHECK(!message->encodedBuffer());
+
+    message->encodeOnce();
+    auto encoded = message->encodedBuffer();
+    BOOST_CHECK(encoded);
+    bytes buffer;
+    message->encode(buffer);
+    BOOST_CHECK(*encoded == buffer);
+
+    /// unchanged fields keep the encoding
+    message->setSeq(10);
+    message->setLength(P2PMessage::HEADER_LENGTH + 3);
+    BOOST_CHECK(message->encodedBuffer() == encoded);
+    /// changed fields drop it
+    message->setSeq(11);
+    BOOST_CHECK(!message->encodedBuffer());
+}
+
+/// test the payloads compressed for the peers that can decompress them
+BOOST_AUTO_TEST_CASE(testCompressedMessage)
+{
+    auto message = std::make_shared<P2PMessage>();
+    message->setBuffer(std::make_shared<bytes>(4096, 'a'));
+    message->setProtocolID(1);
+    message->setSeq(10);
+    /// too short to be compressed
+    BOOST_CHECK(!message->compressedMessage(8192));
+
+    auto compressed = message->compressedMessage(1024);
+    BOOST_CHECK(compressed);
+    BOOST_CHECK(compressed == message->compressedMessage(1024));
+    BOOST_CHECK(compressed->packetType() & P2PMessage::COMPRESSED_FLAG);
+    BOOST_CHECK(compressed->seq() == message->seq());
+    BOOST_CHECK(compressed->buffer()->size() < message->buffer()->size());
+
+    bytes buffer;
+    compressed->encode(buffer);
+    auto decoded = std::make_shared<P2PMessage>();
+    BOOST_CHECK(decoded->decode(buffer.data(), buffer.size()) == (ssize_t)buffer.size());
+    BOOST_CHECK(*decoded->buffer() == *message->buffer());
+    BOOST_CHECK(decoded->packetType() == 0);
+    BOOST_CHECK(decoded->protocolID() == 1);
+    BOOST_CHECK(decoded->seq() == 10);
+
+    /// a corrupted payload is a protocol error
+    buffer[P2PMessage::HEADER_LENGTH + 4] ^= 0xff;
+    BOOST_CHECK(decoded->decode(buffer.data(), buffer.size()) == dev::network::PACKET_ERROR);
+
+    /// random data doesn't shrink and is sent uncompressed
+    message->setBuffer(std::make_shared<bytes>(h1024::random().asBytes()));
+    BOOST_CHECK(!message->compressedMessage(64));
+}
+
+/// decode many small messages received in a pipeline, the way the sessions do
+BOOST_AUTO_TEST_CASE(benchPipelinedDecode, *boost::unit_test::label("bench"))
+{
+    if (!Options::get().all)
+    {
+        std::cout << "Skipping benchmark test because --all option is not specified.\n";
+        return;
+    }
+    const size_t messageNum = 200000;
+    bytes stream;
+    for (size_t i = 0; i < messageNum; ++i)
+    {
+        auto message = std::make_shared<P2PMessage>();
+        message->setBuffer(std::make_shared<bytes>(64, i));
+        message->setProtocolID(1);
+        message->setSeq(i);
+        message->encode(stream);
+    }
+
+    ReceiveBuffer buffer(16 * 1024);
+    size_t decoded = 0;
+    Timer timer;
+    for (size_t offset = 0; offset < stream.size();)
+    {
+        auto space = buffer.prepare();
+        size_t size = std::min(space.size(), stream.size() - offset);
+        memcpy(space.data(), stream.data() + offset, size);
+        buffer.commit(size);
+        offset += size;
+        while (true)
+        {
+            auto message = std::make_shared<P2PMessage>();
+            auto data = buffer.data();
+            ssize_t result = message->decode(data.data(), data.size());
+            if (result <= 0)
+            {
+                break;
+            }
+            buffer.consume(result);
+            ++decoded;
+        }
+    }
+    BOOST_CHECK_EQUAL(decoded, messageNum);
+    std::cout << "benchPipelinedDecode: " << messageNum / timer.elapsed() << " messages/s\n";
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
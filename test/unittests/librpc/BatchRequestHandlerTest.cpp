@@ -0,0 +1,170 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @file BatchRequestHandlerTest.cpp
+ * @date 2019-04-08
+ */
+#include <json/json.h>
+#include <librpc/BatchRequestHandler.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace dev;
+using namespace dev::rpc;
+
+namespace dev
+{
+namespace test
+{
+/// answers a request with its id, the earlier requests taking longer, requests without an id
+/// are notifications and have no response, the method "fail" throws
+class FakeRequestHandler : public jsonrpc::IClientConnectionHandler
+{
+public:
+    void HandleRequest(const std::string& _request, std::string& _response) override
+    {
+        ++requests;
+        Json::Value request;
+        BOOST_REQUIRE(Json::Reader().parse(_request, request));
+        if (request["method"].asString() == "fail")
+        {
+            throw std::runtime_error("failed");
+        }
+        if (!request.isMember("id"))
+        {
+            _response.clear();
+            return;
+        }
+        int id = request["id"].asInt();
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(0, 20 - 2 * id)));
+        Json::Value response;
+        response["jsonrpc"] = "2.0";
+        response["id"] = id;
+        response["result"] = id * 10;
+        _response = Json::FastWriter().write(response);
+    }
+
+    std::atomic<size_t> requests = {0};
+};
+
+struct BatchRequestHandlerFixture
+{
+    std::string request(int _id)
+    {
+        return "{\"jsonrpc\":\"2.0\",\"method\":\"getBlockNumber\",\"params\":[1],\"id\":" +
+               std::to_string(_id) + "}";
+    }
+    std::string notification()
+    {
+        return "{\"jsonrpc\":\"2.0\",\"method\":\"getBlockNumber\",\"params\":[1]}";
+    }
+
+    FakeRequestHandler handler;
+};
+
+BOOST_FIXTURE_TEST_SUITE(BatchRequestHandlerTest, BatchRequestHandlerFixture)
+
+BOOST_AUTO_TEST_CASE(responsesInRequestOrder)
+{
+    BatchRequestHandler batchHandler(&handler, 4);
+    std::string batch = "[";
+    for (int id = 0; id < 10; ++id)
+    {
+        batch += (id == 0 ? "" : ",") + request(id);
+        if (id % 3 == 1)
+        {
+            batch += "," + notification();
+        }
+    }
+    batch += "]";
+
+    std::string response;
+    batchHandler.HandleRequest(batch, response);
+    BOOST_CHECK_EQUAL(handler.requests, 13u);
+    Json::Value responses;
+    BOOST_REQUIRE(Json::Reader().parse(response, responses));
+    BOOST_REQUIRE(responses.isArray());
+    /// the later requests finish first, the notifications are left out
+    BOOST_REQUIRE_EQUAL(responses.size(), 10u);
+    for (int id = 0; id < 10; ++id)
+    {
+        BOOST_CHECK_EQUAL(responses[id]["id"].asInt(), id);
+        BOOST_CHECK_EQUAL(responses[id]["result"].asInt(), id * 10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(failedRequests)
+{
+    BatchRequestHandler batchHandler(&handler, 4);
+    std::string failed = "{\"jsonrpc\":\"2.0\",\"method\":\"fail\",\"params\":[1],\"id\":7}";
+    std::string failedNotification = "{\"jsonrpc\":\"2.0\",\"method\":\"fail\",\"params\":[1]}";
+    std::string response;
+    batchHandler.HandleRequest(
+        "[" + request(1) + "," + failed + "," + failedNotification + "," + request(2) + "]",
+        response);
+    Json::Value responses;
+    BOOST_REQUIRE(Json::Reader().parse(response, responses));
+    BOOST_REQUIRE(responses.isArray());
+    /// the failed request is answered with an error in its place
+    BOOST_REQUIRE_EQUAL(responses.size(), 3u);
+    BOOST_CHECK_EQUAL(responses[0]["id"].asInt(), 1);
+    BOOST_CHECK_EQUAL(responses[1]["id"].asInt(), 7);
+    BOOST_CHECK_EQUAL(responses[1]["error"]["code"].asInt(), -32603);
+    BOOST_CHECK(!responses[1].isMember("result"));
+    BOOST_CHECK_EQUAL(responses[2]["id"].asInt(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(notBatches)
+{
+    BatchRequestHandler batchHandler(&handler, 4);
+    std::string response;
+    batchHandler.HandleRequest(request(1), response);
+    Json::Value single;
+    BOOST_REQUIRE(Json::Reader().parse(response, single));
+    BOOST_CHECK_EQUAL(single["id"].asInt(), 1);
+
+    /// a batch of notifications has no response
+    batchHandler.HandleRequest("[" + notification() + "," + notification() + "]", response);
+    BOOST_CHECK(response.empty());
+    BOOST_CHECK_EQUAL(handler.requests, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(withoutThreads)
+{
+    /// 0 threads passes the batch to the protocol handler as it is
+    class WholeBatchHandler : public jsonrpc::IClientConnectionHandler
+    {
+    public:
+        void HandleRequest(const std::string& _request, std::string& _response) override
+        {
+            _response = _request;
+        }
+    } wholeBatchHandler;
+    BatchRequestHandler batchHandler(&wholeBatchHandler, 0);
+    std::string batch = "[" + request(1) + "," + request(2) + "]";
+    std::string response;
+    batchHandler.HandleRequest(batch, response);
+    BOOST_CHECK_EQUAL(response, batch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
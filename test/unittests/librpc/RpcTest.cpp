@@ -695,6 +695,22 @@ BOOST_AUTO_TEST_CASE(testSendRawTransaction)
     BOOST_CHECK_THROW(rpc->sendRawTransaction(invalidGroup, rlpStr), JsonRpcException);
 }
 #endif
+
+BOOST_AUTO_TEST_CASE(testSubmitTransactions)
+{
+    bytes invalidTx = fromHex("0102");
+    std::vector<bytesConstRef> rlps{ref(invalidTx), bytesConstRef()};
+    auto results = rpc->submitTransactions(groupId, rlps);
+    BOOST_CHECK(results.size() == 2);
+    for (auto const& result : results)
+    {
+        BOOST_CHECK(result.first == dev::eth::ImportResult::Malformed);
+        BOOST_CHECK(result.second == h256());
+    }
+    BOOST_CHECK(rpc->submitTransactions(groupId, std::vector<bytesConstRef>()).empty());
+
+    BOOST_CHECK_THROW(rpc->submitTransactions(invalidGroup, rlps), JsonRpcException);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -0,0 +1,166 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file test_CachedStorage.cpp
+ *  @date 20190325
+ */
+
+#include "Common.h"
+#include <libdevcore/FixedHash.h>
+#include <libstorage/CachedStorage.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_CachedStorage
+{
+/// backend storing committed rows the way LevelDBStorage returns them
+class MockBackend : public dev::storage::Storage
+{
+public:
+    virtual ~MockBackend() {}
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override
+    {
+        ++selected;
+        auto it = data.find(table + "_" + key);
+        if (it != data.end())
+        {
+            return it->second;
+        }
+        return std::make_shared<Entries>();
+    }
+
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override
+    {
+        for (auto& tableData : datas)
+        {
+            for (auto& it : tableData->data)
+            {
+                data[tableData->tableName + "_" + it.first] = committedRow(it.second, hash, num);
+            }
+        }
+        return datas.size();
+    }
+
+    virtual bool onlyDirty() override { return false; }
+
+    size_t selected = 0;
+    std::map<std::string, Entries::Ptr> data;
+};
+
+struct CachedStorageFixture
+{
+    CachedStorageFixture()
+    {
+        backend = std::make_shared<MockBackend>();
+        storage = std::make_shared<CachedStorage>(backend, 1024 * 1024);
+    }
+
+    std::vector<TableData::Ptr> blockData(const std::string& key, const std::string& value)
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField("key", key);
+        entry->setField("value", value);
+        Entries::Ptr entries = std::make_shared<Entries>();
+        entries->addEntry(entry);
+
+        TableData::Ptr tableData = std::make_shared<TableData>();
+        tableData->tableName = "t_test";
+        tableData->data.insert(std::make_pair(key, entries));
+        return std::vector<TableData::Ptr>{tableData};
+    }
+
+    std::shared_ptr<MockBackend> backend;
+    CachedStorage::Ptr storage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(CachedStorage, CachedStorageFixture)
+
+BOOST_AUTO_TEST_CASE(selectCached)
+{
+    h256 hash(0x01);
+    backend->commit(hash, 1, blockData("name", "v1"), hash);
+
+    Entries::Ptr entries = storage->select(hash, 1, "t_test", "name");
+    BOOST_TEST_TRUE(entries->size() == 1u);
+    BOOST_TEST_TRUE(backend->selected == 1u);
+
+    /// the second select is a hit, and callers can't alter the cached row
+    entries->get(0)->setField("value", "changed");
+    entries = storage->select(hash, 1, "t_test", "name");
+    BOOST_TEST_TRUE(backend->selected == 1u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("value") == "v1");
+    BOOST_TEST_TRUE(entries->get(0)->dirty() == false);
+
+    /// missing rows are cached as well
+    BOOST_TEST_TRUE(storage->select(hash, 1, "t_test", "other")->size() == 0u);
+    BOOST_TEST_TRUE(storage->select(hash, 1, "t_test", "other")->size() == 0u);
+    BOOST_TEST_TRUE(backend->selected == 2u);
+
+    auto metrics = storage->metrics();
+    BOOST_TEST_TRUE(metrics.hits == 2u);
+    BOOST_TEST_TRUE(metrics.misses == 2u);
+    BOOST_TEST_TRUE(metrics.rows == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(commitUpdatesCache)
+{
+    h256 hash1(0x01);
+    h256 hash2(0x02);
+    storage->commit(hash1, 1, blockData("name", "v1"), hash1);
+    storage->select(hash1, 1, "t_test", "name");
+    storage->commit(hash2, 2, blockData("name", "v2"), hash2);
+
+    /// committed rows are served without the backend, and read as the backend returns them
+    Entries::Ptr entries = storage->select(hash2, 2, "t_test", "name");
+    Entries::Ptr expected = backend->select(hash2, 2, "t_test", "name");
+    BOOST_TEST_TRUE(backend->selected == 1u);
+    BOOST_TEST_TRUE(entries->size() == 1u);
+    BOOST_TEST_TRUE(*(entries->get(0)->fields()) == *(expected->get(0)->fields()));
+    BOOST_TEST_TRUE(entries->get(0)->getField("_num_") == "2");
+}
+
+BOOST_AUTO_TEST_CASE(evictLeastRecentlyUsed)
+{
+    /// room for a few small rows in every shard
+    storage = std::make_shared<dev::storage::CachedStorage>(backend, 16 * 512);
+    h256 hash(0x01);
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string key = "key" + std::to_string(i);
+        backend->commit(hash, 1, blockData(key, "value"), hash);
+        storage->select(hash, 1, "t_test", key);
+    }
+
+    auto metrics = storage->metrics();
+    BOOST_TEST_TRUE(metrics.misses == 200u);
+    BOOST_TEST_TRUE(metrics.evictions > 0u);
+    BOOST_TEST_TRUE(metrics.rows + metrics.evictions == 200u);
+    BOOST_TEST_TRUE(metrics.size <= metrics.capacity);
+
+    /// the last selected row is still cached
+    size_t selected = backend->selected;
+    storage->select(hash, 1, "t_test", "key199");
+    BOOST_TEST_TRUE(backend->selected == selected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_CachedStorage
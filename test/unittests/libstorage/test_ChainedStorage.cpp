@@ -0,0 +1,170 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file test_ChainedStorage.cpp
+ *  @date 20190405
+ */
+
+#include "Common.h"
+#include <libdevcore/FixedHash.h>
+#include <libstorage/ChainedStorage.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_ChainedStorage
+{
+/// backend storing committed rows the way LevelDBStorage returns them
+class MockBackend : public dev::storage::Storage
+{
+public:
+    virtual ~MockBackend() {}
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override
+    {
+        ++selected;
+        auto it = data.find(table + "_" + key);
+        if (it != data.end())
+        {
+            return committedRow(it->second, hash, num);
+        }
+        return std::make_shared<Entries>();
+    }
+
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override
+    {
+        ++committed;
+        for (auto& tableData : datas)
+        {
+            for (auto& it : tableData->data)
+            {
+                data[tableData->tableName + "_" + it.first] = committedRow(it.second, hash, num);
+            }
+        }
+        return datas.size();
+    }
+
+    virtual bool onlyDirty() override { return false; }
+
+    size_t selected = 0;
+    size_t committed = 0;
+    std::map<std::string, Entries::Ptr> data;
+};
+
+struct ChainedStorageFixture
+{
+    ChainedStorageFixture() { backend = std::make_shared<MockBackend>(); }
+
+    std::vector<TableData::Ptr> blockData(
+        const std::string& key, const std::string& value, const std::string& table = "t_test")
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField("key", key);
+        entry->setField("value", value);
+        Entries::Ptr entries = std::make_shared<Entries>();
+        entries->addEntry(entry);
+
+        TableData::Ptr tableData = std::make_shared<TableData>();
+        tableData->tableName = table;
+        tableData->data.insert(std::make_pair(key, entries));
+        return std::vector<TableData::Ptr>{tableData};
+    }
+
+    std::shared_ptr<MockBackend> backend;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ChainedStorage, ChainedStorageFixture)
+
+BOOST_AUTO_TEST_CASE(selectWrittenRows)
+{
+    h256 hash1(0x01);
+    h256 hash2(0x02);
+    backend->commit(hash1, 1, blockData("other", "v0"), hash1);
+
+    auto datas = blockData("name", "v2");
+    auto state = std::make_shared<dev::storage::ChainedStorage>(backend, hash2, 2, datas);
+    BOOST_TEST_TRUE(state->written("t_test"));
+    BOOST_TEST_TRUE(!state->written(SYS_MINERS));
+
+    /// the rows written by the block are served from the copy, taken as they are when committed
+    datas[0]->data["name"]->get(0)->setField("value", "changed");
+    Entries::Ptr entries = state->select(hash2, 3, "t_test", "name");
+    BOOST_TEST_TRUE(backend->selected == 0u);
+    BOOST_TEST_TRUE(entries->size() == 1u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("value") == "v2");
+    BOOST_TEST_TRUE(entries->get(0)->getField("_num_") == "2");
+
+    /// callers can't alter the copy
+    entries->get(0)->setField("value", "changed");
+    BOOST_TEST_TRUE(state->select(hash2, 3, "t_test", "name")->get(0)->getField("value") == "v2");
+
+    /// the other rows from the storage the block was executed on
+    entries = state->select(hash2, 3, "t_test", "other");
+    BOOST_TEST_TRUE(backend->selected == 1u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("value") == "v0");
+}
+
+BOOST_AUTO_TEST_CASE(rowsByTableAndKey)
+{
+    h256 hash1(0x01);
+    auto state = std::make_shared<dev::storage::ChainedStorage>(
+        backend, hash1, 1, blockData("c_name", "v1", "t_a"));
+    /// the same table and key joined with "_" are other rows
+    BOOST_TEST_TRUE(state->select(hash1, 2, "t_a", "c_name")->size() == 1u);
+    BOOST_TEST_TRUE(state->select(hash1, 2, "t_a_c", "name")->size() == 0u);
+    BOOST_TEST_TRUE(backend->selected == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(commitAndRelease)
+{
+    h256 hash1(0x01);
+    h256 hash2(0x02);
+    h256 hash3(0x03);
+    auto datas1 = blockData("name", "v1");
+    auto state1 = std::make_shared<dev::storage::ChainedStorage>(backend, hash1, 1, datas1);
+    auto datas2 = blockData("name", "v2");
+    auto state2 = std::make_shared<dev::storage::ChainedStorage>(state1, hash2, 2, datas2);
+    auto state3 =
+        std::make_shared<dev::storage::ChainedStorage>(state2, hash3, 3, blockData("key", "v3"));
+    BOOST_TEST_TRUE(state3->select(hash3, 4, "t_test", "name")->get(0)->getField("value") == "v2");
+    BOOST_TEST_TRUE(state3->blockHash(1) == hash1);
+    BOOST_TEST_TRUE(state3->blockHash(3) == hash3);
+    BOOST_TEST_TRUE(state3->blockHash(4) == h256());
+
+    /// the blocks are committed through the chain to the backend in order
+    state1->commit(hash1, 1, datas1, hash1);
+    BOOST_TEST_TRUE(backend->committed == 1u);
+    state1->release();
+    BOOST_TEST_TRUE(state3->select(hash3, 4, "t_test", "name")->get(0)->getField("value") == "v2");
+
+    state2->commit(hash2, 2, datas2, hash2);
+    BOOST_TEST_TRUE(backend->committed == 2u);
+    state2->release();
+    /// the released blocks are skipped, read from the backend
+    BOOST_TEST_TRUE(state2->parent() == backend);
+    /// the hashes of the blocks skipped are read from the chain
+    BOOST_TEST_TRUE(state3->blockHash(2) == hash2);
+    BOOST_TEST_TRUE(state3->blockHash(1) == h256());
+    BOOST_TEST_TRUE(state3->select(hash3, 4, "t_test", "name")->get(0)->getField("value") == "v2");
+    BOOST_TEST_TRUE(backend->selected == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_ChainedStorage
@@ -242,6 +242,42 @@ BOOST_AUTO_TEST_CASE(commit)
     BOOST_CHECK_EQUAL(entries->size(), 1u);
 }
 
+BOOST_AUTO_TEST_CASE(binaryCodec)
+{
+    h256 h(0x01);
+    int64_t num = 10;
+    Entries::Ptr entries = getEntries();
+    Entry::Ptr deleted = std::make_shared<Entry>();
+    deleted->setField("Name", std::string("\0\x01\xff", 3));
+    deleted->setStatus(Entry::Status::DELETED);
+    entries->addEntry(deleted);
+
+    std::string value = LevelDBStorage::encodeEntries(entries, h, num);
+    BOOST_CHECK_EQUAL(uint8_t(value[0]), LevelDBStorage::c_binaryRowVersion);
+
+    Entries::Ptr decoded = LevelDBStorage::decodeEntries(value);
+    BOOST_CHECK_EQUAL(decoded->size(), 2u);
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("Name"), "LiSi");
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("id"), "1");
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("_hash_"), h.hex());
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("_num_"), "10");
+    BOOST_CHECK_EQUAL(decoded->get(1)->getField("Name"), std::string("\0\x01\xff", 3));
+    BOOST_CHECK_EQUAL(decoded->get(1)->getStatus(), Entry::Status::DELETED);
+}
+
+BOOST_AUTO_TEST_CASE(legacyJsonRow)
+{
+    std::string value =
+        "{\"values\":[{\"Name\":\"LiSi\",\"_hash_\":\"" + h256(0x01).hex() +
+        "\",\"_num_\":10,\"_status_\":\"0\"}]}";
+    Entries::Ptr decoded = LevelDBStorage::decodeEntries(value);
+    BOOST_CHECK_EQUAL(decoded->size(), 1u);
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("Name"), "LiSi");
+    BOOST_CHECK_EQUAL(decoded->get(0)->getField("_num_"), "10");
+
+    BOOST_CHECK_THROW(LevelDBStorage::decodeEntries(std::string(1, char(0x7f))), boost::exception);
+}
+
 BOOST_AUTO_TEST_CASE(exception)
 {
     h256 h(0x01);
@@ -17,6 +17,7 @@
 
 #include "Common.h"
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
 #include <libstorage/Common.h>
 #include <libstorage/MemoryTable.h>
@@ -117,6 +118,358 @@ BOOST_AUTO_TEST_CASE(open_Table)
     memoryDBFactory->commitDB(h256(0), 2);
 }
 
+BOOST_AUTO_TEST_CASE(conflict_merge)
+{
+    auto write = [](dev::storage::MemoryTableFactory::Ptr factory, const std::string& key) {
+        auto table = factory->openTable(SYS_CURRENT_STATE);
+        auto entry = table->newEntry();
+        entry->setField(SYS_VALUE, key);
+        table->insert(key, entry);
+    };
+    auto newFactory = [this]() {
+        auto factory = std::make_shared<dev::storage::MemoryTableFactory>();
+        factory->setStateStorage(memoryDBFactory->stateStorage());
+        factory->setTrackAccess(true);
+        return factory;
+    };
+
+    /// serial execution of two transactions
+    auto serial = newFactory();
+    write(serial, "a");
+    write(serial, "b");
+
+    auto parallel = newFactory();
+    auto first = newFactory();
+    write(first, "a");
+    auto second = newFactory();
+    write(second, "b");
+    BOOST_CHECK(!parallel->conflictWith(first));
+    parallel->merge(first);
+    BOOST_CHECK(!parallel->conflictWith(second));
+    parallel->merge(second);
+    BOOST_CHECK_EQUAL(parallel->hash(), serial->hash());
+
+    auto third = newFactory();
+    auto table = third->openTable(SYS_CURRENT_STATE);
+    table->select("a", table->newCondition());
+    BOOST_CHECK(parallel->conflictWith(third));
+
+    auto fourth = newFactory();
+    BOOST_CHECK(fourth->openTable(SYS_CURRENT_STATE)->empty());
+    BOOST_CHECK(parallel->conflictWith(fourth));
+}
+
+BOOST_AUTO_TEST_CASE(incremental_hash)
+{
+    auto newFactory = [this](unsigned hashVersion) {
+        auto factory = std::make_shared<dev::storage::MemoryTableFactory>();
+        factory->setStateStorage(memoryDBFactory->stateStorage());
+        factory->setHashVersion(hashVersion);
+        return factory;
+    };
+    /// hashes after every step if hashEveryStep, the final root must not depend on it
+    auto run = [](dev::storage::MemoryTableFactory::Ptr factory, bool hashEveryStep) {
+        auto step = [&]() {
+            if (hashEveryStep)
+            {
+                factory->hash();
+            }
+        };
+        auto table = factory->openTable(SYS_CURRENT_STATE);
+        for (int i = 0; i < 50; ++i)
+        {
+            auto entry = table->newEntry();
+            entry->setField(SYS_VALUE, std::to_string(i));
+            table->insert("key" + std::to_string(i), entry);
+            step();
+        }
+        auto entry = table->newEntry();
+        entry->setField(SYS_VALUE, "updated");
+        table->update("key7", entry, table->newCondition());
+        step();
+        table->remove("key8", table->newCondition());
+        step();
+        table->select("other", table->newCondition());
+        step();
+
+        auto savepoint = factory->savepoint();
+        entry = table->newEntry();
+        entry->setField(SYS_VALUE, "rollback");
+        table->update("key9", entry, table->newCondition());
+        table->insert("key100", entry);
+        step();
+        factory->rollback(savepoint);
+        step();
+
+        auto numberTable = factory->openTable(SYS_NUMBER_2_HASH);
+        entry = numberTable->newEntry();
+        entry->setField(SYS_VALUE, "hash");
+        numberTable->insert("1", entry);
+        return factory->hash();
+    };
+
+    for (unsigned hashVersion : {CONCAT_STATE_HASH, BUCKET_STATE_HASH})
+    {
+        h256 root = run(newFactory(hashVersion), false);
+        BOOST_TEST_TRUE(root != h256());
+        BOOST_TEST_TRUE(run(newFactory(hashVersion), true) == root);
+    }
+    BOOST_TEST_TRUE(
+        run(newFactory(CONCAT_STATE_HASH), false) != run(newFactory(BUCKET_STATE_HASH), false));
+}
+
+BOOST_AUTO_TEST_CASE(entry_changed_after_insert)
+{
+    /// the entries are set after being inserted or selected, hashing before that must not
+    /// change the root
+    auto run = [this](unsigned hashVersion, bool hashBeforeChange) {
+        auto factory = std::make_shared<dev::storage::MemoryTableFactory>();
+        factory->setStateStorage(memoryDBFactory->stateStorage());
+        factory->setHashVersion(hashVersion);
+        auto table = factory->openTable(SYS_CURRENT_STATE);
+        std::vector<Entry::Ptr> inserted;
+        for (int i = 0; i < 10; ++i)
+        {
+            auto entry = table->newEntry();
+            entry->setField(SYS_VALUE, std::to_string(i));
+            table->insert("key" + std::to_string(i), entry);
+            inserted.push_back(entry);
+        }
+        auto selected = table->select("key5", table->newCondition());
+        if (hashBeforeChange)
+        {
+            factory->hash();
+        }
+        inserted[2]->setField(SYS_VALUE, "changed");
+        selected->get(0)->setField(SYS_VALUE, "changed");
+        return factory->hash();
+    };
+    for (unsigned hashVersion : {CONCAT_STATE_HASH, BUCKET_STATE_HASH})
+    {
+        h256 root = run(hashVersion, false);
+        BOOST_TEST_TRUE(run(hashVersion, true) == root);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(own_writes_not_modified_outside)
+{
+    /// the writes of the table and of the rollback are counted once, when they are made
+    auto factory = std::make_shared<dev::storage::MemoryTableFactory>();
+    factory->setStateStorage(memoryDBFactory->stateStorage());
+    auto table = factory->openTable(SYS_CURRENT_STATE);
+    auto entry = table->newEntry();
+    entry->setField(SYS_VALUE, "0");
+    table->insert("key", entry);
+    auto selected = table->select("key", table->newCondition());
+    factory->hash();
+
+    size_t savepoint = factory->savepoint();
+    auto update = table->newEntry();
+    update->setField(SYS_VALUE, "1");
+    table->update("key", update, table->newCondition());
+    table->remove("key", table->newCondition());
+    factory->rollback(savepoint);
+    uint64_t modifications = factory->modifications();
+    factory->hash();
+    BOOST_TEST_TRUE(factory->modifications() == modifications);
+
+    /// set without the table
+    selected->get(0)->setField(SYS_VALUE, "changed");
+    factory->hash();
+    BOOST_TEST_TRUE(factory->modifications() == modifications + 1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_hash)
+{
+    auto threadPool = std::make_shared<dev::ThreadPool>("StateHash", 4);
+    for (unsigned hashVersion : {CONCAT_STATE_HASH, BUCKET_STATE_HASH})
+    {
+        h256 roots[2];
+        for (int parallel = 0; parallel < 2; ++parallel)
+        {
+            auto factory = std::make_shared<dev::storage::MemoryTableFactory>();
+            factory->setStateStorage(memoryDBFactory->stateStorage());
+            factory->setHashVersion(hashVersion);
+            if (parallel)
+            {
+                factory->setHashThreadPool(threadPool, 4);
+            }
+            for (int i = 0; i < 8; ++i)
+            {
+                std::string tableName = "t_test" + std::to_string(i);
+                auto table = factory->createTable(tableName, "key", "value", false);
+                for (int j = 0; j < 10; ++j)
+                {
+                    auto entry = table->newEntry();
+                    entry->setField("value", std::to_string(i * j));
+                    table->insert("key" + std::to_string(j), entry);
+                }
+            }
+            roots[parallel] = factory->hash();
+        }
+        BOOST_TEST_TRUE(roots[0] == roots[1]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(index_select)
+{
+    memoryDBFactory->setConditionVersion(BIGINT_CONDITION);
+    BOOST_TEST_TRUE(
+        memoryDBFactory->createTable("t_plain", "name", "item_id,item_name", true) != nullptr);
+    BOOST_TEST_TRUE(memoryDBFactory->createTable(
+                        "t_index", "name", "item_id,item_name", true, Address(), "item_id") !=
+                    nullptr);
+    /// only value fields can be indexed
+    BOOST_TEST_TRUE(memoryDBFactory->createTable(
+                        "t_bad", "name", "item_id", true, Address(), "item_name") == nullptr);
+
+    auto plain = memoryDBFactory->openTable("t_plain");
+    auto indexed = memoryDBFactory->openTable("t_index");
+    for (int i = 0; i < 100; ++i)
+    {
+        for (auto table : {plain, indexed})
+        {
+            auto entry = table->newEntry();
+            entry->setField("name", "fruit");
+            /// values past 32 bits, and values which aren't numbers
+            std::string id = std::to_string((i % 7) * 1000000000000LL);
+            entry->setField("item_id", i % 10 == 9 ? "id" : id);
+            entry->setField("item_name", std::to_string(i));
+            table->insert("fruit", entry);
+        }
+    }
+    auto remove = indexed->newCondition();
+    remove->EQ("item_name", "7");
+    indexed->remove("fruit", remove);
+    plain->remove("fruit", remove);
+
+    auto same = [&](std::function<void(Condition::Ptr)> set) {
+        auto condition = plain->newCondition();
+        set(condition);
+        auto scanned = plain->select("fruit", condition);
+        auto found = indexed->select("fruit", condition);
+        if (scanned->size() != found->size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < scanned->size(); ++i)
+        {
+            if (scanned->get(i)->getField("item_name") != found->get(i)->getField("item_name"))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) { c->EQ("item_id", "3000000000000"); }));
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) { c->GT("item_id", "3000000000000"); }));
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) { c->GE("item_id", "3000000000000"); }));
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) { c->LT("item_id", "3000000000000"); }));
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) {
+        c->LE("item_id", "3000000000000");
+        c->NE("item_name", "0");
+    }));
+    BOOST_TEST_TRUE(same([](Condition::Ptr c) { c->GT("item_id", "id"); }));
+
+    auto condition = indexed->newCondition();
+    condition->GT("item_id", "4294967296");
+    auto entries = indexed->select("fruit", condition);
+    BOOST_TEST_TRUE(entries->size() > 0u);
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+        BOOST_TEST_TRUE(entries->get(i)->getField("item_id") != "0");
+        BOOST_TEST_TRUE(entries->get(i)->getField("item_id") != "id");
+    }
+
+    /// the index follows updates and rollbacks
+    auto savepoint = memoryDBFactory->savepoint();
+    auto update = indexed->newEntry();
+    update->setField("item_id", "-1");
+    condition = indexed->newCondition();
+    condition->EQ("item_id", "0");
+    size_t zeros = indexed->select("fruit", condition)->size();
+    BOOST_TEST_TRUE(indexed->update("fruit", update, condition) == int(zeros));
+    BOOST_TEST_TRUE(indexed->select("fruit", condition)->size() == 0u);
+    condition = indexed->newCondition();
+    condition->LT("item_id", "0");
+    BOOST_TEST_TRUE(indexed->select("fruit", condition)->size() == zeros);
+    memoryDBFactory->rollback(savepoint);
+    BOOST_TEST_TRUE(indexed->select("fruit", condition)->size() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(select_limit)
+{
+    memoryDBFactory->setConditionVersion(BIGINT_CONDITION);
+    memoryDBFactory->createTable("t_limit", "name", "item_id", true, Address(), "item_id");
+    auto table = memoryDBFactory->openTable("t_limit");
+    for (int i = 0; i < 40; ++i)
+    {
+        auto entry = table->newEntry();
+        entry->setField("name", "fruit");
+        entry->setField("item_id", std::to_string(i));
+        table->insert("fruit", entry);
+    }
+
+    auto condition = table->newCondition();
+    condition->GE("item_id", "10");
+    condition->limit(5);
+    auto entries = table->select("fruit", condition);
+    BOOST_TEST_TRUE(entries->size() == 5u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("item_id") == "10");
+
+    condition->limit(28, 5);
+    entries = table->select("fruit", condition);
+    BOOST_TEST_TRUE(entries->size() == 2u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("item_id") == "38");
+
+    condition = table->newCondition();
+    condition->limit(3);
+    BOOST_TEST_TRUE(table->select("fruit", condition)->size() == 3u);
+
+    /// deleted entries aren't counted by the limit
+    auto remove = table->newCondition();
+    remove->LT("item_id", "2");
+    table->remove("fruit", remove);
+    entries = table->select("fruit", condition);
+    BOOST_TEST_TRUE(entries->size() == 3u);
+    BOOST_TEST_TRUE(entries->get(0)->getField("item_id") == "2");
+    BOOST_TEST_TRUE(table->select("fruit", table->newCondition())->size() == 38u);
+}
+
+BOOST_AUTO_TEST_CASE(int_condition)
+{
+    /// the default keeps the conditions of the groups created before BIGINT_CONDITION
+    memoryDBFactory->createTable("t_int", "name", "item_id", true, Address(), "item_id");
+    auto table = memoryDBFactory->openTable("t_int");
+    for (int i = 0; i < 40; ++i)
+    {
+        auto entry = table->newEntry();
+        entry->setField("name", "fruit");
+        entry->setField("item_id", std::to_string(i * 100000000LL));
+        table->insert("fruit", entry);
+    }
+    auto remove = table->newCondition();
+    remove->EQ("item_id", "0");
+    table->remove("fruit", remove);
+
+    /// values beyond int don't match a range, through the index or not
+    auto condition = table->newCondition();
+    condition->GE("item_id", "1000000000");
+    BOOST_TEST_TRUE(table->select("fruit", condition)->size() == 12u);
+    condition = table->newCondition();
+    condition->GT("item_id", "4294967296");
+    BOOST_TEST_TRUE(table->select("fruit", condition)->size() == 0u);
+
+    /// limit is ignored, deleted entries are returned without conditions
+    condition = table->newCondition();
+    condition->LT("item_id", "1000000000");
+    condition->limit(3);
+    BOOST_TEST_TRUE(table->select("fruit", condition)->size() == 9u);
+    condition = table->newCondition();
+    condition->limit(3);
+    BOOST_TEST_TRUE(table->select("fruit", condition)->size() == 40u);
+}
+
 BOOST_AUTO_TEST_CASE(open_sysTables)
 {
     auto table = memoryDBFactory->openTable(SYS_CURRENT_STATE);
@@ -65,10 +65,12 @@ struct TableFactoryPrecompiledFixture
         auto mockMemoryTableFactory = std::make_shared<MockMemoryTableFactory>();
         mockMemoryTableFactory->setStateStorage(memStorage);
         tableFactoryPrecompiled->setMemoryTableFactory(mockMemoryTableFactory);
+        memoryTableFactory = mockMemoryTableFactory;
     }
 
     ~TableFactoryPrecompiledFixture() {}
     Storage::Ptr memStorage;
+    dev::storage::MemoryTableFactory::Ptr memoryTableFactory;
     dev::blockverifier::TableFactoryPrecompiled::Ptr tableFactoryPrecompiled;
     ExecutiveContext::Ptr context;
     int addressCount = 0x10000;
@@ -126,6 +128,27 @@ BOOST_AUTO_TEST_CASE(call_afterBlock)
     memTable->insert("张三", entry);
 }
 
+BOOST_AUTO_TEST_CASE(call_createIndexedTable)
+{
+    dev::eth::ContractABI abi;
+    bytes param = abi.abiIn("createTable(string,string,string,string)", "t_index", "id",
+        "item_name, item_id", " item_id");
+    bytes out = tableFactoryPrecompiled->call(context, bytesConstRef(&param));
+    u256 code;
+    abi.abiOut(&out, code);
+    BOOST_TEST(code == u256(1));
+
+    BOOST_TEST(memoryTableFactory->openTable(USER_TABLE_PREFIX + "t_index") != nullptr);
+
+    /// only value fields can be indexed
+    param = abi.abiIn(
+        "createTable(string,string,string,string)", "t_bad", "id", "item_name", "item_id");
+    out = tableFactoryPrecompiled->call(context, bytesConstRef(&param));
+    abi.abiOut(&out, code);
+    BOOST_TEST(code == u256(0));
+    BOOST_TEST(memoryTableFactory->openTable(USER_TABLE_PREFIX + "t_bad") == nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(hash)
 {
     h256 h = tableFactoryPrecompiled->hash();
@@ -0,0 +1,191 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file test_WriteBehindStorage.cpp
+ *  @date 20190322
+ */
+
+#include "Common.h"
+#include <libdevcore/FixedHash.h>
+#include <libstorage/StorageException.h>
+#include <libstorage/WriteBehindStorage.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace test_WriteBehindStorage
+{
+/// backend which holds its commits until it is opened
+class MockBackend : public dev::storage::Storage
+{
+public:
+    virtual ~MockBackend() {}
+
+    virtual Entries::Ptr select(
+        h256 hash, int num, const std::string& table, const std::string& key) override
+    {
+        Guard l(x_data);
+        auto it = data.find(table + "_" + key);
+        if (it != data.end())
+        {
+            return it->second;
+        }
+        return std::make_shared<Entries>();
+    }
+
+    virtual size_t commit(
+        h256 hash, int64_t num, const std::vector<TableData::Ptr>& datas, h256 blockHash) override
+    {
+        while (!opened)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (failing)
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "mock commit failed"));
+        }
+        Guard l(x_data);
+        for (auto& tableData : datas)
+        {
+            for (auto& it : tableData->data)
+            {
+                data[tableData->tableName + "_" + it.first] = it.second;
+            }
+        }
+        committed.push_back(num);
+        return datas.size();
+    }
+
+    virtual bool onlyDirty() override { return false; }
+
+    std::atomic<bool> opened = {true};
+    std::atomic<bool> failing = {false};
+    std::vector<int64_t> committed;
+    std::map<std::string, Entries::Ptr> data;
+    Mutex x_data;
+};
+
+struct WriteBehindStorageFixture
+{
+    WriteBehindStorageFixture()
+    {
+        backend = std::make_shared<MockBackend>();
+        storage = std::make_shared<WriteBehindStorage>(backend, 2);
+    }
+
+    std::vector<TableData::Ptr> blockData(const std::string& key, const std::string& value)
+    {
+        Entry::Ptr entry = std::make_shared<Entry>();
+        entry->setField("key", key);
+        entry->setField("value", value);
+        Entry::Ptr deleted = std::make_shared<Entry>();
+        deleted->setField("key", key);
+        deleted->setStatus(Entry::Status::DELETED);
+        Entries::Ptr entries = std::make_shared<Entries>();
+        entries->addEntry(entry);
+        entries->addEntry(deleted);
+
+        TableData::Ptr tableData = std::make_shared<TableData>();
+        tableData->tableName = "t_test";
+        tableData->data.insert(std::make_pair(key, entries));
+        return std::vector<TableData::Ptr>{tableData};
+    }
+
+    std::shared_ptr<MockBackend> backend;
+    WriteBehindStorage::Ptr storage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(WriteBehindStorage, WriteBehindStorageFixture)
+
+BOOST_AUTO_TEST_CASE(selectPending)
+{
+    backend->opened = false;
+    h256 hash(0x01);
+    storage->commit(hash, 1, blockData("name", "v1"), hash);
+    BOOST_CHECK(storage->pendingBlocks() == 1u);
+
+    /// served from memory as the backend would decode it
+    Entries::Ptr entries = storage->select(hash, 1, "t_test", "name");
+    BOOST_CHECK(entries->size() == 1u);
+    BOOST_CHECK(entries->get(0)->getField("value") == "v1");
+    BOOST_CHECK(entries->get(0)->getField("_hash_") == hash.hex());
+    BOOST_CHECK(entries->get(0)->getField("_num_") == "1");
+    BOOST_CHECK(entries->get(0)->dirty() == false);
+    BOOST_CHECK(storage->select(hash, 1, "t_test", "other")->size() == 0u);
+
+    /// the copy doesn't alter the pending row
+    entries->get(0)->setField("value", "changed");
+    BOOST_CHECK(storage->select(hash, 1, "t_test", "name")->get(0)->getField("value") == "v1");
+
+    backend->opened = true;
+    BOOST_CHECK(storage->flush());
+    BOOST_CHECK(storage->flushedNumber() == 1);
+    BOOST_CHECK(storage->pendingBlocks() == 0u);
+    BOOST_CHECK(backend->select(hash, 1, "t_test", "name")->size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(flushInOrder)
+{
+    backend->opened = false;
+    h256 hash1(0x01);
+    h256 hash2(0x02);
+    storage->commit(hash1, 1, blockData("name", "v1"), hash1);
+    storage->commit(hash2, 2, blockData("name", "v2"), hash2);
+
+    /// the queue is full, the third commit waits for the backend
+    std::atomic<bool> committed(false);
+    std::thread thread([&]() {
+        h256 hash3(0x03);
+        storage->commit(hash3, 3, blockData("other", "v3"), hash3);
+        committed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(committed == false);
+    BOOST_CHECK(storage->select(hash2, 2, "t_test", "name")->get(0)->getField("value") == "v2");
+
+    backend->opened = true;
+    thread.join();
+    BOOST_CHECK(storage->flush());
+    BOOST_CHECK(backend->committed == std::vector<int64_t>({1, 2, 3}));
+    BOOST_CHECK(storage->flushedNumber() == 3);
+    BOOST_CHECK(storage->select(hash2, 2, "t_test", "other")->size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(backendFailed)
+{
+    backend->failing = true;
+    h256 hash(0x01);
+    storage->commit(hash, 1, blockData("name", "v1"), hash);
+    BOOST_CHECK(storage->flush() == false);
+    BOOST_CHECK(storage->flushedNumber() == -1);
+    BOOST_CHECK(storage->select(hash, 1, "t_test", "name")->size() == 1u);
+
+    /// retried until the backend recovers
+    backend->failing = false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    BOOST_CHECK(storage->flush());
+    BOOST_CHECK(storage->flushedNumber() == 1);
+
+    storage->stop();
+    BOOST_CHECK_THROW(storage->commit(hash, 2, blockData("name", "v2"), hash), StorageException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test_WriteBehindStorage
@@ -25,23 +25,43 @@
 #include "../libstorage/MemoryStorage.h"
 #include "libdevcrypto/Hash.h"
 #include "libstorage/MemoryTableFactory.h"
+#include "libstorage/Table.h"
 #include <boost/test/unit_test.hpp>
 
 using namespace dev;
 
 namespace test_StorageState
 {
+/// counts the tables opened, the accounts cached by the state are read without opening theirs
+class CountingTableFactory : public dev::storage::MemoryTableFactory
+{
+public:
+    dev::storage::Table::Ptr openTable(
+        const std::string& _table, bool _authorityFlag = true) override
+    {
+        ++opened;
+        return MemoryTableFactory::openTable(_table, _authorityFlag);
+    }
+
+    size_t opened = 0;
+};
+
 struct StorageStateFixture
 {
-    StorageStateFixture() : m_state(dev::u256(0))
+    StorageStateFixture()
+      : m_state(dev::u256(0)),
+        m_binaryState(dev::u256(0), dev::storagestate::BINARY_STORAGE_ENCODING)
     {
         auto storage = std::make_shared<dev::storage::MemoryStorage>();
-        auto tableFactory = std::make_shared<dev::storage::MemoryTableFactory>();
-        tableFactory->setStateStorage(storage);
-        m_state.setMemoryTableFactory(tableFactory);
+        m_tableFactory = std::make_shared<dev::storage::MemoryTableFactory>();
+        m_tableFactory->setStateStorage(storage);
+        m_state.setMemoryTableFactory(m_tableFactory);
+        m_binaryState.setMemoryTableFactory(m_tableFactory);
     }
 
+    dev::storage::MemoryTableFactory::Ptr m_tableFactory;
     dev::storagestate::StorageState m_state;
+    dev::storagestate::StorageState m_binaryState;
 };
 
 BOOST_FIXTURE_TEST_SUITE(StorageState, StorageStateFixture);
@@ -172,6 +192,146 @@ BOOST_AUTO_TEST_CASE(Operate)
     m_state.setRoot(h256());
 }
 
+BOOST_AUTO_TEST_CASE(BinaryEncoding)
+{
+    Address addr1(0x100001);
+    m_binaryState.addBalance(addr1, u256(10));
+    m_binaryState.setStorage(addr1, u256(123), u256(456));
+    BOOST_TEST(m_binaryState.storage(addr1, u256(123)) == u256(456));
+    BOOST_TEST(m_binaryState.balance(addr1) == u256(10));
+    bytes code = {0x60, 0x01, 0x60, 0x00, 0x55};
+    m_binaryState.setCode(addr1, bytes(code));
+    m_binaryState.clear();
+    BOOST_TEST(m_binaryState.code(addr1) == code);
+    BOOST_TEST(m_binaryState.codeHash(addr1) == sha3(code));
+
+    /// keys and values are fixed width big endian, code is raw bytes
+    auto table = m_tableFactory->openTable("_contract_data_" + addr1.hex() + "_");
+    auto entries = table->select(toBigEndianString(u256(123)), table->newCondition());
+    BOOST_TEST(entries->size() == 1u);
+    BOOST_TEST(entries->get(0)->getField("value") == toBigEndianString(u256(456)));
+    entries = table->select("code", table->newCondition());
+    BOOST_TEST(entries->get(0)->getField("value") == std::string(code.begin(), code.end()));
+    entries = table->select("balance", table->newCondition());
+    BOOST_TEST(entries->get(0)->getField("value").size() == 32u);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryEncodingReadsText)
+{
+    /// accounts written as text are read by the binary encoding
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    m_state.incNonce(addr1);
+    bytes code = {0x60, 0x01, 0x60, 0x00, 0x55};
+    m_state.setCode(addr1, bytes(code));
+    m_state.commit();
+    BOOST_TEST(m_binaryState.balance(addr1) == u256(10));
+    BOOST_TEST(m_binaryState.getNonce(addr1) == u256(1));
+    BOOST_TEST(m_binaryState.code(addr1) == code);
+    BOOST_TEST(m_binaryState.codeHash(addr1) == sha3(code));
+    BOOST_TEST(m_binaryState.addressHasCode(addr1) == true);
+
+    m_binaryState.addBalance(addr1, u256(5));
+    BOOST_TEST(m_binaryState.balance(addr1) == u256(15));
+}
+
+BOOST_AUTO_TEST_CASE(WriteBack)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    m_state.setStorage(addr1, u256(123), u256(456));
+    m_state.addBalance(addr1, u256(5));
+    auto table = m_tableFactory->openTable("_contract_data_" + addr1.hex() + "_");
+    BOOST_TEST(table->select("123", table->newCondition())->size() == 0u);
+    BOOST_TEST(table->select("balance", table->newCondition())->get(0)->getField("value") == "10");
+
+    /// the fields set are written to the tables on savepoint
+    m_state.savepoint();
+    BOOST_TEST(table->select("123", table->newCondition())->get(0)->getField("value") == "456");
+    BOOST_TEST(table->select("balance", table->newCondition())->get(0)->getField("value") == "15");
+
+    /// rows written by others are read again
+    auto entry = table->newEntry();
+    entry->setField("value", "20");
+    table->update("balance", entry, table->newCondition());
+    BOOST_TEST(m_state.balance(addr1) == u256(20));
+}
+
+BOOST_AUTO_TEST_CASE(RollbackCachedFields)
+{
+    Address addr1(0x100001);
+    m_state.addBalance(addr1, u256(10));
+    m_state.setStorage(addr1, u256(1), u256(2));
+    auto savepoint = m_state.savepoint();
+    m_state.addBalance(addr1, u256(5));
+    m_state.setStorage(addr1, u256(1), u256(3));
+    m_state.setStorage(addr1, u256(4), u256(5));
+    m_state.incNonce(addr1);
+    m_state.setCode(addr1, bytes{0x60, 0x00});
+    BOOST_TEST(m_state.codeSize(addr1) == 2u);
+    m_state.rollback(savepoint);
+    BOOST_TEST(m_state.codeSize(addr1) == 0u);
+    BOOST_TEST(m_state.balance(addr1) == u256(10));
+    BOOST_TEST(m_state.storage(addr1, u256(1)) == u256(2));
+    BOOST_TEST(m_state.storage(addr1, u256(4)) == u256());
+    BOOST_TEST(m_state.getNonce(addr1) == m_state.accountStartNonce());
+
+    /// an account created after the savepoint is gone
+    Address addr2(0x100002);
+    savepoint = m_state.savepoint();
+    m_state.addBalance(addr2, u256(1));
+    m_state.rollback(savepoint);
+    BOOST_TEST(m_state.addressInUse(addr2) == false);
+}
+
+BOOST_AUTO_TEST_CASE(WriteBackRootHash)
+{
+    /// the root doesn't depend on when the fields are written back
+    auto run = [](bool savepoints) {
+        auto tableFactory = std::make_shared<dev::storage::MemoryTableFactory>();
+        tableFactory->setStateStorage(std::make_shared<dev::storage::MemoryStorage>());
+        dev::storagestate::StorageState state(dev::u256(0));
+        state.setMemoryTableFactory(tableFactory);
+        Address addr1(0x100001);
+        Address addr2(0x100002);
+        state.addBalance(addr1, u256(100));
+        for (int i = 0; i < 10; ++i)
+        {
+            state.setStorage(addr1, u256(i % 3), u256(i));
+            state.transferBalance(addr1, addr2, u256(1));
+            state.incNonce(addr1);
+            if (savepoints)
+            {
+                state.savepoint();
+            }
+        }
+        state.setCode(addr2, bytes{0x60, 0x00});
+        return state.rootHash();
+    };
+    BOOST_TEST(run(true) == run(false));
+}
+
+BOOST_AUTO_TEST_CASE(CachedAfterRootHash)
+{
+    auto tableFactory = std::make_shared<CountingTableFactory>();
+    tableFactory->setStateStorage(std::make_shared<dev::storage::MemoryStorage>());
+    dev::storagestate::StorageState state(dev::u256(0));
+    state.setMemoryTableFactory(tableFactory);
+    Address addr1(0x100001);
+    state.addBalance(addr1, u256(100));
+    state.setStorage(addr1, u256(1), u256(1));
+    state.rootHash();
+    /// the rows written back are updated this time
+    state.addBalance(addr1, u256(1));
+    state.setStorage(addr1, u256(1), u256(2));
+    state.rootHash();
+
+    size_t opened = tableFactory->opened;
+    BOOST_TEST(state.balance(addr1) == u256(101));
+    BOOST_TEST(state.storage(addr1, u256(1)) == u256(2));
+    BOOST_TEST(tableFactory->opened == opened);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test_StorageState
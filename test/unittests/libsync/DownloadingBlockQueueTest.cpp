@@ -27,6 +27,7 @@
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <memory>
+#include <thread>
 
 using namespace std;
 using namespace dev;
@@ -116,6 +117,59 @@ BOOST_AUTO_TEST_CASE(AllTest)
         fakeQueue.size() == c_maxDownloadingBlockQueueSize + c_maxDownloadingBlockQueueBufferSize);
 }
 
+BOOST_AUTO_TEST_CASE(PrepareTest)
+{
+    DownloadingBlockQueue fakeQueue;
+    fakeQueue.setPrepareThreadNum(2);
+    auto pushFunc = [&fakeQueue](int start, int end) {
+        vector<shared_ptr<Block>> blocks;
+        for (auto i = start; i < end; ++i)
+        {
+            FakeBlock fakeBlock;
+            fakeBlock.getBlock().header().setNumber(static_cast<int64_t>(i));
+            blocks.emplace_back(make_shared<Block>(fakeBlock.getBlock()));
+        }
+        fakeQueue.push(blocks);
+    };
+    auto waitPrepared = [&fakeQueue]() {
+        while (fakeQueue.preparingShards() > 0)
+            this_thread::sleep_for(chrono::milliseconds(1));
+    };
+
+    // shards are decoded by the prepare workers, the queue stays ordered by number
+    for (int i = 3; i >= 0; --i)
+        pushFunc(i * 4, i * 4 + 4);
+    fakeQueue.flushBufferToQueue();
+    waitPrepared();
+    BOOST_CHECK(fakeQueue.size() == 16);
+    for (int64_t i = 0; i < 16; ++i)
+    {
+        BlockPtr block = fakeQueue.top();
+        BOOST_REQUIRE(block != nullptr);
+        BOOST_CHECK(block->header().number() == i);
+        BOOST_CHECK(block->transactions().size() == 0 ||
+                    block->transactions()[0].safeSender() != Address());
+        fakeQueue.pop();
+    }
+    BOOST_CHECK(fakeQueue.empty());
+
+    // no more shards than c_maxPreparingShards are taken from buffer at once
+    for (size_t i = 0; i < c_maxDownloadingBlockQueueBufferSize; i++)
+        pushFunc(i, i + 1);
+    fakeQueue.flushBufferToQueue();
+    waitPrepared();
+    BOOST_CHECK(fakeQueue.size() == c_maxDownloadingBlockQueueBufferSize);
+    fakeQueue.flushBufferToQueue();
+    waitPrepared();
+    BOOST_CHECK(fakeQueue.top()->header().number() == 0);
+
+    // Clear
+    fakeQueue.clear();
+    waitPrepared();
+    BOOST_CHECK(fakeQueue.top() == nullptr);
+    BOOST_CHECK(fakeQueue.size() == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
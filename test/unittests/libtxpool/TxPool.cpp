@@ -25,6 +25,7 @@
 #include <libdevcrypto/Common.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
+#include <thread>
 using namespace dev;
 using namespace dev::txpool;
 using namespace dev::blockchain;
@@ -120,6 +121,11 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
     m_status = pool_test.m_txPool->status();
     BOOST_CHECK(m_status.current == 4);
     BOOST_CHECK(m_status.dropped == 1);
+    /// test transactionInPool
+    BOOST_CHECK(pool_test.m_txPool->transactionInPool(pending_list[0].sha3()) == nullptr);
+    auto pooled = pool_test.m_txPool->transactionInPool(pending_list[1].sha3());
+    BOOST_REQUIRE(pooled);
+    BOOST_CHECK(pooled->sha3() == pending_list[1].sha3());
 
     /// test topTransactions
     Transactions top_transactions = pool_test.m_txPool->topTransactions(20);
@@ -135,6 +141,94 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
     pool_test.m_txPool->setMaxBlockLimit(100);
     BOOST_CHECK(pool_test.m_txPool->maxBlockLimit() == 100);
 }
+
+BOOST_AUTO_TEST_CASE(testConcurrentImportAndDrop)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transaction tx = pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+                         ->transactions()[0];
+    size_t txNum = 64;
+    Transactions txs;
+    std::vector<bytes> txsData;
+    for (size_t i = 0; i < txNum; i++)
+    {
+        tx.setNonce(tx.nonce() + u256(i) + u256(100));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        Signature sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        txs.push_back(tx);
+        bytes txData;
+        tx.encode(txData);
+        txsData.push_back(txData);
+    }
+    /// every thread imports all the transactions, each of them must be accepted exactly once
+    std::atomic<size_t> successCount(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++)
+    {
+        threads.push_back(std::thread([&]() {
+            for (auto const& txData : txsData)
+            {
+                if (pool_test.m_txPool->import(ref(txData)) == ImportResult::Success)
+                    successCount++;
+            }
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+    BOOST_CHECK_EQUAL(successCount, txNum);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->pendingSize(), txNum);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->topTransactions(txNum).size(), txNum);
+
+    /// drop the transactions of a block in one batch
+    Block block;
+    block.setTransactions(txs);
+    BOOST_CHECK(pool_test.m_txPool->dropBlockTrans(block));
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->pendingSize(), 0);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->pendingList().size(), 0);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->status().current, 0);
+}
+BOOST_AUTO_TEST_CASE(testBatchImport)
+{
+    TxPoolFixture pool_test(5, 5);
+    pool_test.m_txPool->setVerifyThreadNum(2);
+    pool_test.m_txPool->setTxPoolLimit(6);
+    Transaction tx = pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+                         ->transactions()[0];
+    Transactions txs;
+    for (size_t i = 0; i < 8; i++)
+    {
+        tx.setNonce(tx.nonce() + u256(i) + u256(100));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        Signature sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        bytes txData;
+        tx.encode(txData);
+        /// decode without recovering the sender, as the sync module does
+        txs.push_back(Transaction(ref(txData), CheckTransaction::Cheap));
+    }
+    Transactions batch(txs.begin(), txs.begin() + 4);
+    auto results = pool_test.m_txPool->batchImport(batch);
+    BOOST_CHECK_EQUAL(results.size(), 4);
+    for (auto result : results)
+        BOOST_CHECK(result == ImportResult::Success);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->pendingSize(), 4);
+
+    /// known transactions are refused before verification, only two more fit into the pool
+    results = pool_test.m_txPool->batchImport(txs);
+    BOOST_CHECK_EQUAL(results.size(), 8);
+    for (size_t i = 0; i < 4; i++)
+        BOOST_CHECK(results[i] == ImportResult::AlreadyKnown);
+    BOOST_CHECK(results[4] == ImportResult::Success);
+    BOOST_CHECK(results[5] == ImportResult::Success);
+    BOOST_CHECK(results[6] == ImportResult::TransactionPoolIsFull);
+    BOOST_CHECK(results[7] == ImportResult::TransactionPoolIsFull);
+    BOOST_CHECK_EQUAL(pool_test.m_txPool->pendingSize(), 6);
+
+    TxPoolStatus status = pool_test.m_txPool->status();
+    BOOST_CHECK_EQUAL(status.verifying, 0);
+    BOOST_CHECK_EQUAL(status.verified, 6);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -500,11 +500,20 @@ generate_config_ini()
     channel_listen_port=$(( port_start + 1 + index * 3 ))
     ;jsonrpc listen port
     jsonrpc_listen_port=$(( port_start + 2 + index * 3 ))
+    ;prometheus metrics listen ip and port, 0 disables it
+    metrics_listen_ip=127.0.0.1
+    metrics_listen_port=0
+    ;threads handling the requests of a JSON-RPC batch, 0 handles them one by one
+    batch_thread_num=4
 [p2p]
     ;p2p listen ip
     listen_ip=0.0.0.0
     ;p2p listen port
     listen_port=$(( port_start + index * 3 ))
+    ;compress the payloads sent to the peers supporting it
+    enable_compression=true
+    ;payloads shorter than that (bytes) aren't compressed
+    compression_threshold=1024
     ;nodes to connect
     $ip_list
 ;certificate rejected list		
@@ -566,6 +575,9 @@ generate_group_genesis()
     maxTransNum=1000
     ;the ttl of broadcasted pbft message
     ;maxTTL=2
+    ;broadcast the transaction hashes of the proposed blocks, the nodes take the transactions
+    ;from their txpool, all the nodes of the group must support it
+    compactPrepare=true
     ;the node id of leaders
     ${node_list}
 
@@ -575,6 +587,12 @@ generate_group_genesis()
 [state]
     ;support mpt/storage
     type=${state_type}
+    ;state root of storage state, 1: hash of all modified tables, 2: incremental by key buckets
+    hashVersion=2
+    ;values of storage state, 1: decimal and hex text, 2: binary
+    encoding=2
+    ;table conditions, 1: int ranges and no limit, 2: integer ranges of any size and limit
+    conditionVersion=2
 
 ;tx gas limit
 [tx]
@@ -589,10 +607,38 @@ function generate_group_ini()
 ;sync period time
 [sync]
     idleWaitMs=200
+    ;threads decoding downloaded blocks ahead of execution
+    prepareThreadNum=2
 
 ;txpool limit
 [txPool]
     limit=1000
+    ;threads verifying signatures of transactions received from peers
+    verifyThreadNum=2
+
+;execute transactions of a block in parallel, only for storage state
+[txExecute]
+    enableParallel=false
+    threadNum=4
+    ;threads hashing modified tables for the state root
+    hashThreadNum=4
+    ;threads executing calls, and calls waiting for them beyond which calls are rejected
+    callThreadNum=4
+    callQueueLimit=1000
+    ;calls fail at the first change of the contract state instead of rolling it back,
+    ;calls of functions which aren't view functions fail
+    callReadOnly=false
+
+;blocks reaching consensus committed in background while the next one is executed,
+;0 commits synchronously, only for storage state
+[consensus]
+    pipelineDepth=0
+
+;blocks committed in memory and written to disk in background, 0 writes synchronously
+[storage]
+    maxPendingBlocks=4
+    ;MB of table rows cached across blocks, 0 disables the cache
+    cacheSize=32
 EOF
 }
 